@@ -1,5 +1,7 @@
 #include "benchmark/benchmark.h"
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 
 #ifdef HAVE_CONFIG_H
@@ -11,6 +13,9 @@
 #ifdef HAVE_FREETYPE
 #include "hb-ft.h"
 #endif
+#ifdef HAVE_CAIRO
+#include "hb-cairo.h"
+#endif
 
 
 #define SUBSET_FONT_BASE_PATH "test/subset/data/fonts/"
@@ -29,6 +34,8 @@ struct test_input_t
   {false, SUBSET_FONT_BASE_PATH "Comfortaa-Regular-new.ttf"},
   {false, SUBSET_FONT_BASE_PATH "NotoNastaliqUrdu-Regular.ttf"},
   {false, SUBSET_FONT_BASE_PATH "NotoSerifMyanmar-Regular.otf"},
+  {false, "test/api/fonts/test_glyphs-glyf_colr_1.ttf"},
+  {true , "test/api/fonts/varc-6868.ttf"},
 };
 
 static test_input_t *tests = default_tests;
@@ -41,9 +48,16 @@ enum operation_t
   nominal_glyphs,
   glyph_h_advances,
   glyph_extents,
+  glyph_extents_animated,
   draw_glyph,
+  draw_glyph_animated,
   paint_glyph,
+  glyph_sdf,
+  glyph_a8,
+  glyph_a8_cairo,
   load_face_and_shape,
+  load_face_and_shape_sanitize_cache,
+  face_warm_up_shaping,
 };
 
 static void
@@ -181,6 +195,36 @@ static void BM_Font (benchmark::State &state,
 	  font_get_glyph_extents (font, gid, &extents);
       break;
     }
+    case glyph_extents_animated:
+    {
+      /* Step the weight axis every round, as when animating it, so that
+       * nothing computed for the previous instance can be reused. */
+      glyph_extents_t extents;
+      unsigned step = 0;
+      for (auto _ : state)
+      {
+	variation_t wght = {HB_TAG ('w','g','h','t'), (float) (300 + step++ % 500)};
+	font_set_variations (font, &wght, 1);
+	for (unsigned gid = 0; gid < num_glyphs; ++gid)
+	  font_get_glyph_extents (font, gid, &extents);
+      }
+      break;
+    }
+    case draw_glyph_animated:
+    {
+      draw_funcs_t *draw_funcs = _draw_funcs_create ();
+      unsigned step = 0;
+      for (auto _ : state)
+      {
+	variation_t wght = {HB_TAG ('w','g','h','t'), (float) (300 + step++ % 500)};
+	font_set_variations (font, &wght, 1);
+	float i = 0;
+	for (unsigned gid = 0; gid < num_glyphs; ++gid)
+	  font_draw_glyph (font, gid, draw_funcs, &i);
+      }
+      draw_funcs_destroy (draw_funcs);
+      break;
+    }
     case draw_glyph:
     {
       draw_funcs_t *draw_funcs = _draw_funcs_create ();
@@ -204,14 +248,139 @@ static void BM_Font (benchmark::State &state,
       paint_funcs_destroy (paint_funcs);
       break;
     }
+    case glyph_sdf:
+    {
+      /* 32 pixels per em with a 4 pixel spread, as for a GPU text atlas,
+       * rendered in batches of 256 cells on state.range (0) threads. */
+      const unsigned size = 48;
+      const float spread = 4.f;
+      const unsigned batch = 256;
+      unsigned max_threads = state.range (0);
+      uint8_t *atlas = (uint8_t *) malloc (batch * size * size);
+      uint8_t *bitmaps[batch];
+      for (unsigned i = 0; i < batch; i++)
+	bitmaps[i] = atlas + i * size * size;
+      font_set_scale (font, 32, 32);
+
+      codepoint_t *glyphs = (codepoint_t *) malloc (num_glyphs * sizeof (codepoint_t));
+      float *x_origins = (float *) malloc (num_glyphs * sizeof (float));
+      float *y_origins = (float *) malloc (num_glyphs * sizeof (float));
+      for (unsigned gid = 0; gid < num_glyphs; ++gid)
+      {
+	glyph_extents_t extents = {0};
+	font_get_glyph_extents (font, gid, &extents);
+	glyphs[gid] = gid;
+	x_origins[gid] = extents.x_bearing - spread;
+	y_origins[gid] = extents.y_bearing + spread;
+      }
+
+      for (auto _ : state)
+      {
+	for (unsigned start = 0; start < num_glyphs; start += batch)
+	  font_get_glyphs_sdf (font, std::min (batch, num_glyphs - start),
+			       glyphs + start, x_origins + start, y_origins + start,
+			       spread, size, size, size, bitmaps, max_threads);
+      }
+      state.SetItemsProcessed (state.iterations () * num_glyphs);
+      free (glyphs);
+      free (x_origins);
+      free (y_origins);
+      free (atlas);
+      break;
+    }
+    case glyph_a8:
+    {
+      /* 32 pixels per em, as for text thumbnails. */
+      const unsigned size = 48;
+      uint8_t *bitmap = (uint8_t *) malloc (size * size);
+      font_set_scale (font, 32, 32);
+      for (auto _ : state)
+      {
+	for (unsigned gid = 0; gid < num_glyphs; ++gid)
+	{
+	  glyph_extents_t extents = {0};
+	  font_get_glyph_extents (font, gid, &extents);
+	  unsigned width = std::min ((unsigned) abs (extents.width) + 2, size);
+	  unsigned height = std::min ((unsigned) abs (extents.height) + 2, size);
+	  font_get_glyph_a8 (font, gid,
+			     extents.x_bearing - 1, extents.y_bearing + 1,
+			     width, height, size, bitmap);
+	}
+      }
+      state.SetItemsProcessed (state.iterations () * num_glyphs);
+      free (bitmap);
+      break;
+    }
+    case glyph_a8_cairo:
+    {
+#ifdef HAVE_CAIRO
+      /* The same job through Cairo, set up the way hb-view does it.  Glyphs
+       * are filled as paths, since showing them would hit Cairo's glyph
+       * image cache after the first round. */
+      const unsigned size = 48;
+      font_set_scale (font, 32, 32);
+      cairo_surface_t *surface = cairo_image_surface_create (CAIRO_FORMAT_A8, size, size);
+      cairo_t *cr = cairo_create (surface);
+      cairo_font_face_t *cairo_face = hb_cairo_font_face_create_for_font (font);
+      hb_cairo_font_face_set_scale_factor (cairo_face, 1);
+      cairo_set_font_face (cr, cairo_face);
+      cairo_set_font_size (cr, 32);
+      for (auto _ : state)
+      {
+	for (unsigned gid = 0; gid < num_glyphs; ++gid)
+	{
+	  glyph_extents_t extents = {0};
+	  font_get_glyph_extents (font, gid, &extents);
+	  cairo_glyph_t glyph = {gid,
+				 (double) (1 - extents.x_bearing),
+				 (double) (1 + extents.y_bearing)};
+	  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+	  cairo_paint (cr);
+	  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+	  cairo_new_path (cr);
+	  cairo_glyph_path (cr, &glyph, 1);
+	  cairo_fill (cr);
+	}
+	cairo_surface_flush (surface);
+      }
+      state.SetItemsProcessed (state.iterations () * num_glyphs);
+      cairo_font_face_destroy (cairo_face);
+      cairo_destroy (cr);
+      cairo_surface_destroy (surface);
+#endif
+      break;
+    }
     case load_face_and_shape:
+    case load_face_and_shape_sanitize_cache:
     {
+      /* Verdicts of a face that has shaped once, as a caller would have
+       * saved them from an earlier run. */
+      blob_t *cache = nullptr;
+      if (op == load_face_and_shape_sanitize_cache)
+      {
+	blob_t *blob = face_reference_blob (font_get_face (font));
+	face_t *warm = face_create (blob, 0);
+	blob_destroy (blob);
+	face_set_sanitize_cache (warm, nullptr);
+	font_t *warm_font = font_create (warm);
+	buffer_t *buffer = buffer_create ();
+	buffer_add_utf8 (buffer, " ", -1, 0, -1);
+	buffer_guess_segment_properties (buffer);
+	shape (warm_font, buffer, nullptr, 0);
+	buffer_destroy (buffer);
+	font_destroy (warm_font);
+	cache = face_reference_sanitize_cache (warm);
+	face_destroy (warm);
+      }
+
       for (auto _ : state)
       {
 	blob_t *blob = blob_create_from_file_or_fail (test_input.font_path);
 	assert (blob);
 	face_t *face = face_create (blob, 0);
 	blob_destroy (blob);
+	if (cache)
+	  face_set_sanitize_cache (face, cache);
 	font_t *font = font_create (face);
 	face_destroy (face);
 
@@ -237,6 +406,20 @@ static void BM_Font (benchmark::State &state,
 	buffer_destroy (buffer);
 	font_destroy (font);
       }
+
+      blob_destroy (cache);
+      break;
+    }
+    case face_warm_up_shaping:
+    {
+      blob_t *blob = face_reference_blob (font_get_face (font));
+      for (auto _ : state)
+      {
+	face_t *face = face_create (blob, 0);
+	face_warm_up (face, HB_FACE_WARM_UP_FLAG_SHAPING, 4);
+	face_destroy (face);
+      }
+      blob_destroy (blob);
       break;
     }
   }
@@ -262,8 +445,12 @@ static void test_backend (backend_t backend,
   strcat (name, "/");
   strcat (name, backend_name);
 
-  benchmark::RegisterBenchmark (name, BM_Font, variable, backend, op, test_input)
-   ->Unit(time_unit);
+  auto *bm = benchmark::RegisterBenchmark (name, BM_Font, variable, backend, op, test_input)
+	     ->Unit(time_unit);
+
+  /* Glyphs are independent; show how throughput scales across threads. */
+  if (op == glyph_sdf)
+    bm->Arg (1)->Arg (2)->Arg (4)->UseRealTime ();
 }
 
 static void test_operation (operation_t op,
@@ -277,6 +464,9 @@ static void test_operation (operation_t op,
     {
       bool is_var = (bool) variable;
 
+      if (!is_var && (op == glyph_extents_animated || op == draw_glyph_animated))
+	continue;
+
       test_backend (HARFBUZZ, "hb", is_var, op, op_name, time_unit, test_input);
 #ifdef HAVE_FREETYPE
       test_backend (FREETYPE, "ft", is_var, op, op_name, time_unit, test_input);
@@ -305,9 +495,18 @@ int main(int argc, char** argv)
   TEST_OPERATION (nominal_glyphs, benchmark::kMicrosecond);
   TEST_OPERATION (glyph_h_advances, benchmark::kMicrosecond);
   TEST_OPERATION (glyph_extents, benchmark::kMicrosecond);
+  TEST_OPERATION (glyph_extents_animated, benchmark::kMicrosecond);
   TEST_OPERATION (draw_glyph, benchmark::kMicrosecond);
+  TEST_OPERATION (draw_glyph_animated, benchmark::kMicrosecond);
   TEST_OPERATION (paint_glyph, benchmark::kMillisecond);
+  TEST_OPERATION (glyph_sdf, benchmark::kMillisecond);
+  TEST_OPERATION (glyph_a8, benchmark::kMillisecond);
+#ifdef HAVE_CAIRO
+  TEST_OPERATION (glyph_a8_cairo, benchmark::kMillisecond);
+#endif
   TEST_OPERATION (load_face_and_shape, benchmark::kMicrosecond);
+  TEST_OPERATION (load_face_and_shape_sanitize_cache, benchmark::kMicrosecond);
+  TEST_OPERATION (face_warm_up_shaping, benchmark::kMicrosecond);
 
 #undef TEST_OPERATION
 
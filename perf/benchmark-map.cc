@@ -1,5 +1,8 @@
 /*
  * Benchmarks for hb_map_t operations.
+ *
+ * To compare the default map with the Swiss-table one, run these against
+ * a build configured with CPPFLAGS=-DHB_MAP_SWISS_TABLE too.
  */
 #include "benchmark/benchmark.h"
 
@@ -55,6 +58,23 @@ static void BM_MapInsert(benchmark::State& state) {
 BENCHMARK(BM_MapInsert)
     ->Range(1 << 4, 1 << 20);
 
+/* Build a map of varying size from new keys, growing it as it goes. */
+static void BM_MapInsertNew(benchmark::State& state) {
+  unsigned map_size = state.range(0);
+
+  hb_map_t* map = hb_map_create ();
+  for (auto _ : state) {
+    hb_map_clear (map);
+    for (unsigned i = 0; i < map_size; i++)
+      hb_map_set (map, i * 2654435761u, i);
+  }
+
+  hb_map_destroy(map);
+}
+BENCHMARK(BM_MapInsertNew)
+    ->Unit(benchmark::kMicrosecond)
+    ->Range(1 << 10, 1 << 20); // Map size
+
 /* Single value lookup on map of various sizes where the key is not present. */
 static void BM_MapLookupMiss(benchmark::State& state) {
   unsigned map_size = state.range(0);
@@ -22,8 +22,6 @@ void RandomSet(unsigned size, unsigned max_value, hb_set_t* out) {
   }
 }
 
-// TODO(garretrieger): benchmark union/subtract/intersection etc.
-
 /* Insert a 1000 values into set of varying sizes. */
 static void BM_SetInsert_1000(benchmark::State& state) {
   unsigned set_size = state.range(0);
@@ -104,6 +102,35 @@ BENCHMARK_CAPTURE(BM_SetLookup, random, 12345)
         {{1 << 10, 1 << 16}, // Set Size
          {2, 512}});          // Density
 
+/* Random lookups on sets within the first 64k values, which use the direct
+ * page index; "far" adds one value past it, forcing the binary search. */
+static void BM_SetRandomLookup(benchmark::State& state, bool far) {
+  unsigned set_size = state.range(0);
+  unsigned max_value = 65536;
+
+  hb_set_t* original = hb_set_create ();
+  RandomSet(set_size, max_value, original);
+  if (far)
+    hb_set_add (original, 0x10FFFFu);
+
+  hb_codepoint_t needles[1024];
+  srand(set_size);
+  for (unsigned i = 0; i < 1024; i++)
+    needles[i] = rand() % max_value;
+
+  unsigned i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        hb_set_has (original, needles[i++ & 1023]));
+  }
+
+  hb_set_destroy(original);
+}
+BENCHMARK_CAPTURE(BM_SetRandomLookup, direct, false)
+    ->Range(1 << 6, 1 << 14); // Set Size
+BENCHMARK_CAPTURE(BM_SetRandomLookup, far, true)
+    ->Range(1 << 6, 1 << 14); // Set Size
+
 /* Full iteration of sets of varying sizes. */
 static void BM_SetIteration(benchmark::State& state) {
   unsigned set_size = state.range(0);
@@ -125,6 +152,93 @@ BENCHMARK(BM_SetIteration)
         {{1 << 10, 1 << 16}, // Set Size
          {2, 512}});          // Density
 
+/* Set algebra between two random sets of the same size and density. */
+static void BM_SetAlgebra(benchmark::State& state,
+                          void (*op) (hb_set_t *, const hb_set_t *)) {
+  unsigned set_size = state.range(0);
+  unsigned max_value = state.range(0) * state.range(1);
+
+  hb_set_t* a = hb_set_create ();
+  RandomSet(set_size, max_value, a);
+  hb_set_t* b = hb_set_create ();
+  RandomSet(set_size, max_value + 1, b);
+
+  hb_set_t* s = hb_set_create ();
+  for (auto _ : state) {
+    hb_set_set (s, a);
+    op (s, b);
+  }
+
+  hb_set_destroy(a);
+  hb_set_destroy(b);
+  hb_set_destroy(s);
+}
+BENCHMARK_CAPTURE(BM_SetAlgebra, union, hb_set_union)
+    ->Unit(benchmark::kMicrosecond)
+    ->Ranges(
+        {{1 << 10, 1 << 16}, // Set Size
+         {2, 512}});          // Density
+BENCHMARK_CAPTURE(BM_SetAlgebra, intersect, hb_set_intersect)
+    ->Unit(benchmark::kMicrosecond)
+    ->Ranges(
+        {{1 << 10, 1 << 16}, // Set Size
+         {2, 512}});          // Density
+BENCHMARK_CAPTURE(BM_SetAlgebra, subtract, hb_set_subtract)
+    ->Unit(benchmark::kMicrosecond)
+    ->Ranges(
+        {{1 << 10, 1 << 16}, // Set Size
+         {2, 512}});          // Density
+
+/* Population of a set whose cached page populations were invalidated. */
+static void BM_SetPopulation(benchmark::State& state) {
+  unsigned set_size = state.range(0);
+  unsigned max_value = state.range(0) * state.range(1);
+
+  hb_set_t* original = hb_set_create ();
+  RandomSet(set_size, max_value, original);
+
+  hb_set_t* s = hb_set_create ();
+  for (auto _ : state) {
+    state.PauseTiming ();
+    hb_set_set (s, original);
+    hb_set_union (s, original);
+    state.ResumeTiming ();
+    benchmark::DoNotOptimize(hb_set_get_population (s));
+  }
+
+  hb_set_destroy(original);
+  hb_set_destroy(s);
+}
+BENCHMARK(BM_SetPopulation)
+    ->Ranges(
+        {{1 << 10, 1 << 16}, // Set Size
+         {2, 512}});          // Density
+
+/* Bulk iteration of sets of varying sizes. */
+static void BM_SetNextMany(benchmark::State& state) {
+  unsigned set_size = state.range(0);
+  unsigned max_value = state.range(0) * state.range(1);
+
+  hb_set_t* original = hb_set_create ();
+  RandomSet(set_size, max_value, original);
+
+  hb_codepoint_t out[256];
+  for (auto _ : state) {
+    hb_codepoint_t cp = HB_SET_VALUE_INVALID;
+    unsigned n;
+    while ((n = hb_set_next_many (original, cp, out, 256)))
+      cp = out[n - 1];
+    benchmark::DoNotOptimize(cp);
+  }
+
+  hb_set_destroy(original);
+}
+BENCHMARK(BM_SetNextMany)
+    ->Unit(benchmark::kMicrosecond)
+    ->Ranges(
+        {{1 << 10, 1 << 16}, // Set Size
+         {2, 512}});          // Density
+
 /* Set copy. */
 static void BM_SetCopy(benchmark::State& state) {
   unsigned set_size = state.range(0);
@@ -12,6 +12,7 @@
 enum operation_t
 {
   subset_glyphs,
+  subset_glyphs_unprocessed,
   subset_unicodes,
   instance,
 };
@@ -146,7 +147,16 @@ static void BM_subset (benchmark::State &state,
 
   static const char *cached_font_path;
 
-  if (!cached_font_path || strcmp (cached_font_path, test_input.font_path))
+  if (operation == subset_glyphs_unprocessed)
+  {
+    /* Without hb_subset_preprocess() every iteration has to parse the
+     * CFF charstrings from scratch. */
+    hb_blob_t *blob = hb_blob_create_from_file_or_fail (test_input.font_path);
+    assert (blob);
+    face = hb_face_create (blob, 0);
+    hb_blob_destroy (blob);
+  }
+  else if (!cached_font_path || strcmp (cached_font_path, test_input.font_path))
   {
     hb_blob_t *blob = hb_blob_create_from_file_or_fail (test_input.font_path);
     assert (blob);
@@ -182,6 +192,7 @@ static void BM_subset (benchmark::State &state,
     break;
 
     case subset_glyphs:
+    case subset_glyphs_unprocessed:
     {
       unsigned num_glyphs = hb_face_get_glyph_count (face);
       AddGlyphs(num_glyphs, subset_size, input);
@@ -224,6 +235,9 @@ static void test_subset (operation_t op,
 {
   if (op == instance && test_input.instance_opts == nullptr)
     return;
+  if (op == subset_glyphs_unprocessed &&
+      !strstr (test_input.font_path, ".otf"))
+    return;
 
   char name[1024] = "BM_subset/";
   strcat (name, op_name);
@@ -274,6 +288,7 @@ int main(int argc, char** argv)
 #define TEST_OPERATION(op, time_unit) test_operation (op, #op, tests, num_tests, time_unit)
 
   TEST_OPERATION (subset_glyphs, benchmark::kMicrosecond);
+  TEST_OPERATION (subset_glyphs_unprocessed, benchmark::kMicrosecond);
   TEST_OPERATION (subset_unicodes, benchmark::kMicrosecond);
   TEST_OPERATION (instance, benchmark::kMicrosecond);
 
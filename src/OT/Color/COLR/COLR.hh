@@ -33,6 +33,7 @@
 #include "../../../hb-ot-var-common.hh"
 #include "../../../hb-paint.hh"
 #include "../../../hb-paint-extents.hh"
+#include "../../../hb-paint-program.hh"
 
 /*
  * COLR -- Color
@@ -73,6 +74,7 @@ public:
   map_t current_layers;
   int depth_left = HB_MAX_NESTING_LEVEL;
   int edge_count = HB_MAX_GRAPH_EDGE_COUNT;
+  paint_program_t *program = nullptr; /* Set while recording into a program. */
 
   paint_context_t (const void *base_,
 		      paint_funcs_t *funcs_,
@@ -93,6 +95,7 @@ public:
   color_t get_color (unsigned int color_index, float alpha, bool_t *is_foreground)
   {
     color_t color = foreground;
+    bool has_color = false;
 
     *is_foreground = true;
 
@@ -104,11 +107,15 @@ public:
 	face_t *face = font_get_face (font);
 
 	ot_color_palette_get_colors (face, palette_index, color_index, &clen, &color);
+	has_color = clen;
       }
 
       *is_foreground = false;
     }
 
+    if (unlikely (program))
+      program->note_color (color_index, alpha, has_color, color);
+
     return HB_COLOR (color_get_blue (color),
                      color_get_green (color),
                      color_get_red (color),
@@ -2497,7 +2504,8 @@ struct COLR
 
 #ifndef HB_NO_PAINT
   bool
-  get_extents (font_t *font, codepoint_t glyph, glyph_extents_t *extents) const
+  get_extents (font_t *font, codepoint_t glyph, glyph_extents_t *extents,
+	       paint_program_cache_t *cache = nullptr) const
   {
     if (version != 1)
       return false;
@@ -2512,9 +2520,22 @@ struct COLR
       return true;
     }
 
-    auto *extents_funcs = paint_extents_get_funcs ();
     paint_extents_context_t extents_data;
-    bool ret = paint_glyph (font, glyph, extents_funcs, &extents_data, 0, HB_COLOR(0,0,0,0));
+    bool ret;
+    paint_program_cache_t::ref_t program;
+    if (cache &&
+	get_paint_program (font, glyph, paint_program_cache_t::ANY_PALETTE, cache, program) &&
+	program && likely (!program->in_error ()))
+    {
+      /* Walk the recorded program instead of painting. */
+      program->get_extents (font, &extents_data);
+      ret = true;
+    }
+    else
+    {
+      auto *extents_funcs = paint_extents_get_funcs ();
+      ret = paint_glyph (font, glyph, extents_funcs, &extents_data, 0, HB_COLOR(0,0,0,0));
+    }
 
     extents_t e = extents_data.get_extents ();
     if (e.is_void ())
@@ -2562,12 +2583,14 @@ struct COLR
 
 #ifndef HB_NO_PAINT
   bool
-  paint_glyph (font_t *font, codepoint_t glyph, paint_funcs_t *funcs, void *data, unsigned int palette_index, color_t foreground, bool clip = true) const
+  paint_glyph (font_t *font, codepoint_t glyph, paint_funcs_t *funcs, void *data, unsigned int palette_index, color_t foreground, bool clip = true,
+	       paint_program_t *program = nullptr) const
   {
     ItemVarStoreInstancer instancer (&(this+varStore),
 	                         &(this+varIdxMap),
 	                         array (font->coords, font->num_coords));
     paint_context_t c (this, funcs, data, font, palette_index, foreground, instancer);
+    c.program = program;
     c.current_glyphs.add (glyph);
 
     if (version == 1)
@@ -2646,6 +2669,56 @@ struct COLR
 
     return false;
   }
+
+  /* Fetches the paint program of @glyph from @cache, recording it first
+   * if needed.  Returns false if the glyph has no COLR paint.  Otherwise
+   * the glyph must be painted directly if @program is empty or in
+   * error. */
+  bool
+  get_paint_program (font_t *font, codepoint_t glyph, unsigned int palette_index,
+		     paint_program_cache_t *cache,
+		     paint_program_cache_t::ref_t &program /* OUT */) const
+  {
+    program = cache->get (glyph, palette_index, font->serial);
+    if (program)
+      return true;
+
+    if (palette_index == paint_program_cache_t::ANY_PALETTE)
+      palette_index = 0;
+
+    paint_program_t recorded;
+    if (!paint_glyph (font, glyph,
+		      paint_program_get_funcs (), &recorded,
+		      palette_index, HB_COLOR (0, 0, 0, 0),
+		      true, &recorded))
+      return false;
+
+    if (unlikely (recorded.open_color_glyphs.length))
+      recorded.successful = false;
+
+    program = cache->set (glyph, palette_index, font->serial, recorded);
+    return true;
+  }
+
+  /* Like paint_glyph(), but records the glyph into a paint program the
+   * first time and replays it from @cache afterwards. */
+  bool
+  paint_glyph_cached (font_t *font, codepoint_t glyph, paint_funcs_t *funcs, void *data, unsigned int palette_index, color_t foreground,
+		      paint_program_cache_t *cache) const
+  {
+    if (unlikely (!cache))
+      return paint_glyph (font, glyph, funcs, data, palette_index, foreground);
+
+    paint_program_cache_t::ref_t program;
+    if (!get_paint_program (font, glyph, palette_index, cache, program))
+      return false;
+
+    if (unlikely (!program || program->in_error ()))
+      return paint_glyph (font, glyph, funcs, data, palette_index, foreground);
+
+    program->replay (font, funcs, data, foreground);
+    return true;
+  }
 #endif
 
   protected:
@@ -2737,6 +2810,9 @@ void PaintColrGlyph::paint_glyph (paint_context_t *c) const
   if (has_clip_box)
     c->funcs->pop_clip (c->data);
 
+  if (unlikely (c->program))
+    c->program->end_color_glyph ();
+
   c->current_glyphs.del (gid);
 }
 
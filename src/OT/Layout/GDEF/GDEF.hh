@@ -983,6 +983,15 @@ struct GDEF
     }
     ~accelerator_t () { table.destroy (); }
 
+    unsigned get_memory_usage () const
+    {
+#ifndef HB_NO_GDEF_CACHE
+      return mark_glyph_set_digests.get_memory_usage ();
+#else
+      return 0;
+#endif
+    }
+
     unsigned int get_glyph_props (codepoint_t glyph) const
     {
       unsigned v;
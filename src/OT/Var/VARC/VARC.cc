@@ -128,6 +128,135 @@ transforming_pen_get_funcs ()
 }
 
 
+static void
+component_recording_pen_move_to (draw_funcs_t *dfuncs HB_UNUSED,
+				 void *data,
+				 draw_state_t *st HB_UNUSED,
+				 float to_x, float to_y,
+				 void *user_data HB_UNUSED)
+{
+  float p[] = {to_x, to_y};
+  ((component_path_t *) data)->add (HB_DRAW_VERB_MOVE_TO, p, 1);
+}
+
+static void
+component_recording_pen_line_to (draw_funcs_t *dfuncs HB_UNUSED,
+				 void *data,
+				 draw_state_t *st HB_UNUSED,
+				 float to_x, float to_y,
+				 void *user_data HB_UNUSED)
+{
+  float p[] = {to_x, to_y};
+  ((component_path_t *) data)->add (HB_DRAW_VERB_LINE_TO, p, 1);
+}
+
+static void
+component_recording_pen_quadratic_to (draw_funcs_t *dfuncs HB_UNUSED,
+				      void *data,
+				      draw_state_t *st HB_UNUSED,
+				      float control_x, float control_y,
+				      float to_x, float to_y,
+				      void *user_data HB_UNUSED)
+{
+  float p[] = {control_x, control_y, to_x, to_y};
+  ((component_path_t *) data)->add (HB_DRAW_VERB_QUADRATIC_TO, p, 2);
+}
+
+static void
+component_recording_pen_cubic_to (draw_funcs_t *dfuncs HB_UNUSED,
+				  void *data,
+				  draw_state_t *st HB_UNUSED,
+				  float control1_x, float control1_y,
+				  float control2_x, float control2_y,
+				  float to_x, float to_y,
+				  void *user_data HB_UNUSED)
+{
+  float p[] = {control1_x, control1_y, control2_x, control2_y, to_x, to_y};
+  ((component_path_t *) data)->add (HB_DRAW_VERB_CUBIC_TO, p, 3);
+}
+
+static void
+component_recording_pen_close_path (draw_funcs_t *dfuncs HB_UNUSED,
+				    void *data,
+				    draw_state_t *st HB_UNUSED,
+				    void *user_data HB_UNUSED)
+{
+  ((component_path_t *) data)->add (HB_DRAW_VERB_CLOSE_PATH, nullptr, 0);
+}
+
+static inline void free_static_component_recording_pen_funcs ();
+
+static struct component_recording_pen_funcs_lazy_loader_t : draw_funcs_lazy_loader_t<component_recording_pen_funcs_lazy_loader_t>
+{
+  static draw_funcs_t *create ()
+  {
+    draw_funcs_t *funcs = draw_funcs_create ();
+
+    draw_funcs_set_move_to_func (funcs, component_recording_pen_move_to, nullptr, nullptr);
+    draw_funcs_set_line_to_func (funcs, component_recording_pen_line_to, nullptr, nullptr);
+    draw_funcs_set_quadratic_to_func (funcs, component_recording_pen_quadratic_to, nullptr, nullptr);
+    draw_funcs_set_cubic_to_func (funcs, component_recording_pen_cubic_to, nullptr, nullptr);
+    draw_funcs_set_close_path_func (funcs, component_recording_pen_close_path, nullptr, nullptr);
+
+    draw_funcs_make_immutable (funcs);
+
+    atexit (free_static_component_recording_pen_funcs);
+
+    return funcs;
+  }
+} static_component_recording_pen_funcs;
+
+static inline
+void free_static_component_recording_pen_funcs ()
+{
+  static_component_recording_pen_funcs.free_instance ();
+}
+
+static draw_funcs_t *
+component_recording_pen_get_funcs ()
+{
+  return static_component_recording_pen_funcs.get_unconst ();
+}
+
+/* Draws the non-composite glyph gid through transform, from the component
+ * cache if possible.  Returns false if it could not, in which case nothing
+ * was drawn. */
+static bool
+_draw_cached_component (font_t *font,
+			codepoint_t gid,
+			array_t<const int> coords,
+			const transform_t &transform,
+			draw_session_t &draw_session,
+			component_cache_t *component_cache)
+{
+  component_cache_t::key_t key;
+  if (unlikely (!component_cache_t::make_key (gid, coords, key)))
+    return false;
+
+  component_path_t path;
+  component_cache_t::ref_t cached = component_cache->get (key, font->serial);
+  if (!cached)
+  {
+    {
+      // Need the session to be destructed, closing the last contour, before using the path.
+      draw_session_t recording_session {component_recording_pen_get_funcs (), &path};
+      auto &VARC = *font->face->table.VARC;
+      // Passing gid as its own parent keeps this from recursing as a composite.
+      VARC.get_path_at (font, gid, recording_session, coords, gid);
+    }
+    if (unlikely (path.in_error ()))
+      return false;
+    cached = component_cache->set (key, font->serial, path);
+  }
+
+  vector_t<float> scratch;
+  (cached ? *cached : path).replay (transform,
+				    draw_session.funcs, draw_session.draw_data, draw_session.st,
+				    scratch);
+  return true;
+}
+
+
 ubytes_t
 VarComponent::get_path_at (font_t *font,
 			   codepoint_t parent_gid,
@@ -137,7 +266,8 @@ VarComponent::get_path_at (font_t *font,
 			   set_t *visited,
 			   signed *edges_left,
 			   signed depth_left,
-			   VarRegionList::cache_t *cache) const
+			   VarRegionList::cache_t *cache,
+			   component_cache_t *component_cache) const
 {
   const unsigned char *end = total_record.arrayZ + total_record.length;
   const unsigned char *record = total_record.arrayZ;
@@ -320,18 +450,28 @@ VarComponent::get_path_at (font_t *font,
     transform.tCenterX *= x_scale;
     transform.tCenterY *= y_scale;
 
-    // Build a transforming pen to apply the transform.
-    draw_funcs_t *transformer_funcs = transforming_pen_get_funcs ();
-    transforming_pen_context_t context {transform.to_transform (),
-					   draw_session.funcs,
-					   draw_session.draw_data,
-					   &draw_session.st};
-    draw_session_t transformer_session {transformer_funcs, &context};
-
-    VARC.get_path_at (font, gid,
-		      transformer_session, component_coords,
-		      parent_gid,
-		      visited, edges_left, depth_left - 1);
+    transform_t component_transform = transform.to_transform ();
+
+    // Plain glyphs come out of the cache, transformed in one go.
+    if (!(component_cache && VARC.is_leaf (gid, parent_gid) &&
+	  _draw_cached_component (font, gid, component_coords,
+				  component_transform, draw_session,
+				  component_cache)))
+    {
+      // Build a transforming pen to apply the transform.
+      draw_funcs_t *transformer_funcs = transforming_pen_get_funcs ();
+      transforming_pen_context_t context {component_transform,
+					     draw_session.funcs,
+					     draw_session.draw_data,
+					     &draw_session.st};
+      draw_session_t transformer_session {transformer_funcs, &context};
+
+      VARC.get_path_at (font, gid,
+			transformer_session, component_coords,
+			parent_gid,
+			visited, edges_left, depth_left - 1,
+			component_cache);
+    }
   }
 
 #undef PROCESS_TRANSFORM_COMPONENTS
@@ -6,6 +6,7 @@
 #include "../../../hb-ot-cff2-table.hh"
 #include "../../../hb-ot-cff1-table.hh"
 
+#include "component-cache.hh"
 #include "coord-setter.hh"
 
 namespace OT {
@@ -50,7 +51,8 @@ struct VarComponent
 	       hb_set_t *visited,
 	       signed *edges_left,
 	       signed depth_left,
-	       VarRegionList::cache_t *cache = nullptr) const;
+	       VarRegionList::cache_t *cache = nullptr,
+	       component_cache_t *component_cache = nullptr) const;
 };
 
 struct VarCompositeGlyph
@@ -64,7 +66,8 @@ struct VarCompositeGlyph
 	       hb_set_t *visited,
 	       signed *edges_left,
 	       signed depth_left,
-	       VarRegionList::cache_t *cache = nullptr)
+	       VarRegionList::cache_t *cache = nullptr,
+	       component_cache_t *component_cache = nullptr)
   {
     while (record)
     {
@@ -72,7 +75,8 @@ struct VarCompositeGlyph
       record = comp.get_path_at (font, glyph,
 				 draw_session, coords,
 				 record,
-				 visited, edges_left, depth_left, cache);
+				 visited, edges_left, depth_left,
+				 cache, component_cache);
     }
   }
 };
@@ -93,7 +97,8 @@ struct VARC
 	       hb_codepoint_t parent_glyph = HB_CODEPOINT_INVALID,
 	       hb_set_t *visited = nullptr,
 	       signed *edges_left = nullptr,
-	       signed depth_left = HB_MAX_NESTING_LEVEL) const
+	       signed depth_left = HB_MAX_NESTING_LEVEL,
+	       component_cache_t *component_cache = nullptr) const
   {
     hb_set_t stack_set;
     if (visited == nullptr)
@@ -138,7 +143,7 @@ struct VARC
 				    draw_session, coords,
 				    record,
 				    visited, edges_left, depth_left,
-				    cache);
+				    cache, component_cache);
 
     (this+varStore).destroy_cache (cache);
 
@@ -147,9 +152,21 @@ struct VARC
     return true;
   }
 
+  /* Whether glyph would be drawn from its own glyf or CFF outline, rather
+   * than as a variable composite. */
+  bool is_leaf (hb_codepoint_t glyph, hb_codepoint_t parent_glyph) const
+  { return glyph == parent_glyph || (this+coverage).get_coverage (glyph) == NOT_COVERED; }
+
+  bool has_data () const { return version.major != 0; }
+
   bool
-  get_path (hb_font_t *font, hb_codepoint_t gid, hb_draw_session_t &draw_session) const
-  { return get_path_at (font, gid, draw_session, hb_array (font->coords, font->num_coords)); }
+  get_path (hb_font_t *font, hb_codepoint_t gid, hb_draw_session_t &draw_session,
+	    component_cache_t *component_cache = nullptr) const
+  {
+    return get_path_at (font, gid, draw_session, hb_array (font->coords, font->num_coords),
+			HB_CODEPOINT_INVALID, nullptr, nullptr, HB_MAX_NESTING_LEVEL,
+			component_cache);
+  }
 
   bool paint_glyph (hb_font_t *font, hb_codepoint_t gid, hb_paint_funcs_t *funcs, void *data, hb_color_t foreground) const
   {
@@ -0,0 +1,170 @@
+#ifndef OT_VAR_VARC_COMPONENT_CACHE_HH
+#define OT_VAR_VARC_COMPONENT_CACHE_HH
+
+
+#include "../../../hb.hh"
+#include "../../../hb-cache-entry.hh"
+#include "../../../hb-draw.hh"
+#include "../../../hb-geometry.hh"
+#include "../../../hb-map.hh"
+#include "../../../hb-mutex.hh"
+
+
+namespace OT {
+
+
+/* The draw calls of a component glyph's outline, in font-scaled units and
+ * before the component transform is applied. */
+struct component_path_t
+{
+  void reset ()
+  {
+    verbs.reset ();
+    coords.reset ();
+  }
+
+  bool in_error () const { return verbs.in_error () || coords.in_error (); }
+
+  unsigned get_memory_usage () const
+  { return verbs.get_memory_usage () + coords.get_memory_usage (); }
+
+  void add (draw_verb_t verb, const float *points, unsigned num_points)
+  {
+    verbs.push (verb);
+    for (unsigned i = 0; i < 2 * num_points; i++)
+      coords.push (points[i]);
+  }
+
+  /* Emits the path through funcs, with all points mapped through transform
+   * in one pass beforehand.  Calls go through the funcs methods directly,
+   * with st as their state, like the transforming pen does. */
+  void replay (const transform_t &transform,
+	       draw_funcs_t *funcs, void *data, draw_state_t &st,
+	       vector_t<float> &scratch) const
+  {
+    scratch = coords;
+    if (unlikely (scratch.in_error ())) return;
+    transform.transform_points (scratch.arrayZ, scratch.length / 2);
+
+    const float *c = scratch.arrayZ;
+    for (uint8_t verb : verbs)
+    {
+      switch (verb)
+      {
+      case HB_DRAW_VERB_MOVE_TO:
+	funcs->move_to (data, st, c[0], c[1]);
+	c += 2;
+	break;
+      case HB_DRAW_VERB_LINE_TO:
+	funcs->line_to (data, st, c[0], c[1]);
+	c += 2;
+	break;
+      case HB_DRAW_VERB_QUADRATIC_TO:
+	funcs->quadratic_to (data, st, c[0], c[1], c[2], c[3]);
+	c += 4;
+	break;
+      case HB_DRAW_VERB_CUBIC_TO:
+	funcs->cubic_to (data, st, c[0], c[1], c[2], c[3], c[4], c[5]);
+	c += 6;
+	break;
+      case HB_DRAW_VERB_CLOSE_PATH:
+	funcs->close_path (data, st);
+	break;
+      default:
+	return;
+      }
+    }
+  }
+
+  vector_t<uint8_t> verbs;
+  vector_t<float> coords;
+};
+
+/* Per-font cache of the outlines of VARC components that are plain glyf or
+ * CFF glyphs, keyed by glyph and the normalized coordinates the component
+ * instances it at.  Composite components are not cached: what they draw
+ * depends on the recursion budget left at the point of use.
+ *
+ * Entries are only valid for one font state, which font_t::serial
+ * identifies; the whole cache is dropped when the serial changes or when
+ * it would grow past MAX_COORDS coordinates.  Outlines are handed out as
+ * references to the cached entries, and replayed after the lock is
+ * dropped. */
+struct component_cache_t
+{
+  static constexpr unsigned MAX_COORDS = 1u << 16;
+
+  /* Key is the glyph followed by the component coordinates. */
+  typedef vector_t<int> key_t;
+
+  typedef cache_entry_t<component_path_t>::ref_t ref_t;
+
+  static bool make_key (codepoint_t gid, array_t<const int> coords,
+			key_t &key /* OUT */)
+  {
+    if (unlikely (!key.resize_exact (coords.length + 1, false)))
+      return false;
+    key.arrayZ[0] = (int) gid;
+    for (unsigned i = 0; i < coords.length; i++)
+      key.arrayZ[i + 1] = coords.arrayZ[i];
+    return true;
+  }
+
+  ref_t get (const key_t &key, unsigned serial) const
+  {
+    lock_t l (lock);
+
+    if (serial != font_serial) return ref_t ();
+
+    const ref_t *cached;
+    if (!components.has (key, &cached)) return ref_t ();
+    return *cached;
+  }
+
+  /* Moves key and path into the cache, and returns the cached path to use
+   * in place of path; or nothing, leaving both alone, if it is not
+   * cached. */
+  ref_t set (key_t &key, unsigned serial,
+	     component_path_t &path)
+  {
+    if (unlikely (path.coords.length > MAX_COORDS || path.in_error ())) return ref_t ();
+
+    lock_t l (lock);
+
+    unsigned num_path_coords = path.coords.length;
+    if (serial != font_serial || num_coords + num_path_coords > MAX_COORDS)
+    {
+      components.reset ();
+      num_coords = 0;
+      font_serial = serial;
+    }
+    else
+    {
+      const ref_t *cached;
+      if (components.has (key, &cached)) return *cached;
+    }
+
+    ref_t entry = cache_entry_t<component_path_t>::create (path);
+    if (unlikely (!entry || !components.set (std::move (key), entry))) return entry;
+    num_coords += num_path_coords;
+    return entry;
+  }
+
+  unsigned get_memory_usage () const
+  {
+    lock_t l (lock);
+    return components.get_memory_usage ();
+  }
+
+  protected:
+  mutable mutex_t lock; /* Protects members below. */
+  unsigned font_serial = 0;
+  unsigned num_coords = 0;
+  hashmap_t<key_t, ref_t> components;
+};
+
+
+} /* namespace OT */
+
+
+#endif /* OT_VAR_VARC_COMPONENT_CACHE_HH */
@@ -34,6 +34,15 @@ struct SimpleGlyph
   unsigned int length (unsigned int instruction_len) const
   { return instruction_len_offset () + 2 + instruction_len; }
 
+  /* Number of outline points, from the last endPtsOfContours entry;
+   * zero if the glyph is truncated. */
+  unsigned int num_points () const
+  {
+    unsigned int offset = instruction_len_offset ();
+    if (unlikely (offset > bytes.length)) return 0;
+    return StructAtOffset<HBUINT16> (bytes.arrayZ, offset - 2) + 1;
+  }
+
   bool has_instructions_length () const
   {
     return instruction_len_offset () + 2 <= bytes.length;
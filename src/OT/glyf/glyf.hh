@@ -13,6 +13,7 @@
 #include "Glyph.hh"
 #include "SubsetGlyph.hh"
 #include "loca.hh"
+#include "outline-cache.hh"
 #include "path-builder.hh"
 
 
@@ -206,10 +207,14 @@ struct glyf_accelerator_t
   protected:
   template<typename T>
   bool get_points (font_t *font, codepoint_t gid, T consumer,
-		   array_t<const int> coords = array_t<const int> ()) const
+		   array_t<const int> coords = array_t<const int> (),
+		   glyf_impl::outline_cache_t *cache = nullptr) const
   {
+    /* Cache entries are keyed by the font's own coordinates only. */
     if (!coords)
       coords = array (font->coords, font->num_coords);
+    else
+      cache = nullptr;
 
     if (gid >= num_glyphs) return false;
 
@@ -217,11 +222,20 @@ struct glyf_accelerator_t
        https://github.com/harfbuzz/harfbuzz/issues/2095
        mostly because of gvar handling in VF fonts,
        perhaps a separate path for non-VF fonts can be considered */
-    contour_point_vector_t all_points;
+    contour_point_vector_t computed_points;
+    glyf_impl::outline_cache_t::ref_t cached;
 
     bool phantom_only = !consumer.is_consuming_contour_points ();
-    if (unlikely (!glyph_for_gid (gid).get_points (font, *this, all_points, nullptr, nullptr, nullptr, true, true, phantom_only, coords)))
-      return false;
+    if (!cache || !(cached = cache->get (gid, font->serial_coords)))
+    {
+      if (unlikely (!glyph_for_gid (gid).get_points (font, *this, computed_points, nullptr, nullptr, nullptr, true, true, phantom_only, coords)))
+	return false;
+
+      /* Phantom-only results lack the contour points; don't keep those. */
+      if (cache && !phantom_only)
+	cached = cache->set (gid, font->serial_coords, computed_points);
+    }
+    const contour_point_vector_t &all_points = cached ? *cached : computed_points;
 
     unsigned count = all_points.length;
     assert (count >= glyf_impl::PHANTOM_COUNT);
@@ -360,17 +374,59 @@ struct glyf_accelerator_t
   }
 
   public:
-  bool get_extents (font_t *font, codepoint_t gid, glyph_extents_t *extents) const
+  bool get_extents (font_t *font, codepoint_t gid, glyph_extents_t *extents,
+		    glyf_impl::outline_cache_t *cache = nullptr) const
   {
     if (unlikely (gid >= num_glyphs)) return false;
 
 #ifndef HB_NO_VAR
     if (font->num_coords)
-      return get_points (font, gid, points_aggregator_t (font, extents, nullptr, true));
+      return get_points (font, gid, points_aggregator_t (font, extents, nullptr, true),
+			 array_t<const int> (), cache);
 #endif
     return glyph_for_gid (gid).get_extents_without_var_scaled (font, *this, extents);
   }
 
+  /* Cheap, conservative extents for variable fonts: the default-instance
+   * bbox from the glyph header, grown by a bound on the gvar deltas, so no
+   * outline is decoded.  Only handles simple glyphs; returns false for
+   * anything else, and callers should fall back to get_extents(). */
+  bool get_extents_approximate (font_t *font, codepoint_t gid, glyph_extents_t *extents) const
+  {
+#ifndef HB_NO_VAR
+    if (unlikely (gid >= num_glyphs)) return false;
+
+    const glyf_impl::Glyph glyph = glyph_for_gid (gid);
+    if (glyph.get_type () != glyf_impl::Glyph::SIMPLE) return false;
+    const glyf_impl::GlyphHeader &header = *glyph.get_header ();
+    unsigned num_points = glyf_impl::SimpleGlyph (header, glyph.get_bytes ()).num_points ();
+    if (unlikely (!num_points)) return false;
+
+    float x_bound, y_bound;
+    if (unlikely (!gvar->get_delta_bounds (gid, array (font->coords, font->num_coords),
+					   num_points + glyf_impl::PHANTOM_COUNT,
+					   &x_bound, &y_bound)))
+      return false;
+
+    /* Points end up shifted by the varied left side bearing, which itself
+     * moves by up to x_bound; hence the doubled horizontal bound. */
+    int x_min = min (header.xMin, header.xMax);
+    int x_max = max (header.xMin, header.xMax);
+    int lsb = x_min;
+    (void) hmtx->get_leading_bearing_without_var_unscaled (gid, &lsb);
+
+    extents->x_bearing = floorf (lsb - 2 * x_bound);
+    extents->width     = ceilf (lsb + (x_max - x_min) + 2 * x_bound) - extents->x_bearing;
+    extents->y_bearing = ceilf (max (header.yMin, header.yMax) + y_bound);
+    extents->height    = floorf (min (header.yMin, header.yMax) - y_bound) - extents->y_bearing;
+
+    font->scale_glyph_extents (extents);
+    return true;
+#else
+    return false;
+#endif
+  }
+
   bool paint_glyph (font_t *font, codepoint_t gid, paint_funcs_t *funcs, void *data, color_t foreground) const
   {
     funcs->push_clip_glyph (data, gid, font);
@@ -409,8 +465,10 @@ struct glyf_accelerator_t
   }
 
   bool
-  get_path (font_t *font, codepoint_t gid, draw_session_t &draw_session) const
-  { return get_points (font, gid, glyf_impl::path_builder_t (font, draw_session)); }
+  get_path (font_t *font, codepoint_t gid, draw_session_t &draw_session,
+	    glyf_impl::outline_cache_t *cache = nullptr) const
+  { return get_points (font, gid, glyf_impl::path_builder_t (font, draw_session),
+		       array_t<const int> (), cache); }
 
   bool
   get_path_at (font_t *font, codepoint_t gid, draw_session_t &draw_session,
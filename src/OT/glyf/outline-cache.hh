@@ -0,0 +1,103 @@
+#ifndef OT_GLYF_OUTLINE_CACHE_HH
+#define OT_GLYF_OUTLINE_CACHE_HH
+
+
+#include "../../hb.hh"
+#include "../../hb-cache-entry.hh"
+#include "../../hb-map.hh"
+#include "../../hb-mutex.hh"
+
+
+namespace OT {
+namespace glyf_impl {
+
+
+/* Per-font cache of decoded, delta-applied glyph points, phantoms
+ * included, in font units.
+ *
+ * Entries are only valid for one set of normalized coordinates, which
+ * font_t::serial_coords identifies.  Glyphs are spread over shards, each
+ * with its own lock and a share of MAX_POINTS; a shard is dropped when
+ * the serial changes or when it would grow past its share, leaving the
+ * others alone.  Points are handed out as references to the cached
+ * entries, which stay valid after that. */
+struct outline_cache_t
+{
+  static constexpr unsigned MAX_POINTS = 1u << 14;
+  static constexpr unsigned NUM_SHARDS = 4;
+  static constexpr unsigned SHARD_POINTS = MAX_POINTS / NUM_SHARDS;
+
+  typedef cache_entry_t<contour_point_vector_t>::ref_t ref_t;
+
+  ref_t get (codepoint_t gid, unsigned serial) const
+  {
+    const shard_t &shard = shards[gid % NUM_SHARDS];
+    lock_t l (shard.lock);
+
+    if (serial != shard.coords_serial) return ref_t ();
+
+    const ref_t *cached;
+    if (!shard.glyphs.has (gid, &cached)) return ref_t ();
+    return *cached;
+  }
+
+  /* Moves points into the cache, and returns the cached points to use in
+   * their place; or nothing, leaving points alone, if they are not
+   * cached. */
+  ref_t set (codepoint_t gid, unsigned serial,
+	     contour_point_vector_t &points)
+  {
+    if (unlikely (points.length > SHARD_POINTS || points.in_error ())) return ref_t ();
+
+    shard_t &shard = shards[gid % NUM_SHARDS];
+    lock_t l (shard.lock);
+
+    unsigned num_glyph_points = points.length;
+    if (serial != shard.coords_serial ||
+	shard.num_points + num_glyph_points > SHARD_POINTS)
+    {
+      shard.glyphs.reset ();
+      shard.num_points = 0;
+      shard.coords_serial = serial;
+    }
+    else
+    {
+      const ref_t *cached;
+      if (shard.glyphs.has (gid, &cached)) return *cached;
+    }
+
+    ref_t entry = cache_entry_t<contour_point_vector_t>::create (points);
+    if (unlikely (!entry || !shard.glyphs.set (gid, entry))) return entry;
+    shard.num_points += num_glyph_points;
+    return entry;
+  }
+
+  unsigned get_memory_usage () const
+  {
+    unsigned size = 0;
+    for (const shard_t &shard : shards)
+    {
+      lock_t l (shard.lock);
+      size += shard.glyphs.get_memory_usage ();
+    }
+    return size;
+  }
+
+  protected:
+  struct shard_t
+  {
+    mutable mutex_t lock; /* Protects members below. */
+    unsigned coords_serial = 0;
+    unsigned num_points = 0;
+    hashmap_t<codepoint_t, ref_t> glyphs;
+  };
+
+  shard_t shards[NUM_SHARDS];
+};
+
+
+} /* namespace glyf_impl */
+} /* namespace OT */
+
+
+#endif /* OT_GLYF_OUTLINE_CACHE_HH */
@@ -519,6 +519,8 @@ struct name
       this->table.destroy ();
     }
 
+    unsigned get_memory_usage () const { return names.get_memory_usage (); }
+
     int get_index (ot_name_id_t  name_id,
 		   language_t    language,
 		   unsigned int    *width=nullptr) const
@@ -9,6 +9,8 @@
 #include "hb-common.cc"
 #include "hb-draw.cc"
 #include "hb-face-builder.cc"
+#include "hb-face-warm-up.cc"
+#include "hb-face-woff.cc"
 #include "hb-face.cc"
 #include "hb-fallback-shape.cc"
 #include "hb-font.cc"
@@ -44,6 +46,7 @@
 #include "hb-ot-var.cc"
 #include "hb-outline.cc"
 #include "hb-paint-extents.cc"
+#include "hb-paint-program.cc"
 #include "hb-paint.cc"
 #include "hb-set.cc"
 #include "hb-shape-plan.cc"
@@ -10,6 +10,8 @@
 #include "hb-directwrite.cc"
 #include "hb-draw.cc"
 #include "hb-face-builder.cc"
+#include "hb-face-warm-up.cc"
+#include "hb-face-woff.cc"
 #include "hb-face.cc"
 #include "hb-fallback-shape.cc"
 #include "hb-font.cc"
@@ -49,6 +51,7 @@
 #include "hb-ot-var.cc"
 #include "hb-outline.cc"
 #include "hb-paint-extents.cc"
+#include "hb-paint-program.cc"
 #include "hb-paint.cc"
 #include "hb-set.cc"
 #include "hb-shape-plan.cc"
@@ -1316,6 +1316,10 @@ struct mortmorx
 
     blob_t *get_blob () const { return table.get_blob (); }
 
+    /* Chain accelerators are sized by their subtable count; only the
+     * pointers to them are counted. */
+    unsigned get_memory_usage () const { return chain_count * sizeof (*accels); }
+
     template <typename Chain>
     aat_layout_chain_accelerator_t *get_accel (unsigned chain_index, const Chain &chain, unsigned num_glyphs) const
     {
@@ -385,6 +385,26 @@ struct
 }
 HB_FUNCOBJ (hash);
 
+/* Heap memory owned by an object, not counting the object itself.
+ * Objects report it through a get_memory_usage() method; anything
+ * without one is taken to own none. */
+struct
+{
+  private:
+
+  template <typename T> constexpr auto
+  impl (const T& v, priority<1>) const HB_RETURN (unsigned, v.get_memory_usage ())
+
+  template <typename T> constexpr unsigned
+  impl (const T& v HB_UNUSED, priority<0>) const { return 0; }
+
+  public:
+
+  template <typename T> constexpr auto
+  operator () (const T& v) const HB_RETURN (unsigned, impl (v, prioritize))
+}
+HB_FUNCOBJ (heap_size);
+
 
 struct
 {
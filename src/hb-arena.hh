@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef HB_ARENA_HH
+#define HB_ARENA_HH
+
+#include "hb.hh"
+
+#include "hb-atomic.hh"
+
+
+/* Lock-free bump allocator for objects that live as long as the arena.
+ *
+ * Memory comes out zeroed, from chunks that are only freed with the
+ * arena; there is no per-object free.  Consecutive allocations come from
+ * consecutive memory, so objects built together sit together.  Any
+ * number of threads can allocate at once: each claims its bytes of the
+ * current chunk with one atomic add, and the thread that finds the chunk
+ * full pushes a fresh one.
+ *
+ * Allocations are ALIGN-aligned.  malloc() only promises alignment for
+ * the fundamental types, which is less on some platforms, so chunk data
+ * is aligned by hand. */
+struct arena_t
+{
+  static constexpr unsigned ALIGN = 16;
+  static constexpr unsigned CHUNK_SIZE = 16384;
+  static constexpr unsigned MAX_SIZE = 1u << 24;
+
+  arena_t () = default;
+  arena_t (const arena_t &) = delete;
+  ~arena_t () { fini (); }
+
+  void fini ()
+  {
+    chunk_t *chunk = chunks.get_relaxed ();
+    chunks.set_relaxed (nullptr);
+    while (chunk)
+    {
+      chunk_t *next = chunk->next;
+      free (chunk);
+      chunk = next;
+    }
+  }
+
+  void *alloc (unsigned size)
+  {
+    if (unlikely (size > MAX_SIZE)) return nullptr;
+    size = (size + ALIGN - 1) & ~(ALIGN - 1);
+
+    for (;;)
+    {
+      chunk_t *chunk = chunks.get_acquire ();
+      if (likely (chunk))
+      {
+	/* Failed claims leave used past the end; the chunk is spent then. */
+	unsigned offset = chunk->used.add ((int) size);
+	if (offset <= chunk->size && size <= chunk->size - offset)
+	  return chunk->data + offset;
+      }
+      if (unlikely (!push_chunk (chunk, size)))
+	return nullptr;
+    }
+  }
+
+  /* Makes sure the next size bytes of allocations come from one chunk,
+   * unless another thread allocates meanwhile. */
+  bool reserve (unsigned size)
+  {
+    if (unlikely (size > MAX_SIZE)) return false;
+
+    chunk_t *chunk = chunks.get_acquire ();
+    if (chunk)
+    {
+      unsigned used = min ((unsigned) chunk->used.get_relaxed (), chunk->size);
+      if (size <= chunk->size - used)
+	return true;
+    }
+    return push_chunk (chunk, size);
+  }
+
+  /* Memory held in chunks, used or not. */
+  unsigned get_memory_usage () const
+  {
+    unsigned size = 0;
+    for (const chunk_t *chunk = chunks.get_acquire (); chunk; chunk = chunk->next)
+      size += sizeof (chunk_t) + ALIGN - 1 + chunk->size;
+    return size;
+  }
+
+  private:
+
+  struct chunk_t
+  {
+    chunk_t *next;
+    unsigned size;
+    atomic_int_t used;
+    char *data; /* ALIGN-aligned, in the same block, right after. */
+  };
+
+  /* Replaces old as the current chunk with one that has room for at
+   * least min_size bytes.  Returns true if there is a new current chunk,
+   * whoever made it. */
+  bool push_chunk (chunk_t *old, unsigned min_size)
+  {
+    unsigned size = max (CHUNK_SIZE, min_size);
+    auto *chunk = (chunk_t *) calloc (1, sizeof (chunk_t) + ALIGN - 1 + size);
+    if (unlikely (!chunk)) return false;
+
+    uintptr_t data = (uintptr_t) (chunk + 1);
+    chunk->data = (char *) ((data + ALIGN - 1) & ~(uintptr_t) (ALIGN - 1));
+    chunk->next = old;
+    chunk->size = size;
+    if (unlikely (!chunks.cmpexch (old, chunk)))
+      free (chunk); /* Someone else pushed one; use theirs. */
+    return true;
+  }
+
+  atomic_ptr_t<chunk_t> chunks;
+};
+
+
+#endif /* HB_ARENA_HH */
@@ -193,6 +193,7 @@ struct atomic_int_t
   int get_acquire () const { return atomic_int_impl_get (&v); }
   int inc () { return atomic_int_impl_add (&v,  1); }
   int dec () { return atomic_int_impl_add (&v, -1); }
+  int add (int d) { return atomic_int_impl_add (&v, d); }
 
   int v = 0;
 };
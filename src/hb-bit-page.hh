@@ -31,7 +31,11 @@
 #include "hb.hh"
 
 
-/* Compiler-assisted vectorization. */
+/* Compiler-assisted vectorization.
+ *
+ * The loops below are left to the compiler, which vectorizes them for
+ * whatever the build targets; hand-written AVX2 and AVX-512 versions
+ * measured no faster. */
 
 /* Type behaving similar to vectorized vars defined using __attribute__((vector_size(...))),
  * basically a fixed-size bitset. We can't use the compiler type because vector_t cannot
@@ -166,14 +170,13 @@ struct bit_page_t
     unsigned int count = 0;
     for (unsigned i = start_v; i < len () && count < size; i++)
     {
-      elt_t bits = v[i];
+      /* Visit only the set bits, lowest first. */
+      elt_t bits = v[i] & ~((elt_t (1) << start_bit) - 1);
       uint32_t v_base = base | (i * ELT_BITS);
-      for (unsigned int j = start_bit; j < ELT_BITS && count < size; j++)
+      for (; bits && count < size; bits &= bits - 1)
       {
-	if ((elt_t(1) << j) & bits) {
-	  *p++ = v_base | j;
-	  count++;
-	}
+	*p++ = v_base | elt_get_min (bits);
+	count++;
       }
       start_bit = 0;
     }
@@ -197,22 +200,19 @@ struct bit_page_t
     unsigned int count = 0;
     for (unsigned i = start_v; i < len () && count < size; i++)
     {
-      elt_t bits = v[i];
+      elt_t bits = v[i] & ~((elt_t (1) << start_bit) - 1);
       uint32_t v_offset = i * ELT_BITS;
-      for (unsigned int j = start_bit; j < ELT_BITS && count < size; j++)
+      for (; bits && count < size; bits &= bits - 1)
       {
-	if ((elt_t(1) << j) & bits)
+	codepoint_t value = base | v_offset | elt_get_min (bits);
+	// Emit all the missing values from next_value up to value - 1.
+	for (codepoint_t k = *next_value; k < value && count < size; k++)
 	{
-	  codepoint_t value = base | v_offset | j;
-	  // Emit all the missing values from next_value up to value - 1.
-	  for (codepoint_t k = *next_value; k < value && count < size; k++)
-	  {
-	    *p++ = k;
-	    count++;
-	  }
-	  // Skip over this value;
-	  *next_value = value + 1;
+	  *p++ = k;
+	  count++;
 	}
+	// Skip over this value;
+	*next_value = value + 1;
       }
       start_bit = 0;
     }
@@ -244,10 +244,16 @@ struct bit_page_t
   unsigned int get_population () const
   {
     if (has_population ()) return population;
-    population =
-    + iter (v)
-    | reduce ([] (unsigned pop, const elt_t &_) { return pop + popcount (_); }, 0u)
-    ;
+    /* Independent sums, so the popcounts don't wait on each other. */
+    unsigned pop[4] = {};
+    for (unsigned i = 0; i < len (); i += 4)
+    {
+      pop[0] += popcount (v[i]);
+      pop[1] += popcount (v[i + 1]);
+      pop[2] += popcount (v[i + 2]);
+      pop[3] += popcount (v[i + 3]);
+    }
+    population = pop[0] + pop[1] + pop[2] + pop[3];
     return population;
   }
 
@@ -335,6 +341,7 @@ struct bit_page_t
 
   static constexpr unsigned ELT_BITS = sizeof (elt_t) * 8;
   static constexpr unsigned ELT_MASK = ELT_BITS - 1;
+  static_assert (PAGE_BITS / ELT_BITS % 4 == 0, "");
 
   static constexpr unsigned BITS = sizeof (vector_t) * 8;
   static constexpr unsigned MASK = BITS - 1;
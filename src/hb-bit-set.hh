@@ -49,6 +49,7 @@ struct bit_set_t
     swap (a.last_page_lookup, b.last_page_lookup);
     swap (a.page_map, b.page_map);
     swap (a.pages, b.pages);
+    swap (a.page_directory, b.page_directory);
   }
 
   void init ()
@@ -58,11 +59,13 @@ struct bit_set_t
     last_page_lookup = 0;
     page_map.init ();
     pages.init ();
+    page_directory.init ();
   }
   void fini ()
   {
     page_map.fini ();
     pages.fini ();
+    page_directory.fini ();
   }
 
   using page_t = bit_page_t;
@@ -75,11 +78,23 @@ struct bit_set_t
     uint32_t index;
   };
 
+  /* Sets with at least DIRECTORY_MIN_PAGES pages, all of them within the
+   * first DIRECTORY_MAJORS majors (the first 64k codepoints, which covers
+   * the glyph sets of most fonts), also keep a direct index from major to
+   * page.  That makes page lookups O(1) instead of a binary search over
+   * page_map.  Entries are the page index plus one, or zero if there is no
+   * page for the major.  The directory is either empty or DIRECTORY_MAJORS
+   * long. */
+  static constexpr unsigned DIRECTORY_MAJORS = 65536 / page_t::PAGE_BITS;
+  static constexpr unsigned DIRECTORY_MIN_PAGES = 4;
+  static_assert (DIRECTORY_MAJORS <= 255, "");
+
   bool successful = true; /* Allocations successful */
   mutable unsigned int population = 0;
   mutable atomic_int_t last_page_lookup = 0;
   sorted_vector_t<page_map_t> page_map;
   vector_t<page_t> pages;
+  vector_t<uint8_t> page_directory;
 
   void err () { if (successful) successful = false; } /* TODO Remove */
   bool in_error () const { return !successful; }
@@ -94,12 +109,28 @@ struct bit_set_t
     if (unlikely (!pages.resize (count, clear, exact_size) || !page_map.resize (count, clear, exact_size)))
     {
       pages.resize (page_map.length, clear, exact_size);
+      page_directory.resize (0);
       successful = false;
       return false;
     }
     return true;
   }
 
+  /* Rebuilds page_directory after page_map changed in bulk. */
+  void update_directory ()
+  {
+    page_directory.resize (0);
+    if (pages.length < DIRECTORY_MIN_PAGES ||
+	page_map.tail ().major >= DIRECTORY_MAJORS)
+      return;
+
+    /* Failing to allocate is fine; lookups take the slow path then. */
+    if (unlikely (!page_directory.resize_exact (DIRECTORY_MAJORS)))
+      return;
+    for (const page_map_t &map : page_map)
+      page_directory.arrayZ[map.major] = map.index + 1;
+  }
+
   void alloc (unsigned sz)
   {
     sz >>= (page_t::PAGE_BITS_LOG_2 - 1);
@@ -116,6 +147,7 @@ struct bit_set_t
   void clear ()
   {
     resize (0);
+    page_directory.resize (0);
     if (likely (successful))
       population = 0;
   }
@@ -303,6 +335,7 @@ struct bit_set_t
       }
       compact (compact_workspace, write_index);
       resize (write_index);
+      update_directory ();
     }
   }
 
@@ -373,6 +406,7 @@ struct bit_set_t
 
     page_map = other.page_map;
     pages = other.pages;
+    page_directory = other.page_directory;
   }
 
   bool is_equal (const bit_set_t &other) const
@@ -603,11 +637,12 @@ struct bit_set_t
       }
     assert (!count);
     resize (newCount);
+    update_directory ();
   }
   template <typename Op>
   static bit_page_t::vector_t
   op_ (const bit_page_t::vector_t &a, const bit_page_t::vector_t &b)
-  { return Op{} (a, b); }
+  { return a.process (Op{}, b); }
   template <typename Op>
   void process (const Op& op, const bit_set_t &other)
   {
@@ -911,6 +946,16 @@ struct bit_set_t
   {
     unsigned major = get_major (g);
 
+    if (page_directory.length)
+    {
+      /* With a directory, there are no pages past it. */
+      unsigned j = major < DIRECTORY_MAJORS ? page_directory.arrayZ[major] : 0;
+      if (j)
+	return &pages.arrayZ[j - 1];
+      if (!insert)
+	return nullptr;
+    }
+
     /* The extra page_map length is necessary; can't just rely on vector here,
      * since the next check would be tricked because a null page also has
      * major==0, which we can't distinguish from an actually major==0 page... */
@@ -936,6 +981,16 @@ struct bit_set_t
 	       page_map.arrayZ + i,
 	       (page_map.length - 1 - i) * page_map.item_size);
       page_map.arrayZ[i] = map;
+
+      if (page_directory.length)
+      {
+	if (major < DIRECTORY_MAJORS)
+	  page_directory.arrayZ[major] = map.index + 1;
+	else
+	  page_directory.resize (0);
+      }
+      else if (pages.length == DIRECTORY_MIN_PAGES)
+	update_directory ();
     }
 
     last_page_lookup = i;
@@ -945,6 +1000,13 @@ struct bit_set_t
   {
     unsigned major = get_major (g);
 
+    if (page_directory.length)
+    {
+      /* With a directory, there are no pages past it. */
+      unsigned j = major < DIRECTORY_MAJORS ? page_directory.arrayZ[major] : 0;
+      return j ? &pages.arrayZ[j - 1] : nullptr;
+    }
+
     /* The extra page_map length is necessary; can't just rely on vector here,
      * since the next check would be tricked because a null page also has
      * major==0, which we can't distinguish from an actually major==0 page... */
@@ -58,6 +58,10 @@ struct hb_blob_t
   template <typename Type>
   const Type* as () const { return as_bytes ().as<Type> (); }
 
+  /* Writable data is a copy made for, or handed over to, the blob. */
+  unsigned get_memory_usage () const
+  { return mode == HB_MEMORY_MODE_WRITABLE ? length : 0; }
+
   public:
   hb_object_header_t header;
 
@@ -738,7 +738,7 @@ buffer_create ()
 {
   buffer_t *buffer;
 
-  if (!(buffer = object_create<buffer_t> ()))
+  if (!(buffer = object_create_pooled<buffer_t> ()))
     return buffer_get_empty ();
 
   buffer->max_len = HB_BUFFER_MAX_LEN_DEFAULT;
@@ -846,7 +846,7 @@ buffer_destroy (buffer_t *buffer)
     buffer->message_destroy (buffer->message_data);
 #endif
 
-  free (buffer);
+  object_free_pooled (buffer);
 }
 
 /**
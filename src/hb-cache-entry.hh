@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_CACHE_ENTRY_HH
+#define HB_CACHE_ENTRY_HH
+
+#include "hb.hh"
+
+
+/* An immutable, reference-counted value for the mutex-protected caches
+ * of decoded glyph data.  A cache hands out references to its entries
+ * rather than copies: taking one under the cache lock is all a hit
+ * costs, the value is used after the lock is dropped, and the cache can
+ * drop its own reference any time. */
+template <typename Type>
+struct cache_entry_t
+{
+  /* Owning reference to an entry, or to none. */
+  struct ref_t
+  {
+    ref_t () = default;
+    explicit ref_t (cache_entry_t *entry_) : entry (entry_) {}
+    ref_t (const ref_t &o) : entry (o.entry ? o.entry->reference () : nullptr) {}
+    ref_t (ref_t &&o) : entry (o.entry) { o.entry = nullptr; }
+    ref_t& operator = (ref_t o) { std::swap (entry, o.entry); return *this; }
+    ~ref_t () { if (entry) entry->destroy (); }
+
+    explicit operator bool () const { return entry; }
+    const Type& operator * () const { return entry->value; }
+    const Type* operator -> () const { return &entry->value; }
+
+    /* Counts the entry in full, for each cache holding it. */
+    unsigned get_memory_usage () const
+    { return entry ? sizeof (*entry) + heap_size (entry->value) : 0; }
+
+    private:
+    cache_entry_t *entry = nullptr;
+  };
+
+  /* Moves value into a new entry.  On failure returns no entry and
+   * leaves value alone. */
+  static ref_t create (Type &value)
+  {
+    auto *entry = (cache_entry_t *) calloc (1, sizeof (cache_entry_t));
+    if (unlikely (!entry))
+      return ref_t ();
+    new (entry) cache_entry_t;
+    entry->value = std::move (value);
+    entry->ref_count = 1;
+    return ref_t (entry);
+  }
+
+  private:
+  cache_entry_t *reference ()
+  {
+    ref_count.inc ();
+    return this;
+  }
+
+  void destroy ()
+  {
+    if (ref_count.dec () != 1) return;
+    this->~cache_entry_t ();
+    free (this);
+  }
+
+  Type value;
+  atomic_int_t ref_count;
+};
+
+
+#endif /* HB_CACHE_ENTRY_HH */
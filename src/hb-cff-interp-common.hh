@@ -545,6 +545,8 @@ struct parsed_values_t
   unsigned get_count () const { return values.length; }
   const VAL &operator [] (unsigned int i) const { return values[i]; }
 
+  unsigned get_memory_usage () const { return values.get_memory_usage (); }
+
   unsigned int       opStart;
   hb_vector_t<VAL>   values;
 };
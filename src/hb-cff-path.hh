@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_CFF_PATH_HH
+#define HB_CFF_PATH_HH
+
+#include "hb.hh"
+
+#include "hb-cache-entry.hh"
+#include "hb-draw.hh"
+#include "hb-map.hh"
+#include "hb-mutex.hh"
+
+
+namespace CFF {
+
+
+/* A glyph charstring decoded down to the draw calls it makes: subroutines
+ * and seac resolved, hints dropped, operands converted to floats in font
+ * units.  Replaying it issues exactly the calls the interpreter would. */
+struct cs_path_t
+{
+  void move_to (float x, float y)
+  {
+    verbs.push (HB_DRAW_VERB_MOVE_TO);
+    coords.push (x); coords.push (y);
+  }
+
+  void line_to (float x, float y)
+  {
+    verbs.push (HB_DRAW_VERB_LINE_TO);
+    coords.push (x); coords.push (y);
+  }
+
+  void cubic_to (float x1, float y1,
+		 float x2, float y2,
+		 float x3, float y3)
+  {
+    verbs.push (HB_DRAW_VERB_CUBIC_TO);
+    coords.push (x1); coords.push (y1);
+    coords.push (x2); coords.push (y2);
+    coords.push (x3); coords.push (y3);
+  }
+
+  void close_path () { verbs.push (HB_DRAW_VERB_CLOSE_PATH); }
+
+  void reset ()
+  {
+    verbs.reset ();
+    coords.reset ();
+  }
+
+  bool in_error () const { return verbs.in_error () || coords.in_error (); }
+
+  unsigned get_memory_usage () const
+  { return verbs.get_memory_usage () + coords.get_memory_usage (); }
+
+  void replay (font_t *font, draw_session_t &draw_session) const
+  {
+    const float *c = coords.arrayZ;
+    for (uint8_t verb : verbs)
+    {
+      switch (verb)
+      {
+      case HB_DRAW_VERB_MOVE_TO:
+	draw_session.move_to (font->em_fscalef_x (c[0]), font->em_fscalef_y (c[1]));
+	c += 2;
+	break;
+      case HB_DRAW_VERB_LINE_TO:
+	draw_session.line_to (font->em_fscalef_x (c[0]), font->em_fscalef_y (c[1]));
+	c += 2;
+	break;
+      case HB_DRAW_VERB_CUBIC_TO:
+	draw_session.cubic_to (font->em_fscalef_x (c[0]), font->em_fscalef_y (c[1]),
+			       font->em_fscalef_x (c[2]), font->em_fscalef_y (c[3]),
+			       font->em_fscalef_x (c[4]), font->em_fscalef_y (c[5]));
+	c += 6;
+	break;
+      case HB_DRAW_VERB_CLOSE_PATH:
+	draw_session.close_path ();
+	break;
+      default:
+	return;
+      }
+    }
+  }
+
+  vector_t<uint8_t> verbs;
+  vector_t<float> coords;
+};
+
+/* Per-face cache of decoded charstrings.  Entries depend on nothing but
+ * the glyph, so they are shared by all fonts on the face; callers only
+ * store default-instance paths.  Paths are handed out as references to
+ * the cached entries, and replayed after the lock is dropped.  The whole
+ * cache is dropped when it would grow past MAX_COORDS coordinates; paths
+ * handed out stay valid. */
+struct cs_path_cache_t
+{
+  static constexpr unsigned MAX_COORDS = 1u << 16;
+
+  typedef cache_entry_t<cs_path_t>::ref_t ref_t;
+
+  ref_t get (codepoint_t gid) const
+  {
+    lock_t l (lock);
+
+    const ref_t *cached;
+    if (!glyphs.has (gid, &cached)) return ref_t ();
+    return *cached;
+  }
+
+  /* Moves path into the cache, and returns the cached path to use in its
+   * place; or nothing, leaving path alone, if it is not cached. */
+  ref_t set (codepoint_t gid, cs_path_t &path)
+  {
+    if (unlikely (path.coords.length > MAX_COORDS || path.in_error ())) return ref_t ();
+
+    lock_t l (lock);
+
+    const ref_t *cached;
+    if (glyphs.has (gid, &cached)) return *cached;
+
+    unsigned num_path_coords = path.coords.length;
+    if (num_coords + num_path_coords > MAX_COORDS)
+    {
+      glyphs.reset ();
+      num_coords = 0;
+    }
+
+    ref_t entry = cache_entry_t<cs_path_t>::create (path);
+    if (unlikely (!entry || !glyphs.set (gid, entry))) return entry;
+    num_coords += num_path_coords;
+    return entry;
+  }
+
+  unsigned get_memory_usage () const
+  {
+    lock_t l (lock);
+    return glyphs.get_memory_usage ();
+  }
+
+  protected:
+  mutable mutex_t lock; /* Protects members below. */
+  unsigned num_coords = 0;
+  hashmap_t<codepoint_t, ref_t> glyphs;
+};
+
+
+} /* namespace CFF */
+
+#endif /* HB_CFF_PATH_HH */
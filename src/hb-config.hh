@@ -67,7 +67,10 @@
 #define HB_NO_DRAW
 #define HB_NO_ERRNO
 #define HB_NO_FACE_COLLECT_UNICODES
+#define HB_NO_FACE_SHARED_TABLES
+#define HB_NO_FACE_WARM_UP
 #define HB_NO_GETENV
+#define HB_NO_GLYPH_SDF
 #define HB_NO_HINTING
 #define HB_NO_LANGUAGE_LONG
 #define HB_NO_LANGUAGE_PRIVATE_SUBTAG
@@ -76,19 +79,23 @@
 #define HB_NO_LAYOUT_RARELY_USED
 #define HB_NO_LAYOUT_UNUSED
 #define HB_NO_MATH
+#define HB_NO_MEMORY_USAGE
 #define HB_NO_META
 #define HB_NO_METRICS
 #define HB_NO_MMAP
 #define HB_NO_NAME
+#define HB_NO_OBJECT_POOL
 #define HB_NO_OPEN
 #define HB_NO_OT_FONT_GLYPH_NAMES
 #define HB_NO_OT_SHAPE_FRACTIONS
 #define HB_NO_PAINT
+#define HB_NO_SANITIZE_CACHE
 #define HB_NO_SETLOCALE
 #define HB_NO_STYLE
 #define HB_NO_SUBSET_LAYOUT
 #define HB_NO_VERTICAL
 #define HB_NO_VAR
+#define HB_NO_WOFF
 #endif
 
 #ifdef HB_MINI
@@ -151,6 +158,10 @@
 #define HB_NO_OUTLINE
 #endif
 
+#ifdef HB_NO_OUTLINE
+#define HB_NO_GLYPH_SDF
+#endif
+
 #ifdef HB_NO_GETENV
 #define HB_NO_UNISCRIBE_BUG_COMPATIBLE
 #endif
@@ -193,8 +204,14 @@
 #ifdef HB_MINIMIZE_MEMORY_USAGE
 #define HB_NO_GDEF_CACHE
 #define HB_NO_OT_LAYOUT_LOOKUP_CACHE
+#undef HB_OT_LAYOUT_EAGER_LOOKUPS
 #define HB_NO_OT_FONT_ADVANCE_CACHE
 #define HB_NO_OT_FONT_CMAP_CACHE
+#define HB_NO_OT_FONT_OUTLINE_CACHE
+#define HB_NO_OT_FONT_EXTENTS_CACHE
+#define HB_NO_OT_FONT_PAINT_CACHE
+#define HB_NO_CFF_PATH_CACHE
+#define HB_NO_OT_FONT_VARC_CACHE
 #endif
 
 #ifdef HB_OPTIMIZE_SIZE
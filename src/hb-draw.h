@@ -335,6 +335,30 @@ draw_close_path (draw_funcs_t *dfuncs, void *draw_data,
 		    draw_state_t *st);
 
 
+/**
+ * draw_verb_t:
+ * @HB_DRAW_VERB_MOVE_TO: Starts a new contour. Followed by one point.
+ * @HB_DRAW_VERB_LINE_TO: Straight line. Followed by one point.
+ * @HB_DRAW_VERB_QUADRATIC_TO: Quadratic Bézier curve. Followed by the
+ * control point and the end point.
+ * @HB_DRAW_VERB_CUBIC_TO: Cubic Bézier curve. Followed by two control
+ * points and the end point.
+ * @HB_DRAW_VERB_CLOSE_PATH: Closes the current contour. Has no points.
+ *
+ * Path operations, as stored by font_draw_glyphs(). Each verb consumes
+ * the given number of (x, y) points from the coordinates array.
+ *
+ * Since: REPLACEME
+ **/
+typedef enum {
+  HB_DRAW_VERB_MOVE_TO,
+  HB_DRAW_VERB_LINE_TO,
+  HB_DRAW_VERB_QUADRATIC_TO,
+  HB_DRAW_VERB_CUBIC_TO,
+  HB_DRAW_VERB_CLOSE_PATH
+} draw_verb_t;
+
+
 HB_END_DECLS
 
 #endif /* HB_DRAW_H */
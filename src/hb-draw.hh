@@ -166,11 +166,131 @@ struct hb_draw_funcs_t
 };
 DECLARE_NULL_INSTANCE (hb_draw_funcs_t);
 
+/* A flat verb and coordinate buffer, as filled in by font_draw_glyphs().
+ * Draw sessions can append to it directly, skipping the draw_funcs_t
+ * callbacks; it keeps path state the same way draw_funcs_t does, so the
+ * result is the same as drawing through callbacks that append.
+ *
+ * Counts keep growing past the capacities, so that callers can find out
+ * how much space they need. */
+struct draw_path_buffer_t
+{
+  HB_ALWAYS_INLINE
+  void move_to (hb_draw_state_t &st,
+		float to_x, float to_y)
+  {
+    if (unlikely (st.path_open)) close_path (st);
+    st.current_x = to_x;
+    st.current_y = to_y;
+  }
+
+  HB_ALWAYS_INLINE
+  void line_to (hb_draw_state_t &st,
+		float to_x, float to_y)
+  {
+    if (unlikely (!st.path_open)) start_path (st);
+    push_verb (HB_DRAW_VERB_LINE_TO);
+    push_point (to_x, to_y);
+    st.current_x = to_x;
+    st.current_y = to_y;
+  }
+
+  HB_ALWAYS_INLINE
+  void quadratic_to (hb_draw_state_t &st,
+		     float control_x, float control_y,
+		     float to_x, float to_y)
+  {
+    if (unlikely (!st.path_open)) start_path (st);
+    push_verb (HB_DRAW_VERB_QUADRATIC_TO);
+    push_point (control_x, control_y);
+    push_point (to_x, to_y);
+    st.current_x = to_x;
+    st.current_y = to_y;
+  }
+
+  HB_ALWAYS_INLINE
+  void cubic_to (hb_draw_state_t &st,
+		 float control1_x, float control1_y,
+		 float control2_x, float control2_y,
+		 float to_x, float to_y)
+  {
+    if (unlikely (!st.path_open)) start_path (st);
+    push_verb (HB_DRAW_VERB_CUBIC_TO);
+    push_point (control1_x, control1_y);
+    push_point (control2_x, control2_y);
+    push_point (to_x, to_y);
+    st.current_x = to_x;
+    st.current_y = to_y;
+  }
+
+  HB_ALWAYS_INLINE
+  void close_path (hb_draw_state_t &st)
+  {
+    if (likely (st.path_open))
+    {
+      if ((st.path_start_x != st.current_x) || (st.path_start_y != st.current_y))
+      {
+	push_verb (HB_DRAW_VERB_LINE_TO);
+	push_point (st.path_start_x, st.path_start_y);
+      }
+      push_verb (HB_DRAW_VERB_CLOSE_PATH);
+    }
+    st.path_open = false;
+    st.path_start_x = st.current_x = st.path_start_y = st.current_y = 0;
+  }
+
+  void push_verb (draw_verb_t verb)
+  {
+    if (likely (verb_count < verb_capacity))
+      verbs[verb_count] = verb;
+    verb_count++;
+  }
+
+  void push_point (float x, float y)
+  {
+    if (likely (coord_count + 2 <= coord_capacity))
+    {
+      coords[coord_count] = x;
+      coords[coord_count + 1] = y;
+    }
+    coord_count += 2;
+  }
+
+  protected:
+
+  void start_path (hb_draw_state_t &st)
+  {
+    assert (!st.path_open);
+    push_verb (HB_DRAW_VERB_MOVE_TO);
+    push_point (st.current_x, st.current_y);
+    st.path_open = true;
+    st.path_start_x = st.current_x;
+    st.path_start_y = st.current_y;
+  }
+
+  public:
+  uint8_t *verbs;
+  unsigned verb_capacity;
+  unsigned verb_count;
+  float *coords;
+  unsigned coord_capacity;
+  unsigned coord_count;
+};
+
 struct hb_draw_session_t
 {
   hb_draw_session_t (hb_draw_funcs_t *funcs_, void *draw_data_, float slant_ = 0.f)
     : slant {slant_}, not_slanted {slant == 0.f},
-      funcs {funcs_}, draw_data {draw_data_}, st HB_DRAW_STATE_DEFAULT
+      funcs {funcs_}, draw_data {draw_data_}, path {nullptr}, st HB_DRAW_STATE_DEFAULT
+  {}
+
+  /* Appends straight to path instead of calling draw callbacks.  Only for
+   * drawing code that uses nothing but the methods below: funcs is the
+   * empty set. */
+  hb_draw_session_t (draw_path_buffer_t *path_, float slant_ = 0.f)
+    : slant {slant_}, not_slanted {slant == 0.f},
+      funcs {const_cast<hb_draw_funcs_t *> (&Null (hb_draw_funcs_t))}, draw_data {nullptr},
+      path {path_}, st HB_DRAW_STATE_DEFAULT
   {}
 
   ~hb_draw_session_t () { close_path (); }
@@ -178,36 +298,43 @@ struct hb_draw_session_t
   HB_ALWAYS_INLINE
   void move_to (float to_x, float to_y)
   {
-    if (likely (not_slanted))
-      funcs->move_to (draw_data, st,
-		      to_x, to_y);
+    if (unlikely (!not_slanted))
+      to_x += to_y * slant;
+    if (path)
+      path->move_to (st, to_x, to_y);
     else
       funcs->move_to (draw_data, st,
-		      to_x + to_y * slant, to_y);
+		      to_x, to_y);
   }
   HB_ALWAYS_INLINE
   void line_to (float to_x, float to_y)
   {
-    if (likely (not_slanted))
-      funcs->line_to (draw_data, st,
-		      to_x, to_y);
+    if (unlikely (!not_slanted))
+      to_x += to_y * slant;
+    if (path)
+      path->line_to (st, to_x, to_y);
     else
       funcs->line_to (draw_data, st,
-		      to_x + to_y * slant, to_y);
+		      to_x, to_y);
   }
   void
   HB_ALWAYS_INLINE
   quadratic_to (float control_x, float control_y,
 		float to_x, float to_y)
   {
-    if (likely (not_slanted))
+    if (unlikely (!not_slanted))
+    {
+      control_x += control_y * slant;
+      to_x += to_y * slant;
+    }
+    if (path)
+      path->quadratic_to (st,
+			  control_x, control_y,
+			  to_x, to_y);
+    else
       funcs->quadratic_to (draw_data, st,
 			   control_x, control_y,
 			   to_x, to_y);
-    else
-      funcs->quadratic_to (draw_data, st,
-			   control_x + control_y * slant, control_y,
-			   to_x + to_y * slant, to_y);
   }
   void
   HB_ALWAYS_INLINE
@@ -215,21 +342,30 @@ struct hb_draw_session_t
 	    float control2_x, float control2_y,
 	    float to_x, float to_y)
   {
-    if (likely (not_slanted))
+    if (unlikely (!not_slanted))
+    {
+      control1_x += control1_y * slant;
+      control2_x += control2_y * slant;
+      to_x += to_y * slant;
+    }
+    if (path)
+      path->cubic_to (st,
+		      control1_x, control1_y,
+		      control2_x, control2_y,
+		      to_x, to_y);
+    else
       funcs->cubic_to (draw_data, st,
 		       control1_x, control1_y,
 		       control2_x, control2_y,
 		       to_x, to_y);
-    else
-      funcs->cubic_to (draw_data, st,
-		       control1_x + control1_y * slant, control1_y,
-		       control2_x + control2_y * slant, control2_y,
-		       to_x + to_y * slant, to_y);
   }
   HB_ALWAYS_INLINE
   void close_path ()
   {
-    funcs->close_path (draw_data, st);
+    if (path)
+      path->close_path (st);
+    else
+      funcs->close_path (draw_data, st);
   }
 
   public:
@@ -237,6 +373,7 @@ struct hb_draw_session_t
   bool not_slanted;
   hb_draw_funcs_t *funcs;
   void *draw_data;
+  draw_path_buffer_t *path;
   hb_draw_state_t st;
 };
 
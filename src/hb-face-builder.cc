@@ -91,16 +91,149 @@ _face_builder_data_destroy (void *user_data)
   free (data);
 }
 
-static blob_t *
-_face_builder_data_reference_blob (face_builder_data_t *data)
+static bool
+_face_builder_data_sorted_entries (face_builder_data_t *data,
+				   vector_t<pair_t <tag_t, face_table_info_t>> &sorted_entries /* OUT */)
 {
+  // Sort the tags so that produced face is deterministic.
+  data->tables.iter () | sink (sorted_entries);
+  if (unlikely (sorted_entries.in_error ()))
+    return false;
 
+  sorted_entries.qsort (compare_entries);
+  return true;
+}
+
+static unsigned
+_face_builder_data_length (face_builder_data_t *data)
+{
   unsigned int table_count = data->tables.get_population ();
   unsigned int face_length = table_count * 16 + 12;
 
   for (auto info : data->tables.values())
     face_length += ceil_to_4 (blob_get_length (info.data));
 
+  return face_length;
+}
+
+/* Same layout as OpenTypeOffsetTable::serialize(), but the table data is
+ * handed to the writer straight from the table blobs instead of being
+ * copied into one buffer first.  Only the directory is built in memory. */
+static bool
+_face_builder_data_write (face_builder_data_t *data,
+			  face_builder_write_func_t func,
+			  void *user_data)
+{
+  vector_t<pair_t <tag_t, face_table_info_t>> sorted_entries;
+  if (unlikely (!_face_builder_data_sorted_entries (data, sorted_entries)))
+    return false;
+
+  bool is_cff = (data->tables.has (HB_TAG ('C','F','F',' '))
+                 || data->tables.has (HB_TAG ('C','F','F','2')));
+  tag_t sfnt_tag = is_cff ? OT::OpenTypeFontFile::CFFTag : OT::OpenTypeFontFile::TrueTypeTag;
+
+  unsigned num_tables = sorted_entries.length;
+  unsigned dir_length = num_tables * 16 + 12;
+
+  vector_t<OT::TableRecord> records;
+  if (unlikely (!records.resize (num_tables)))
+    return false;
+
+  /* Lay out the tables in order and checksum them. */
+  constexpr unsigned checksum_adjustment_offset = 8;
+  int head_index = -1;
+  uint64_t offset = dir_length;
+  for (unsigned i = 0; i < num_tables; i++)
+  {
+    const blob_t *blob = sorted_entries.arrayZ[i].second.data;
+    unsigned len = blob->length;
+    if (unlikely (offset > 0xFFFFFFFFu))
+      return false;
+
+    OT::TableRecord &rec = records.arrayZ[i];
+    rec.tag = sorted_entries.arrayZ[i].first;
+    rec.offset = (unsigned) offset;
+    rec.length = len;
+
+    /* Checksum as if padded with zeros to 4 bytes. */
+    unsigned whole = len & ~3u;
+    uint32_t sum = OT::CheckSum::CalcTableChecksum ((const OT::HBUINT32 *) blob->data, whole);
+    if (whole != len)
+    {
+      OT::HBUINT32 tail;
+      tail = 0;
+      memcpy (&tail, blob->data + whole, len - whole);
+      sum += tail;
+    }
+
+    if (rec.tag == HB_OT_TAG_head && len >= OT::head::static_size)
+    {
+      /* checkSumAdjustment is summed as zero. */
+      head_index = i;
+      sum -= * (const OT::HBUINT32 *) (blob->data + checksum_adjustment_offset);
+    }
+    rec.checkSum = sum;
+
+    offset += ceil_to_4 (len);
+  }
+
+  vector_t<char> dir;
+  if (unlikely (!dir.resize (dir_length)))
+    return false;
+
+  serialize_context_t c (dir.arrayZ, dir_length);
+  OT::OpenTypeFontFace *face = c.start_serialize<OT::OpenTypeFontFace> ();
+  bool ret = face->serialize_directory (&c, sfnt_tag, records.as_array ());
+  c.end_serialize ();
+  if (unlikely (!ret || c.in_error ()))
+    return false;
+
+  OT::HBUINT32 checksum_adjustment;
+  checksum_adjustment = 0;
+  if (head_index >= 0)
+  {
+    OT::CheckSum checksum;
+    checksum.set_for_data (dir.arrayZ, dir_length);
+    for (const OT::TableRecord &rec : records)
+      checksum = checksum + rec.checkSum;
+    checksum_adjustment = 0xB1B0AFBAu - checksum;
+  }
+
+  if (unlikely (!func (dir.arrayZ, dir_length, user_data)))
+    return false;
+
+  static const char padding[4] = {0};
+  for (unsigned i = 0; i < num_tables; i++)
+  {
+    const blob_t *blob = sorted_entries.arrayZ[i].second.data;
+    unsigned len = blob->length;
+
+    if ((int) i == head_index)
+    {
+      /* The table blob is shared; patch checkSumAdjustment on the way out. */
+      const unsigned after = checksum_adjustment_offset + 4;
+      if (unlikely (!func (blob->data, checksum_adjustment_offset, user_data) ||
+		    !func ((const char *) &checksum_adjustment, 4, user_data) ||
+		    !func (blob->data + after, len - after, user_data)))
+	return false;
+    }
+    else if (len && unlikely (!func (blob->data, len, user_data)))
+      return false;
+
+    unsigned pad = ceil_to_4 (len) - len;
+    if (pad && unlikely (!func (padding, pad, user_data)))
+      return false;
+  }
+
+  return true;
+}
+
+static blob_t *
+_face_builder_data_reference_blob (face_builder_data_t *data)
+{
+
+  unsigned int face_length = _face_builder_data_length (data);
+
   char *buf = (char *) malloc (face_length);
   if (unlikely (!buf))
     return nullptr;
@@ -113,17 +246,13 @@ _face_builder_data_reference_blob (face_builder_data_t *data)
                  || data->tables.has (HB_TAG ('C','F','F','2')));
   tag_t sfnt_tag = is_cff ? OT::OpenTypeFontFile::CFFTag : OT::OpenTypeFontFile::TrueTypeTag;
 
-  // Sort the tags so that produced face is deterministic.
   vector_t<pair_t <tag_t, face_table_info_t>> sorted_entries;
-  data->tables.iter () | sink (sorted_entries);
-  if (unlikely (sorted_entries.in_error ()))
+  if (unlikely (!_face_builder_data_sorted_entries (data, sorted_entries)))
   {
     free (buf);
     return nullptr;
   }
 
-  sorted_entries.qsort (compare_entries);
-
   bool ret = f->serialize_single (&c,
                                   sfnt_tag,
                                   + sorted_entries.iter()
@@ -244,3 +373,61 @@ face_builder_sort_tables (face_t *face,
     info->order = order++;
   }
 }
+
+/**
+ * face_builder_get_length:
+ * @face: A face object created with face_builder_create()
+ *
+ * Fetches the size of the font file that face_builder_write() would
+ * produce for @face, for example to preallocate an output buffer.
+ *
+ * Return value: Length of the font file in bytes, or 0 if @face is not
+ * a face builder.
+ *
+ * Since: REPLACEME
+ **/
+unsigned int
+face_builder_get_length (face_t *face)
+{
+  if (unlikely (face->destroy != (destroy_func_t) _face_builder_data_destroy))
+    return 0;
+
+  face_builder_data_t *data = (face_builder_data_t *) face->user_data;
+  return _face_builder_data_length (data);
+}
+
+/**
+ * face_builder_write:
+ * @face: A face object created with face_builder_create()
+ * @func: (scope call): function that receives the font data
+ * @user_data: data to pass to @func
+ *
+ * Writes the font file for @face to @func, in order, in as many pieces
+ * as there are tables. Unlike face_reference_blob(), this does not
+ * assemble the font into one contiguous buffer first, so no copy of the
+ * whole font is made. The face returned by subset_or_fail() is a face
+ * builder, so this can stream a subset out directly.
+ *
+ * The output is identical to the blob face_reference_blob() would
+ * return.
+ *
+ * Return value: `true` if all the data was written successfully,
+ * `false` if @face is not a face builder, on allocation failure, or if
+ * @func returned `false`.
+ *
+ * Since: REPLACEME
+ **/
+bool_t
+face_builder_write (face_t *face,
+		    face_builder_write_func_t func,
+		    void *user_data)
+{
+  if (unlikely (face->destroy != (destroy_func_t) _face_builder_data_destroy))
+    return false;
+
+  face_builder_data_t *data = (face_builder_data_t *) face->user_data;
+  if (unlikely (data->tables.in_error ()))
+    return false;
+
+  return _face_builder_data_write (data, func, user_data);
+}
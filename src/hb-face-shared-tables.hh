@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_FACE_SHARED_TABLES_HH
+#define HB_FACE_SHARED_TABLES_HH
+
+#include "hb.hh"
+
+#include "hb-blob.hh"
+#include "hb-map.hh"
+#include "hb-mutex.hh"
+
+
+/* Tables and accelerators shared by the faces of one font collection file.
+ *
+ * Collections store tables that several faces use once, and such tables
+ * show up at the same place in the file blob for all of them.  Entries
+ * are keyed by that place, so a table is sanitized, and its accelerator
+ * built, once for all the faces that share it.  Tables are only shared
+ * between faces that agree on the glyph count they get sanitized against.
+ *
+ * The object is reference-counted by the faces using it; shared
+ * accelerators are destroyed with it, after the last of those faces is. */
+struct face_shared_tables_t
+{
+  struct key_t
+  {
+    const char *data;	/* Start of the table in the file blob. */
+    unsigned length;
+    tag_t tag;
+    unsigned num_glyphs;
+    bool lazy;		/* Sanitized with lazy_some_gpos. */
+
+    uint32_t hash () const
+    {
+      uint32_t h = ::hash ((uintptr_t) data);
+      h = h * 31u + length;
+      h = h * 31u + tag;
+      h = h * 31u + num_glyphs;
+      return h * 31u + lazy;
+    }
+    bool operator == (const key_t &o) const
+    {
+      return data == o.data &&
+	     length == o.length &&
+	     tag == o.tag &&
+	     num_glyphs == o.num_glyphs &&
+	     lazy == o.lazy;
+    }
+  };
+
+  struct accelerator_t
+  {
+    void *p;
+    void (*destroy) (void *);
+  };
+
+  static face_shared_tables_t *create ()
+  {
+    auto *shared = (face_shared_tables_t *) calloc (1, sizeof (face_shared_tables_t));
+    if (unlikely (!shared))
+      return nullptr;
+    new (shared) face_shared_tables_t;
+    shared->ref_count = 1;
+    return shared;
+  }
+
+  face_shared_tables_t *reference ()
+  {
+    ref_count.inc ();
+    return this;
+  }
+
+  void destroy ()
+  {
+    if (ref_count.dec () != 1) return;
+
+    for (blob_t *blob : tables.values ())
+      blob_destroy (blob);
+    for (const accelerator_t &accel : accelerators.values ())
+      accel.destroy (accel.p);
+
+    this->~face_shared_tables_t ();
+    free (this);
+  }
+
+  /* Returns a reference to the sanitized table stored for key, or nullptr. */
+  blob_t *reference_table (const key_t &key) const
+  {
+    lock_t l (lock);
+    blob_t **blob;
+    if (!tables.has (key, &blob)) return nullptr;
+    return blob_reference (*blob);
+  }
+
+  /* Stores blob, a sanitized table, for key; takes ownership of blob.
+   * Returns a reference to the table to use, which is the one stored
+   * first if another face got there before. */
+  blob_t *set_table (const key_t &key, blob_t *blob)
+  {
+    blob_t *ret;
+    {
+      lock_t l (lock);
+      blob_t **stored;
+      if (!tables.has (key, &stored))
+      {
+	if (unlikely (!tables.set (key, blob)))
+	  return blob;
+	return blob_reference (blob);
+      }
+      ret = blob_reference (*stored);
+    }
+    blob_destroy (blob);
+    return ret;
+  }
+
+  /* Returns the accelerator stored for key, creating it with create if
+   * there is none.  The accelerator stays owned by this object. */
+  void *get_accelerator (const key_t &key,
+			 face_t *face,
+			 void *(*create) (face_t *),
+			 void (*destroy_func) (void *))
+  {
+    {
+      lock_t l (lock);
+      const accelerator_t *stored;
+      if (accelerators.has (key, &stored)) return stored->p;
+    }
+
+    /* Built unlocked: building it references tables, which goes through
+     * this object again. */
+    void *p = create (face);
+    if (unlikely (!p)) return nullptr;
+
+    void *ret = nullptr;
+    {
+      lock_t l (lock);
+      const accelerator_t *stored;
+      if (accelerators.has (key, &stored))
+	ret = stored->p;
+      else if (likely (accelerators.set (key, accelerator_t {p, destroy_func})))
+	return p;
+    }
+    /* Lost the race, or could not store it. */
+    destroy_func (p);
+    return ret;
+  }
+
+  protected:
+  atomic_int_t ref_count;
+  mutable mutex_t lock; /* Protects members below. */
+  hashmap_t<key_t, blob_t *> tables;
+  hashmap_t<key_t, accelerator_t> accelerators;
+};
+
+
+#endif /* HB_FACE_SHARED_TABLES_HH */
@@ -0,0 +1,253 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "hb.hh"
+
+#ifndef HB_NO_FACE_WARM_UP
+
+#include "hb-face.hh"
+
+#include "hb-ot-face.hh"
+#include "hb-ot-cmap-table.hh"
+#include "hb-ot-glyf-table.hh"
+#include "hb-ot-cff1-table.hh"
+#include "hb-ot-cff2-table.hh"
+#include "hb-ot-hhea-table.hh"
+#include "hb-ot-hmtx-table.hh"
+#include "hb-ot-os2-table.hh"
+#include "hb-ot-vorg-table.hh"
+#include "hb-ot-kern-table.hh"
+#include "hb-ot-layout-gdef-table.hh"
+#include "hb-ot-layout-gsub-table.hh"
+#include "hb-ot-layout-gpos-table.hh"
+#include "hb-aat-layout-kerx-table.hh"
+#include "hb-aat-layout-morx-table.hh"
+#include "hb-aat-layout-trak-table.hh"
+#include "hb-ot-var-avar-table.hh"
+#include "hb-ot-var-fvar-table.hh"
+#include "hb-ot-var-gvar-table.hh"
+#include "hb-ot-var-mvar-table.hh"
+#include "hb-ot-var-varc-table.hh"
+#include "hb-thread-pool.hh"
+
+
+/*
+ * Warm-up tasks.
+ *
+ * Each task loads one lazily-created piece of face data.  All of those
+ * are published with compare-and-exchange, so any number of threads can
+ * race on them; the loser just throws its copy away.
+ */
+
+struct warm_up_task_t
+{
+  void (*func) (face_t *face, unsigned index);
+  unsigned index;
+};
+
+struct warm_up_context_t
+{
+  face_t *face;
+  vector_t<warm_up_task_t> tasks;
+
+  void add (void (*func) (face_t *, unsigned), unsigned index = 0)
+  { tasks.push (warm_up_task_t {func, index}); }
+
+  /* Runs all tasks on up to num_threads threads, the calling one
+   * included, and returns when they are done. */
+  void run (unsigned num_threads)
+  {
+    parallel_for (num_threads, tasks.length,
+		  [this] (unsigned i)
+		  { tasks.arrayZ[i].func (face, tasks.arrayZ[i].index); });
+    tasks.reset ();
+  }
+};
+
+#define HB_FACE_WARM_UP_TABLE(Type) \
+  static void _warm_up_##Type (face_t *face, unsigned) { face->table.Type.get_stored (); }
+
+#if !defined(HB_NO_FACE_COLLECT_UNICODES) || !defined(HB_NO_OT_FONT)
+HB_FACE_WARM_UP_TABLE (cmap)
+#endif
+HB_FACE_WARM_UP_TABLE (hhea)
+HB_FACE_WARM_UP_TABLE (hmtx)
+HB_FACE_WARM_UP_TABLE (OS2)
+#ifndef HB_NO_VERTICAL
+HB_FACE_WARM_UP_TABLE (vhea)
+HB_FACE_WARM_UP_TABLE (vmtx)
+HB_FACE_WARM_UP_TABLE (VORG)
+#endif
+HB_FACE_WARM_UP_TABLE (glyf)
+#ifndef HB_NO_CFF
+HB_FACE_WARM_UP_TABLE (cff1)
+HB_FACE_WARM_UP_TABLE (cff2)
+#endif
+#ifndef HB_NO_VAR
+HB_FACE_WARM_UP_TABLE (fvar)
+HB_FACE_WARM_UP_TABLE (avar)
+HB_FACE_WARM_UP_TABLE (gvar)
+HB_FACE_WARM_UP_TABLE (MVAR)
+#ifndef HB_NO_VAR_COMPOSITES
+HB_FACE_WARM_UP_TABLE (VARC)
+#endif
+#endif
+#ifndef HB_NO_OT_KERN
+HB_FACE_WARM_UP_TABLE (kern)
+#endif
+#ifndef HB_NO_OT_LAYOUT
+HB_FACE_WARM_UP_TABLE (GDEF)
+HB_FACE_WARM_UP_TABLE (GSUB)
+HB_FACE_WARM_UP_TABLE (GPOS)
+#endif
+#ifndef HB_NO_AAT
+HB_FACE_WARM_UP_TABLE (morx)
+HB_FACE_WARM_UP_TABLE (mort)
+HB_FACE_WARM_UP_TABLE (kerx)
+HB_FACE_WARM_UP_TABLE (trak)
+#endif
+
+#undef HB_FACE_WARM_UP_TABLE
+
+#ifndef HB_NO_OT_LAYOUT
+static void _warm_up_GSUB_lookup (face_t *face, unsigned index) { face->table.GSUB->get_accel (index); }
+static void _warm_up_GPOS_lookup (face_t *face, unsigned index) { face->table.GPOS->get_accel (index); }
+#endif
+
+#endif
+
+
+/**
+ * face_warm_up:
+ * @face: A face object
+ * @flags: The face data to load, as #face_warm_up_flags_t
+ * @threads: The maximum number of threads to use, including the
+ * calling one
+ *
+ * Loads face data that is otherwise loaded on first use, so that later
+ * shaping and font calls do not have to.  Tables selected by @flags are
+ * sanitized and their accelerators built, spreading the work over up
+ * to @threads threads where threads are available.
+ *
+ * This is meant to be called from a background thread when a face is
+ * registered, to keep the first shaping call on the face from paying for
+ * its setup.  Calling it is never needed for correctness; the face can
+ * be used from other threads while it runs.
+ *
+ * This function returns when all the selected data is loaded.  Pass 1
+ * or 0 for @threads to do all the work on the calling thread.
+ *
+ * Since: REPLACEME
+ **/
+void
+face_warm_up (face_t               *face,
+	      face_warm_up_flags_t  flags,
+	      unsigned int          threads)
+{
+#ifndef HB_NO_FACE_WARM_UP
+  /* Table sanitizing needs these; load them once, up front. */
+  face->get_num_glyphs ();
+  face->get_upem ();
+
+  warm_up_context_t c;
+  c.face = face;
+
+  if (flags & HB_FACE_WARM_UP_FLAG_CMAP)
+  {
+#if !defined(HB_NO_FACE_COLLECT_UNICODES) || !defined(HB_NO_OT_FONT)
+    c.add (_warm_up_cmap);
+#endif
+  }
+
+  if (flags & HB_FACE_WARM_UP_FLAG_METRICS)
+  {
+    c.add (_warm_up_hhea);
+    c.add (_warm_up_hmtx);
+    c.add (_warm_up_OS2);
+#ifndef HB_NO_VERTICAL
+    c.add (_warm_up_vhea);
+    c.add (_warm_up_vmtx);
+    c.add (_warm_up_VORG);
+#endif
+#ifndef HB_NO_VAR
+    c.add (_warm_up_fvar);
+    c.add (_warm_up_avar);
+    c.add (_warm_up_MVAR);
+#endif
+  }
+
+  if (flags & (HB_FACE_WARM_UP_FLAG_LAYOUT | HB_FACE_WARM_UP_FLAG_LAYOUT_LOOKUPS))
+  {
+#ifndef HB_NO_OT_LAYOUT
+    c.add (_warm_up_GDEF);
+    c.add (_warm_up_GSUB);
+    c.add (_warm_up_GPOS);
+#endif
+#ifndef HB_NO_OT_KERN
+    c.add (_warm_up_kern);
+#endif
+#ifndef HB_NO_AAT
+    c.add (_warm_up_morx);
+    c.add (_warm_up_mort);
+    c.add (_warm_up_kerx);
+    c.add (_warm_up_trak);
+#endif
+  }
+
+  if (flags & HB_FACE_WARM_UP_FLAG_OUTLINES)
+  {
+    c.add (_warm_up_glyf);
+#ifndef HB_NO_CFF
+    c.add (_warm_up_cff1);
+    c.add (_warm_up_cff2);
+#endif
+#ifndef HB_NO_VAR
+    c.add (_warm_up_gvar);
+#ifndef HB_NO_VAR_COMPOSITES
+    c.add (_warm_up_VARC);
+#endif
+#endif
+  }
+
+  if (unlikely (c.tasks.in_error ())) return;
+  c.run (threads);
+
+  /* Lookup accelerators come second, once the lookup counts are known.
+   * There are usually many more lookups than threads, and the larger
+   * ones take the longest to build, so this is where threads help most. */
+#ifndef HB_NO_OT_LAYOUT
+  if (flags & HB_FACE_WARM_UP_FLAG_LAYOUT_LOOKUPS)
+  {
+    unsigned gsub_count = face->table.GSUB->lookup_count;
+    unsigned gpos_count = face->table.GPOS->lookup_count;
+    if (unlikely (!c.tasks.alloc (gsub_count + gpos_count))) return;
+    for (unsigned i = 0; i < gsub_count; i++)
+      c.add (_warm_up_GSUB_lookup, i);
+    for (unsigned i = 0; i < gpos_count; i++)
+      c.add (_warm_up_GPOS_lookup, i);
+    c.run (threads);
+  }
+#endif
+#endif
+}
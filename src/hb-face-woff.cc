@@ -0,0 +1,1110 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "hb.hh"
+
+#ifndef HB_NO_WOFF
+
+#include "hb-face.hh"
+#include "hb-mutex.hh"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+
+
+/*
+ * WOFF and WOFF2 faces.
+ *
+ * https://www.w3.org/TR/WOFF/
+ * https://www.w3.org/TR/WOFF2/
+ *
+ * Tables are decoded on first use, one at a time.  WOFF compresses each
+ * table on its own, so a table costs just its own inflating.  WOFF2
+ * compresses all tables as one stream, which is decompressed only as far
+ * as the tables asked for so far reach.  Its buffer is allocated once, at
+ * its full size, but only the pages decompressed into get touched; tables
+ * stored as is are sub-blobs of it, and transformed glyf, loca and hmtx
+ * tables are rebuilt from it into buffers of their own.
+ */
+
+/* Big-endian reader over a byte range. */
+struct woff_reader_t
+{
+  woff_reader_t (const char *data, unsigned length) :
+    p ((const uint8_t *) data), end ((const uint8_t *) data + length) {}
+
+  unsigned remaining () const { return end - p; }
+
+  bool read_bytes (unsigned n, const char **bytes)
+  {
+    if (unlikely (n > remaining ())) return false;
+    *bytes = (const char *) p;
+    p += n;
+    return true;
+  }
+
+  bool skip (unsigned n)
+  {
+    const char *bytes;
+    return read_bytes (n, &bytes);
+  }
+
+  bool read_u8 (unsigned *v)
+  {
+    if (unlikely (remaining () < 1)) return false;
+    *v = p[0];
+    p += 1;
+    return true;
+  }
+
+  bool read_u16 (unsigned *v)
+  {
+    if (unlikely (remaining () < 2)) return false;
+    *v = (p[0] << 8) | p[1];
+    p += 2;
+    return true;
+  }
+
+  bool read_s16 (int *v)
+  {
+    unsigned u;
+    if (unlikely (!read_u16 (&u))) return false;
+    *v = (int16_t) u;
+    return true;
+  }
+
+  bool read_u32 (unsigned *v)
+  {
+    if (unlikely (remaining () < 4)) return false;
+    *v = ((unsigned) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    p += 4;
+    return true;
+  }
+
+  /* WOFF2 UIntBase128. */
+  bool read_base128 (unsigned *v)
+  {
+    unsigned accum = 0;
+    for (unsigned i = 0; i < 5; i++)
+    {
+      unsigned byte;
+      if (unlikely (!read_u8 (&byte))) return false;
+      /* No leading zeros, and no overflow. */
+      if (unlikely ((i == 0 && byte == 0x80) || (accum & 0xFE000000u))) return false;
+      accum = (accum << 7) | (byte & 0x7F);
+      if (!(byte & 0x80))
+      {
+	*v = accum;
+	return true;
+      }
+    }
+    return false;
+  }
+
+  /* WOFF2 255UInt16. */
+  bool read_255_u16 (unsigned *v)
+  {
+    unsigned code;
+    if (unlikely (!read_u8 (&code))) return false;
+    switch (code)
+    {
+    case 253: return read_u16 (v);
+    case 254: if (unlikely (!read_u8 (v))) return false; *v += 253 * 2; return true;
+    case 255: if (unlikely (!read_u8 (v))) return false; *v += 253; return true;
+    default: *v = code; return true;
+    }
+  }
+
+  const uint8_t *p;
+  const uint8_t *end;
+};
+
+static inline void
+_woff_push_u16 (vector_t<char> &out, unsigned v)
+{
+  out.push ((char) (v >> 8));
+  out.push ((char) v);
+}
+
+static inline void
+_woff_push_u32 (vector_t<char> &out, unsigned v)
+{
+  _woff_push_u16 (out, v >> 16);
+  _woff_push_u16 (out, v);
+}
+
+static inline void
+_woff_push_bytes (vector_t<char> &out, const char *bytes, unsigned n)
+{
+  if (unlikely (!out.alloc (out.length + n))) return;
+  memcpy (out.arrayZ + out.length, bytes, n);
+  out.length += n;
+}
+
+
+/*
+ * WOFF2 glyf and loca reconstruction.
+ */
+
+struct woff2_glyf_t
+{
+  unsigned num_glyphs;
+  unsigned index_format;
+  vector_t<char> glyf;
+  vector_t<char> loca;
+  vector_t<int16_t> x_mins;	/* For hmtx reconstruction. */
+};
+
+/* Decodes one point delta of a simple glyph, as per the WOFF2 triplet
+ * encoding. */
+static bool
+_woff2_decode_triplet (unsigned flag, woff_reader_t &glyph_stream,
+		       int *dx, int *dy)
+{
+  auto with_sign = [] (unsigned flag, int base) { return (flag & 1) ? base : -base; };
+
+  const char *bytes;
+  unsigned n = flag < 84 ? 1 : flag < 120 ? 2 : flag < 124 ? 3 : 4;
+  if (unlikely (!glyph_stream.read_bytes (n, &bytes))) return false;
+  const uint8_t *in = (const uint8_t *) bytes;
+
+  if (flag < 10)
+  {
+    *dx = 0;
+    *dy = with_sign (flag, ((flag & 14) << 7) + in[0]);
+  }
+  else if (flag < 20)
+  {
+    *dx = with_sign (flag, (((flag - 10) & 14) << 7) + in[0]);
+    *dy = 0;
+  }
+  else if (flag < 84)
+  {
+    unsigned b0 = flag - 20;
+    unsigned b1 = in[0];
+    *dx = with_sign (flag, 1 + (b0 & 0x30) + (b1 >> 4));
+    *dy = with_sign (flag >> 1, 1 + ((b0 & 0x0C) << 2) + (b1 & 0x0F));
+  }
+  else if (flag < 120)
+  {
+    unsigned b0 = flag - 84;
+    *dx = with_sign (flag, 1 + ((b0 / 12) << 8) + in[0]);
+    *dy = with_sign (flag >> 1, 1 + (((b0 % 12) >> 2) << 8) + in[1]);
+  }
+  else if (flag < 124)
+  {
+    *dx = with_sign (flag, (in[0] << 4) + (in[1] >> 4));
+    *dy = with_sign (flag >> 1, ((in[1] & 0x0F) << 8) + in[2]);
+  }
+  else
+  {
+    *dx = with_sign (flag, (in[0] << 8) + in[1]);
+    *dy = with_sign (flag >> 1, (in[2] << 8) + in[3]);
+  }
+  return true;
+}
+
+/* Writes out the flags and coordinates of a simple glyph, as deltas. */
+static void
+_woff2_encode_points (vector_t<char> &out,
+		      const vector_t<int> &xs, const vector_t<int> &ys,
+		      const vector_t<uint8_t> &on_curve,
+		      bool overlap)
+{
+  enum {
+    ON_CURVE	= 0x01,
+    X_SHORT	= 0x02,
+    Y_SHORT	= 0x04,
+    REPEAT	= 0x08,
+    X_SAME	= 0x10, /* Or positive, if short. */
+    Y_SAME	= 0x20, /* Or positive, if short. */
+    OVERLAP	= 0x40,
+  };
+
+  unsigned count = xs.length;
+
+  /* Flags, run-length encoded. */
+  unsigned last_flag = (unsigned) -1;
+  unsigned repeat = 0;
+  int x = 0, y = 0;
+  for (unsigned i = 0; i < count; i++)
+  {
+    if (unlikely (out.in_error ())) return;
+
+    int dx = xs.arrayZ[i] - x; x = xs.arrayZ[i];
+    int dy = ys.arrayZ[i] - y; y = ys.arrayZ[i];
+
+    unsigned flag = on_curve.arrayZ[i] ? ON_CURVE : 0;
+    if (i == 0 && overlap) flag |= OVERLAP;
+    if (dx == 0) flag |= X_SAME;
+    else if (-255 <= dx && dx <= 255) flag |= X_SHORT | (dx > 0 ? X_SAME : 0);
+    if (dy == 0) flag |= Y_SAME;
+    else if (-255 <= dy && dy <= 255) flag |= Y_SHORT | (dy > 0 ? Y_SAME : 0);
+
+    if (flag == last_flag && repeat < 255)
+    {
+      if (!repeat)
+	out.arrayZ[out.length - 1] |= REPEAT;
+      else
+	out.pop ();
+      repeat++;
+      out.push ((char) repeat);
+      continue;
+    }
+
+    out.push ((char) flag);
+    last_flag = flag;
+    repeat = 0;
+  }
+
+  /* X coordinates, then Y coordinates. */
+  for (unsigned pass = 0; pass < 2; pass++)
+  {
+    const vector_t<int> &coords = pass ? ys : xs;
+    int last = 0;
+    for (unsigned i = 0; i < count; i++)
+    {
+      int d = coords.arrayZ[i] - last;
+      last = coords.arrayZ[i];
+      if (d == 0) continue;
+      if (-255 <= d && d <= 255)
+	out.push ((char) (d > 0 ? d : -d));
+      else
+	_woff_push_u16 (out, (unsigned) d & 0xFFFFu);
+    }
+  }
+}
+
+/* Rebuilds glyf and loca from the WOFF2 transformed glyf table. */
+static bool
+_woff2_reconstruct_glyf (const char *data, unsigned length, woff2_glyf_t &out)
+{
+  woff_reader_t r (data, length);
+
+  unsigned reserved, option_flags, num_glyphs, index_format;
+  unsigned stream_sizes[7];
+  if (unlikely (!r.read_u16 (&reserved) ||
+		!r.read_u16 (&option_flags) ||
+		!r.read_u16 (&num_glyphs) ||
+		!r.read_u16 (&index_format)))
+    return false;
+  for (unsigned i = 0; i < ARRAY_LENGTH (stream_sizes); i++)
+    if (unlikely (!r.read_u32 (&stream_sizes[i])))
+      return false;
+
+  const char *streams[7];
+  for (unsigned i = 0; i < ARRAY_LENGTH (streams); i++)
+    if (unlikely (!r.read_bytes (stream_sizes[i], &streams[i])))
+      return false;
+
+  woff_reader_t n_contour_stream (streams[0], stream_sizes[0]);
+  woff_reader_t n_points_stream (streams[1], stream_sizes[1]);
+  woff_reader_t flag_stream (streams[2], stream_sizes[2]);
+  woff_reader_t glyph_stream (streams[3], stream_sizes[3]);
+  woff_reader_t composite_stream (streams[4], stream_sizes[4]);
+  woff_reader_t bbox_stream (streams[5], stream_sizes[5]);
+  woff_reader_t instruction_stream (streams[6], stream_sizes[6]);
+
+  const char *bbox_bitmap;
+  if (unlikely (!bbox_stream.read_bytes (4 * ((num_glyphs + 31) / 32), &bbox_bitmap)))
+    return false;
+
+  const char *overlap_bitmap = nullptr;
+  if ((option_flags & 1) &&
+      unlikely (!r.read_bytes ((num_glyphs + 7) / 8, &overlap_bitmap)))
+    return false;
+
+  out.num_glyphs = num_glyphs;
+  out.index_format = index_format;
+  out.glyf.reset ();
+  out.loca.reset ();
+  if (unlikely (!out.x_mins.resize_exact (num_glyphs) ||
+		!out.loca.alloc ((num_glyphs + 1) * (index_format ? 4 : 2), true)))
+    return false;
+
+  vector_t<int> xs, ys;
+  vector_t<uint8_t> on_curve;
+  for (unsigned gid = 0; gid < num_glyphs; gid++)
+  {
+    unsigned offset = out.glyf.length;
+    if (index_format)
+      _woff_push_u32 (out.loca, offset);
+    else
+      _woff_push_u16 (out.loca, offset / 2);
+
+    int n_contours;
+    if (unlikely (!n_contour_stream.read_s16 (&n_contours))) return false;
+    bool has_bbox = bbox_bitmap[gid >> 3] & (0x80 >> (gid & 7));
+
+    int bbox[4] = {0, 0, 0, 0};
+    if (has_bbox)
+      for (unsigned i = 0; i < 4; i++)
+	if (unlikely (!bbox_stream.read_s16 (&bbox[i])))
+	  return false;
+
+    if (n_contours == 0)
+    {
+      /* Empty glyph. */
+      if (unlikely (has_bbox)) return false;
+      out.x_mins.arrayZ[gid] = 0;
+      continue;
+    }
+    else if (n_contours == -1)
+    {
+      /* Composite glyph; components are stored as is. */
+      if (unlikely (!has_bbox)) return false;
+
+      const char *components = (const char *) composite_stream.p;
+      bool have_instructions = false;
+      unsigned flags;
+      do
+      {
+	enum {
+	  ARG_1_AND_2_ARE_WORDS	= 0x0001,
+	  WE_HAVE_A_SCALE	= 0x0008,
+	  MORE_COMPONENTS	= 0x0020,
+	  WE_HAVE_AN_X_AND_Y_SCALE = 0x0040,
+	  WE_HAVE_A_TWO_BY_TWO	= 0x0080,
+	  WE_HAVE_INSTRUCTIONS	= 0x0100,
+	};
+	if (unlikely (!composite_stream.read_u16 (&flags))) return false;
+	unsigned size = 2 + ((flags & ARG_1_AND_2_ARE_WORDS) ? 4 : 2);
+	if (flags & WE_HAVE_A_SCALE) size += 2;
+	else if (flags & WE_HAVE_AN_X_AND_Y_SCALE) size += 4;
+	else if (flags & WE_HAVE_A_TWO_BY_TWO) size += 8;
+	if (unlikely (!composite_stream.skip (size))) return false;
+	have_instructions |= (bool) (flags & WE_HAVE_INSTRUCTIONS);
+	if (!(flags & MORE_COMPONENTS)) break;
+      } while (true);
+      unsigned components_size = (const char *) composite_stream.p - components;
+
+      unsigned instructions_length = 0;
+      const char *instructions = nullptr;
+      if (have_instructions &&
+	  unlikely (!glyph_stream.read_255_u16 (&instructions_length) ||
+		    !instruction_stream.read_bytes (instructions_length, &instructions)))
+	return false;
+
+      _woff_push_u16 (out.glyf, 0xFFFFu);
+      for (unsigned i = 0; i < 4; i++)
+	_woff_push_u16 (out.glyf, (unsigned) bbox[i] & 0xFFFFu);
+      _woff_push_bytes (out.glyf, components, components_size);
+      if (have_instructions)
+      {
+	_woff_push_u16 (out.glyf, instructions_length);
+	_woff_push_bytes (out.glyf, instructions, instructions_length);
+      }
+    }
+    else if (n_contours > 0)
+    {
+      /* Simple glyph. */
+      _woff_push_u16 (out.glyf, (unsigned) n_contours);
+      unsigned bbox_offset = out.glyf.length;
+      for (unsigned i = 0; i < 4; i++)
+	_woff_push_u16 (out.glyf, (unsigned) bbox[i] & 0xFFFFu);
+
+      unsigned num_points = 0;
+      for (int i = 0; i < n_contours; i++)
+      {
+	unsigned n;
+	if (unlikely (!n_points_stream.read_255_u16 (&n))) return false;
+	num_points += n;
+	if (unlikely (!num_points || num_points > 0xFFFFu)) return false;
+	_woff_push_u16 (out.glyf, num_points - 1);
+      }
+
+      xs.reset ();
+      ys.reset ();
+      on_curve.reset ();
+      if (unlikely (!xs.alloc (num_points) || !ys.alloc (num_points) || !on_curve.alloc (num_points)))
+	return false;
+      int x = 0, y = 0;
+      for (unsigned i = 0; i < num_points; i++)
+      {
+	unsigned flag;
+	if (unlikely (!flag_stream.read_u8 (&flag))) return false;
+	int dx, dy;
+	if (unlikely (!_woff2_decode_triplet (flag & 0x7F, glyph_stream, &dx, &dy))) return false;
+	x += dx;
+	y += dy;
+	xs.push (x);
+	ys.push (y);
+	on_curve.push (!(flag & 0x80));
+      }
+
+      unsigned instructions_length;
+      const char *instructions;
+      if (unlikely (!glyph_stream.read_255_u16 (&instructions_length) ||
+		    !instruction_stream.read_bytes (instructions_length, &instructions)))
+	return false;
+      _woff_push_u16 (out.glyf, instructions_length);
+      _woff_push_bytes (out.glyf, instructions, instructions_length);
+
+      bool overlap = overlap_bitmap && (overlap_bitmap[gid >> 3] & (0x80 >> (gid & 7)));
+      _woff2_encode_points (out.glyf, xs, ys, on_curve, overlap);
+
+      if (!has_bbox)
+      {
+	bbox[0] = bbox[2] = xs.arrayZ[0];
+	bbox[1] = bbox[3] = ys.arrayZ[0];
+	for (unsigned i = 1; i < num_points; i++)
+	{
+	  bbox[0] = min (bbox[0], xs.arrayZ[i]);
+	  bbox[1] = min (bbox[1], ys.arrayZ[i]);
+	  bbox[2] = max (bbox[2], xs.arrayZ[i]);
+	  bbox[3] = max (bbox[3], ys.arrayZ[i]);
+	}
+	if (likely (!out.glyf.in_error ()))
+	  for (unsigned i = 0; i < 4; i++)
+	  {
+	    out.glyf.arrayZ[bbox_offset + 2 * i] = (char) (bbox[i] >> 8);
+	    out.glyf.arrayZ[bbox_offset + 2 * i + 1] = (char) bbox[i];
+	  }
+      }
+    }
+    else
+      return false;
+
+    out.x_mins.arrayZ[gid] = (int16_t) bbox[0];
+
+    /* Pad glyphs to four bytes; short loca offsets need even ones. */
+    while (out.glyf.length % 4)
+      out.glyf.push (0);
+    if (unlikely (out.glyf.in_error ())) return false;
+  }
+
+  if (unlikely (!index_format && out.glyf.length > 0x1FFFEu)) return false;
+  if (index_format)
+    _woff_push_u32 (out.loca, out.glyf.length);
+  else
+    _woff_push_u16 (out.loca, out.glyf.length / 2);
+
+  return !out.glyf.in_error () && !out.loca.in_error ();
+}
+
+/* Rebuilds hmtx from the WOFF2 transformed hmtx table, taking omitted
+ * left side bearings from the glyph bounding boxes. */
+static bool
+_woff2_reconstruct_hmtx (const char *data, unsigned length,
+			 unsigned num_h_metrics,
+			 const woff2_glyf_t &glyf,
+			 vector_t<char> &out)
+{
+  enum {
+    PROPORTIONAL_LSBS_OMITTED	= 0x01,
+    MONOSPACED_LSBS_OMITTED	= 0x02,
+  };
+
+  woff_reader_t r (data, length);
+  unsigned num_glyphs = glyf.num_glyphs;
+
+  unsigned flags;
+  if (unlikely (!r.read_u8 (&flags) ||
+		(flags & ~3u) || !(flags & 3) ||
+		!num_h_metrics || num_h_metrics > num_glyphs))
+    return false;
+
+  woff_reader_t advances = r;
+  if (unlikely (!r.skip (2 * num_h_metrics))) return false;
+
+  out.reset ();
+  if (unlikely (!out.alloc (4 * num_h_metrics + 2 * (num_glyphs - num_h_metrics), true)))
+    return false;
+
+  for (unsigned gid = 0; gid < num_glyphs; gid++)
+  {
+    if (gid < num_h_metrics)
+    {
+      unsigned advance;
+      advances.read_u16 (&advance);
+      _woff_push_u16 (out, advance);
+    }
+
+    bool omitted = gid < num_h_metrics ? flags & PROPORTIONAL_LSBS_OMITTED
+				       : flags & MONOSPACED_LSBS_OMITTED;
+    int lsb = glyf.x_mins.arrayZ[gid];
+    if (!omitted && unlikely (!r.read_s16 (&lsb)))
+      return false;
+    _woff_push_u16 (out, (unsigned) lsb & 0xFFFFu);
+  }
+
+  return !out.in_error ();
+}
+
+
+/*
+ * Face data.
+ */
+
+static const tag_t _woff2_known_tags[63] = {
+  HB_TAG('c','m','a','p'), HB_TAG('h','e','a','d'), HB_TAG('h','h','e','a'), HB_TAG('h','m','t','x'),
+  HB_TAG('m','a','x','p'), HB_TAG('n','a','m','e'), HB_TAG('O','S','/','2'), HB_TAG('p','o','s','t'),
+  HB_TAG('c','v','t',' '), HB_TAG('f','p','g','m'), HB_TAG('g','l','y','f'), HB_TAG('l','o','c','a'),
+  HB_TAG('p','r','e','p'), HB_TAG('C','F','F',' '), HB_TAG('V','O','R','G'), HB_TAG('E','B','D','T'),
+  HB_TAG('E','B','L','C'), HB_TAG('g','a','s','p'), HB_TAG('h','d','m','x'), HB_TAG('k','e','r','n'),
+  HB_TAG('L','T','S','H'), HB_TAG('P','C','L','T'), HB_TAG('V','D','M','X'), HB_TAG('v','h','e','a'),
+  HB_TAG('v','m','t','x'), HB_TAG('B','A','S','E'), HB_TAG('G','D','E','F'), HB_TAG('G','P','O','S'),
+  HB_TAG('G','S','U','B'), HB_TAG('E','B','S','C'), HB_TAG('J','S','T','F'), HB_TAG('M','A','T','H'),
+  HB_TAG('C','B','D','T'), HB_TAG('C','B','L','C'), HB_TAG('C','O','L','R'), HB_TAG('C','P','A','L'),
+  HB_TAG('S','V','G',' '), HB_TAG('s','b','i','x'), HB_TAG('a','c','n','t'), HB_TAG('a','v','a','r'),
+  HB_TAG('b','d','a','t'), HB_TAG('b','l','o','c'), HB_TAG('b','s','l','n'), HB_TAG('c','v','a','r'),
+  HB_TAG('f','d','s','c'), HB_TAG('f','e','a','t'), HB_TAG('f','m','t','x'), HB_TAG('f','v','a','r'),
+  HB_TAG('g','v','a','r'), HB_TAG('h','s','t','y'), HB_TAG('j','u','s','t'), HB_TAG('l','c','a','r'),
+  HB_TAG('m','o','r','t'), HB_TAG('m','o','r','x'), HB_TAG('o','p','b','d'), HB_TAG('p','r','o','p'),
+  HB_TAG('t','r','a','k'), HB_TAG('Z','a','p','f'), HB_TAG('S','i','l','f'), HB_TAG('G','l','a','t'),
+  HB_TAG('G','l','o','c'), HB_TAG('F','e','a','t'), HB_TAG('S','i','l','l'),
+};
+
+struct woff_table_t
+{
+  static constexpr unsigned NO_TRANSFORM = (unsigned) -1;
+
+  tag_t tag;
+  unsigned offset;	/* In the file for WOFF, in the decompressed stream for WOFF2. */
+  unsigned length;	/* As stored. */
+  unsigned orig_length;
+  unsigned transform;	/* WOFF2 transform version, or NO_TRANSFORM. */
+};
+
+struct woff_face_data_t
+{
+  /* Tables of up to this size in total are accepted. */
+  static constexpr unsigned MAX_SIZE = 1u << 30;
+
+  ~woff_face_data_t ()
+  {
+    if (glyf)
+    {
+      glyf->~woff2_glyf_t ();
+      free (glyf);
+    }
+    for (blob_t *blob : table_blobs)
+      blob_destroy (blob);
+    blob_destroy (stream);
+#ifdef HAVE_BROTLI
+    if (decoder)
+      BrotliDecoderDestroyInstance (decoder);
+#endif
+    blob_destroy (blob);
+  }
+
+  bool init (blob_t *blob_, unsigned index)
+  {
+    blob = blob_;
+    woff_reader_t r (blob->data, blob->length);
+
+    unsigned signature;
+    if (unlikely (!r.read_u32 (&signature))) return false;
+    switch (signature)
+    {
+    case HB_TAG ('w','O','F','F'): is_woff2 = false; break;
+    case HB_TAG ('w','O','F','2'): is_woff2 = true; break;
+    default: return false;
+    }
+
+    unsigned flavor, length, num_tables, reserved;
+    if (unlikely (!r.read_u32 (&flavor) ||
+		  !r.read_u32 (&length) ||
+		  !r.read_u16 (&num_tables) ||
+		  !r.read_u16 (&reserved) ||
+		  length != blob->length ||
+		  reserved))
+      return false;
+
+    return is_woff2 ? init_woff2 (r, flavor, num_tables, index)
+		    : init_woff (r, num_tables, index);
+  }
+
+  bool init_woff (woff_reader_t &r, unsigned num_tables, unsigned index)
+  {
+    /* totalSfntSize, version, and metadata and private blocks. */
+    if (unlikely (index || !r.skip (4 + 2 + 2 + 5 * 4))) return false;
+
+    if (unlikely (!tables.alloc (num_tables, true))) return false;
+    for (unsigned i = 0; i < num_tables; i++)
+    {
+      woff_table_t table;
+      unsigned checksum;
+      if (unlikely (!r.read_u32 (&table.tag) ||
+		    !r.read_u32 (&table.offset) ||
+		    !r.read_u32 (&table.length) ||
+		    !r.read_u32 (&table.orig_length) ||
+		    !r.read_u32 (&checksum)))
+	return false;
+      if (unlikely (table.offset > blob->length ||
+		    table.length > blob->length - table.offset ||
+		    table.length > table.orig_length ||
+		    table.orig_length > MAX_SIZE))
+	return false;
+      table.transform = woff_table_t::NO_TRANSFORM;
+      tables.push (table);
+      font_tables.push (i);
+    }
+
+    return table_blobs.resize_exact (num_tables) && !font_tables.in_error ();
+  }
+
+  bool init_woff2 (woff_reader_t &r, unsigned flavor, unsigned num_tables, unsigned index)
+  {
+    unsigned total_compressed_size;
+    if (unlikely (!r.skip (4) || /* totalSfntSize */
+		  !r.read_u32 (&total_compressed_size) ||
+		  !r.skip (2 + 2 + 5 * 4))) /* Version, and metadata and private blocks. */
+      return false;
+
+    if (unlikely (!tables.alloc (num_tables, true))) return false;
+    unsigned offset = 0;
+    for (unsigned i = 0; i < num_tables; i++)
+    {
+      woff_table_t table;
+      unsigned flags;
+      if (unlikely (!r.read_u8 (&flags))) return false;
+      if ((flags & 0x3F) == 0x3F)
+      {
+	if (unlikely (!r.read_u32 (&table.tag))) return false;
+      }
+      else
+	table.tag = _woff2_known_tags[flags & 0x3F];
+      if (unlikely (!r.read_base128 (&table.orig_length))) return false;
+
+      /* For glyf and loca, version 3 is the null transform. */
+      unsigned version = flags >> 6;
+      bool is_glyf_or_loca = table.tag == HB_TAG ('g','l','y','f') ||
+			     table.tag == HB_TAG ('l','o','c','a');
+      bool transformed = is_glyf_or_loca ? version != 3 : version != 0;
+
+      table.length = table.orig_length;
+      if (transformed && unlikely (!r.read_base128 (&table.length))) return false;
+      table.transform = transformed ? version : woff_table_t::NO_TRANSFORM;
+
+      if (unlikely (table.orig_length > MAX_SIZE || table.length > MAX_SIZE - offset))
+	return false;
+      table.offset = offset;
+      offset += table.length;
+      tables.push (table);
+    }
+
+    if (flavor == HB_TAG ('t','t','c','f'))
+    {
+      unsigned version, num_fonts;
+      if (unlikely (!r.read_u32 (&version) ||
+		    !r.read_255_u16 (&num_fonts) ||
+		    index >= num_fonts))
+	return false;
+      for (unsigned font = 0; font <= index; font++)
+      {
+	unsigned font_num_tables;
+	if (unlikely (!r.read_255_u16 (&font_num_tables) ||
+		      !r.skip (4))) /* flavor */
+	  return false;
+	font_tables.reset ();
+	for (unsigned i = 0; i < font_num_tables; i++)
+	{
+	  unsigned table_index;
+	  if (unlikely (!r.read_255_u16 (&table_index) || table_index >= num_tables))
+	    return false;
+	  font_tables.push (table_index);
+	}
+      }
+    }
+    else
+    {
+      if (unlikely (index)) return false;
+      for (unsigned i = 0; i < num_tables; i++)
+	font_tables.push (i);
+    }
+
+    const char *compressed;
+    if (unlikely (!r.read_bytes (total_compressed_size, &compressed))) return false;
+
+    /* Only what the table directory claims; checked when decompressing. */
+    stream_length = offset;
+
+#ifdef HAVE_BROTLI
+    decoder = BrotliDecoderCreateInstance (nullptr, nullptr, nullptr);
+    if (unlikely (!decoder)) return false;
+    next_in = (const uint8_t *) compressed;
+    available_in = total_compressed_size;
+#endif
+
+    return table_blobs.resize_exact (num_tables) && !font_tables.in_error ();
+  }
+
+  bool find_table (tag_t tag, unsigned *table_index) const
+  {
+    for (unsigned i : font_tables)
+      if (tables.arrayZ[i].tag == tag)
+      {
+	*table_index = i;
+	return true;
+      }
+    return false;
+  }
+
+  blob_t *reference_table (tag_t tag)
+  {
+    unsigned i;
+    if (!find_table (tag, &i))
+      return blob_get_empty ();
+
+    lock_t l (lock);
+    if (!table_blobs.arrayZ[i])
+    {
+      load_table (i);
+      if (is_woff2)
+	release_stream ();
+    }
+    return blob_reference (table_blobs.arrayZ[i] ? table_blobs.arrayZ[i] : blob_get_empty ());
+  }
+
+  protected:
+
+  /* Sets table_blobs[i]; to the empty blob if the table is broken. */
+  void load_table (unsigned i)
+  {
+    const woff_table_t &table = tables.arrayZ[i];
+
+    if (!is_woff2)
+    {
+      if (table.length == table.orig_length)
+	table_blobs.arrayZ[i] = blob_create_sub_blob (blob, table.offset, table.length);
+      else
+	table_blobs.arrayZ[i] = inflate (table);
+    }
+    else if (decompress_to (table.offset + table.length))
+    {
+      switch (table.transform)
+      {
+      case woff_table_t::NO_TRANSFORM:
+	table_blobs.arrayZ[i] = blob_create_sub_blob (stream, table.offset, table.length);
+	break;
+
+      case 0:
+	/* Sets both. */
+	if (table.tag == HB_TAG ('g','l','y','f') ||
+	    table.tag == HB_TAG ('l','o','c','a'))
+	  load_glyf_and_loca ();
+	break;
+
+      case 1:
+	if (table.tag == HB_TAG ('h','m','t','x'))
+	  table_blobs.arrayZ[i] = load_hmtx (table);
+	break;
+
+      default:
+	break;
+      }
+    }
+
+    if (!table_blobs.arrayZ[i])
+      table_blobs.arrayZ[i] = blob_get_empty ();
+  }
+
+  blob_t *inflate (const woff_table_t &table)
+  {
+#ifdef HAVE_ZLIB
+    char *data = (char *) malloc (table.orig_length);
+    if (unlikely (!data)) return blob_get_empty ();
+
+    uLongf length = table.orig_length;
+    if (uncompress ((Bytef *) data, &length,
+		    (const Bytef *) blob->data + table.offset, table.length) != Z_OK ||
+	length != table.orig_length)
+    {
+      free (data);
+      return blob_get_empty ();
+    }
+
+    blob_t *table_blob = blob_create_or_fail (data, table.orig_length,
+					      HB_MEMORY_MODE_WRITABLE,
+					      data, free);
+    return table_blob ? table_blob : blob_get_empty ();
+#else
+    return blob_get_empty ();
+#endif
+  }
+
+  /* Hands the memory of data over to a blob, leaving data empty. */
+  static blob_t *make_blob (vector_t<char> &data)
+  {
+    char *p = data.arrayZ;
+    unsigned length = data.length;
+    data.init ();
+    blob_t *blob = blob_create_or_fail (p, length,
+					HB_MEMORY_MODE_WRITABLE,
+					p, free);
+    return blob ? blob : blob_get_empty ();
+  }
+
+  /* Decompresses the WOFF2 stream until at least its first end bytes are
+   * available, at stream_data.  The buffer does not move, so sub-blobs of
+   * the parts already decompressed stay valid. */
+  bool decompress_to (unsigned end)
+  {
+    if (end <= decoded) return true;
+
+#ifdef HAVE_BROTLI
+    if (decoder && !stream)
+    {
+      /* Pages are only touched as the decoder writes them. */
+      char *data = (char *) malloc (stream_length);
+      if (unlikely (!data)) return false;
+      stream = blob_create_or_fail (data, stream_length,
+				    HB_MEMORY_MODE_WRITABLE,
+				    data, free);
+      if (unlikely (!stream)) return false;
+      stream_data = data;
+    }
+
+    /* Go a bit past what is needed, so that small tables asked for one
+     * after another do not each pay for a decoder call. */
+    static constexpr unsigned MIN_STEP = 1u << 16;
+
+    while (decoder && decoded < end)
+    {
+      size_t available_out = min (stream_length - decoded,
+				     max (end - decoded, MIN_STEP));
+      uint8_t *next_out = (uint8_t *) stream_data + decoded;
+      auto result = BrotliDecoderDecompressStream (decoder,
+						   &available_in, &next_in,
+						   &available_out, &next_out,
+						   nullptr);
+      decoded = next_out - (uint8_t *) stream_data;
+
+      if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT && decoded < stream_length)
+	continue;
+
+      /* Finished, or broken; either way the decoder is done.  Tables
+       * already handed out of a broken stream stay as they are; no more
+       * are. */
+      BrotliDecoderDestroyInstance (decoder);
+      decoder = nullptr;
+      if (result != BROTLI_DECODER_RESULT_SUCCESS || decoded != stream_length)
+	decoded = 0;
+    }
+#endif
+
+    return end <= decoded;
+  }
+
+  /* Once every table of the font is loaded, the decoder and what is kept
+   * for rebuilding tables are not needed anymore; the stream lives on in
+   * the tables that are sub-blobs of it. */
+  void release_stream ()
+  {
+    for (unsigned i : font_tables)
+      if (!table_blobs.arrayZ[i])
+	return;
+
+    blob_destroy (stream);
+    stream = nullptr;
+    stream_data = nullptr;
+    decoded = 0;
+#ifdef HAVE_BROTLI
+    if (decoder)
+    {
+      BrotliDecoderDestroyInstance (decoder);
+      decoder = nullptr;
+    }
+#endif
+    if (glyf)
+    {
+      glyf->~woff2_glyf_t ();
+      free (glyf);
+      glyf = nullptr;
+    }
+  }
+
+  bool find_font_table (tag_t tag, const woff_table_t **table) const
+  {
+    unsigned i;
+    if (!find_table (tag, &i)) return false;
+    *table = &tables.arrayZ[i];
+    return true;
+  }
+
+  void load_glyf_and_loca ()
+  {
+    unsigned glyf_index, loca_index;
+    if (unlikely (!find_table (HB_TAG ('g','l','y','f'), &glyf_index) ||
+		  !find_table (HB_TAG ('l','o','c','a'), &loca_index)))
+      return;
+    const woff_table_t &glyf_table = tables.arrayZ[glyf_index];
+    const woff_table_t &loca_table = tables.arrayZ[loca_index];
+    if (unlikely (glyf_table.transform != 0 || loca_table.transform != 0 ||
+		  !decompress_to (glyf_table.offset + glyf_table.length)))
+      return;
+
+    if (!glyf)
+    {
+      glyf = (woff2_glyf_t *) calloc (1, sizeof (woff2_glyf_t));
+      if (unlikely (!glyf)) return;
+      new (glyf) woff2_glyf_t;
+      if (unlikely (!_woff2_reconstruct_glyf (stream_data + glyf_table.offset, glyf_table.length, *glyf) ||
+		    glyf->loca.length != loca_table.orig_length))
+	glyf->num_glyphs = 0;
+    }
+
+    if (glyf->num_glyphs)
+    {
+      if (!table_blobs.arrayZ[glyf_index])
+	table_blobs.arrayZ[glyf_index] = make_blob (glyf->glyf);
+      if (!table_blobs.arrayZ[loca_index])
+	table_blobs.arrayZ[loca_index] = make_blob (glyf->loca);
+    }
+
+    /* hmtx might still need the bounding boxes; the tables we are done
+     * with. */
+    glyf->glyf.fini ();
+    glyf->loca.fini ();
+  }
+
+  blob_t *load_hmtx (const woff_table_t &table)
+  {
+    /* Left side bearings come from the reconstructed glyf. */
+    load_glyf_and_loca ();
+    if (unlikely (!glyf || !glyf->num_glyphs)) return blob_get_empty ();
+
+    const woff_table_t *hhea;
+    if (unlikely (!find_font_table (HB_TAG ('h','h','e','a'), &hhea) ||
+		  hhea->transform != woff_table_t::NO_TRANSFORM ||
+		  hhea->length < 36 ||
+		  !decompress_to (hhea->offset + hhea->length)))
+      return blob_get_empty ();
+    const uint8_t *hhea_data = (const uint8_t *) stream_data + hhea->offset;
+    unsigned num_h_metrics = (hhea_data[34] << 8) | hhea_data[35];
+
+    vector_t<char> hmtx;
+    if (unlikely (!_woff2_reconstruct_hmtx (stream_data + table.offset, table.length,
+					    num_h_metrics, *glyf, hmtx) ||
+		  hmtx.length != table.orig_length))
+      return blob_get_empty ();
+
+    return make_blob (hmtx);
+  }
+
+  public:
+  blob_t *blob = nullptr;
+  bool is_woff2 = false;
+  vector_t<woff_table_t> tables;	/* All tables in the file. */
+  vector_t<unsigned> font_tables;	/* Indices of those of the chosen font. */
+
+  mutex_t lock; /* Protects members below. */
+  vector_t<blob_t *> table_blobs;	/* Per table, once loaded. */
+
+  /* WOFF2 decompressed stream, allocated on first use and filled up to
+   * decoded; our reference is dropped once all tables are loaded. */
+  blob_t *stream = nullptr;
+  char *stream_data = nullptr;
+  unsigned decoded = 0;
+  unsigned stream_length = 0;	/* Of the whole stream. */
+#ifdef HAVE_BROTLI
+  BrotliDecoderState *decoder = nullptr;
+  const uint8_t *next_in = nullptr;
+  size_t available_in = 0;
+#endif
+
+  woff2_glyf_t *glyf = nullptr;
+};
+
+static void
+_woff_face_data_destroy (void *data)
+{
+  woff_face_data_t *woff = (woff_face_data_t *) data;
+  woff->~woff_face_data_t ();
+  free (woff);
+}
+
+static blob_t *
+_woff_reference_table (face_t *face HB_UNUSED, tag_t tag, void *user_data)
+{
+  woff_face_data_t *data = (woff_face_data_t *) user_data;
+
+  /* There is no font file to hand out. */
+  if (tag == HB_TAG_NONE)
+    return blob_get_empty ();
+
+  return data->reference_table (tag);
+}
+
+#endif
+
+
+/**
+ * face_create_from_woff:
+ * @blob: #blob_t holding a WOFF or WOFF2 font
+ * @index: The index of the face within @blob
+ *
+ * Constructs a new face object from a WOFF or WOFF2 compressed font,
+ * without decompressing it up front.
+ *
+ * Tables are decompressed, and for WOFF2 reconstructed, when they are
+ * first used, so that tables a face never needs cost neither time nor
+ * memory.  WOFF tables need zlib and WOFF2 tables need Brotli; HarfBuzz
+ * must have been built with them for their tables to load.
+ *
+ * @index selects a face of a WOFF2 collection, and is otherwise zero.  As
+ * with face_create(), only its lower 16 bits select the face.
+ *
+ * The face does not have a font file blob: face_reference_blob() on it
+ * returns the empty blob.
+ *
+ * Return value: (transfer full): The new face object, or the empty face
+ * if @blob is not a WOFF or WOFF2 font, or does not have face @index.
+ *
+ * Since: REPLACEME
+ **/
+face_t *
+face_create_from_woff (blob_t    *blob,
+		       unsigned int  index)
+{
+#ifndef HB_NO_WOFF
+  if (unlikely (!blob))
+    return face_get_empty ();
+
+  woff_face_data_t *data = (woff_face_data_t *) calloc (1, sizeof (woff_face_data_t));
+  if (unlikely (!data))
+    return face_get_empty ();
+  new (data) woff_face_data_t;
+
+  if (unlikely (!data->init (blob_reference (blob), index & 0xFFFFu)))
+  {
+    _woff_face_data_destroy (data);
+    return face_get_empty ();
+  }
+
+  face_t *face = face_create_for_tables (_woff_reference_table,
+					 data,
+					 _woff_face_data_destroy);
+  face->index = index;
+
+  return face;
+#else
+  return face_get_empty ();
+#endif
+}
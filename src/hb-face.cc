@@ -33,6 +33,10 @@
 #include "hb-open-file.hh"
 #include "hb-ot-face.hh"
 #include "hb-ot-cmap-table.hh"
+#include "hb-sanitize-cache.hh"
+#include "hb-face-shared-tables.hh"
+#include "hb-memory-usage.hh"
+#include "hb-shape-plan.hh"
 
 
 /**
@@ -246,6 +250,60 @@ face_create (blob_t    *blob,
   return face;
 }
 
+/**
+ * face_create_sibling:
+ * @face: A face object created with face_create() or this function
+ * @index: The index of the new face within the blob of @face
+ *
+ * Constructs a new face object for the face at @index in the same font
+ * collection file as @face, like face_create() on the blob of @face
+ * would.
+ *
+ * Unlike with face_create(), the faces share the tables that the
+ * collection stores once for several of its faces.  Such tables are
+ * sanitized once for all of them, and their layout (GSUB and GPOS) and
+ * CFF accelerators are built once and shared too, which saves most of
+ * the per-face memory for collections of faces with common glyph data,
+ * like CJK collections.  @face joins the sharing with its first sibling;
+ * tables it loaded before that are not shared.
+ *
+ * To load a whole collection this way, create the first face with
+ * face_create() and the others from it with this function.
+ *
+ * Return value: (transfer full): The new face object
+ *
+ * Since: REPLACEME
+ **/
+face_t *
+face_create_sibling (face_t       *face,
+		     unsigned int  index)
+{
+  blob_t *blob = face_reference_blob (face);
+  face_t *sibling = face_create (blob, index);
+
+#ifndef HB_NO_FACE_SHARED_TABLES
+  if (blob->length && sibling != face_get_empty ())
+  {
+    face_shared_tables_t *shared_tables = face->shared_tables.get_acquire ();
+    if (!shared_tables)
+    {
+      shared_tables = face_shared_tables_t::create ();
+      if (likely (shared_tables) &&
+	  unlikely (!face->shared_tables.cmpexch (nullptr, shared_tables)))
+      {
+	shared_tables->destroy ();
+	shared_tables = face->shared_tables.get_acquire ();
+      }
+    }
+    if (likely (shared_tables))
+      sibling->shared_tables.set_relaxed (shared_tables->reference ());
+  }
+#endif
+
+  blob_destroy (blob);
+  return sibling;
+}
+
 /**
  * face_get_empty:
  *
@@ -306,6 +364,19 @@ face_destroy (face_t *face)
   face->data.fini ();
   face->table.fini ();
 
+#ifndef HB_NO_FACE_SHARED_TABLES
+  if (face_shared_tables_t *shared_tables = face->shared_tables.get_relaxed ())
+    shared_tables->destroy ();
+#endif
+
+#ifndef HB_NO_SANITIZE_CACHE
+  if (face->sanitize_cache)
+  {
+    face->sanitize_cache->~sanitize_cache_t ();
+    free (face->sanitize_cache);
+  }
+#endif
+
   if (face->destroy)
     face->destroy (face->user_data);
 
@@ -547,6 +618,143 @@ face_get_glyph_count (const face_t *face)
   return face->get_num_glyphs ();
 }
 
+#ifndef HB_NO_SANITIZE_CACHE
+bool
+face_sanitize_cache_is_trusted (const face_t *face, tag_t tag,
+				const blob_t *blob, unsigned num_glyphs)
+{
+  return face->sanitize_cache &&
+	 face->sanitize_cache->is_trusted (tag, blob, num_glyphs);
+}
+
+void
+face_sanitize_cache_record (const face_t *face, tag_t tag,
+			    const blob_t *blob, unsigned num_glyphs)
+{
+  if (face->sanitize_cache)
+    face->sanitize_cache->record (tag, blob, num_glyphs);
+}
+#endif
+
+#ifndef HB_NO_FACE_SHARED_TABLES
+blob_t *
+face_shared_tables_reference (const face_t *face, tag_t tag,
+			      const blob_t *blob, unsigned num_glyphs,
+			      bool lazy)
+{
+  face_shared_tables_t *shared_tables = face->shared_tables.get_acquire ();
+  if (!shared_tables || !blob->length)
+    return nullptr;
+  return shared_tables->reference_table ({blob->data, blob->length, tag, num_glyphs, lazy});
+}
+
+blob_t *
+face_shared_tables_set (const face_t *face, tag_t tag,
+			const char *data, unsigned length, unsigned num_glyphs,
+			bool lazy, blob_t *sanitized)
+{
+  face_shared_tables_t *shared_tables = face->shared_tables.get_acquire ();
+  if (!shared_tables || !length)
+    return sanitized;
+  return shared_tables->set_table ({data, length, tag, num_glyphs, lazy}, sanitized);
+}
+
+void *
+face_shared_tables_get_accelerator (face_t *face, tag_t tag,
+				    void *(*create) (face_t *),
+				    void (*destroy) (void *),
+				    bool *shared /* OUT */)
+{
+  *shared = false;
+
+  face_shared_tables_t *shared_tables = face->shared_tables.get_acquire ();
+  if (!shared_tables)
+    return create (face);
+
+  /* Keyed by where the table is; same as the table itself. */
+  blob_t *blob = face->reference_table (tag);
+  face_shared_tables_t::key_t key = {blob->data, blob->length, tag,
+				     face->get_num_glyphs (), false};
+  blob_destroy (blob);
+  if (!key.length)
+    return create (face);
+
+  *shared = true;
+  return shared_tables->get_accelerator (key, face, create, destroy);
+}
+#endif
+
+/**
+ * face_set_sanitize_cache:
+ * @face: A face object
+ * @cache: (nullable): A blob previously returned by
+ *     face_reference_sanitize_cache(), or `NULL`
+ *
+ * Makes @face remember which of its tables pass sanitizing without
+ * needing any edits, and trust the verdicts in @cache, if any.  Trusted
+ * tables are not sanitized when loaded.
+ *
+ * Each verdict carries a SHA-256 digest of its table, so a table is
+ * only trusted if it is byte for byte the one that passed sanitizing
+ * before; any other table is sanitized as usual.  Trusted tables are
+ * still hashed when loaded, which is cheaper than sanitizing the larger
+ * ones but not free, so the cache pays off most for big layout tables.
+ *
+ * Must be called before any table of @face is loaded.
+ *
+ * Return value: `true` if @cache was used or was `NULL`, `false` if it
+ * was not a sanitize cache or @face is immutable
+ *
+ * Since: REPLACEME
+ **/
+bool_t
+face_set_sanitize_cache (face_t *face,
+			 blob_t *cache)
+{
+#ifndef HB_NO_SANITIZE_CACHE
+  if (object_is_immutable (face))
+    return false;
+
+  if (!face->sanitize_cache)
+  {
+    auto *sanitize_cache = (sanitize_cache_t *) calloc (1, sizeof (sanitize_cache_t));
+    if (unlikely (!sanitize_cache))
+      return false;
+    new (sanitize_cache) sanitize_cache_t;
+    face->sanitize_cache = sanitize_cache;
+  }
+
+  return !cache || face->sanitize_cache->load (cache);
+#else
+  return false;
+#endif
+}
+
+/**
+ * face_reference_sanitize_cache:
+ * @face: A face object
+ *
+ * Exports the sanitize verdicts of @face: those passed to
+ * face_set_sanitize_cache(), and those recorded since for tables that
+ * got loaded.  The blob can be stored and passed to
+ * face_set_sanitize_cache() for the same font file later, by this or
+ * another process.
+ *
+ * Return value: (transfer full): A blob with the verdicts, or the empty
+ * blob if face_set_sanitize_cache() was never called on @face
+ *
+ * Since: REPLACEME
+ **/
+blob_t *
+face_reference_sanitize_cache (face_t *face)
+{
+#ifndef HB_NO_SANITIZE_CACHE
+  if (face->sanitize_cache)
+    return face->sanitize_cache->serialize ();
+#endif
+  return blob_get_empty ();
+}
+
 /**
  * face_get_table_tags:
  * @face: A face object
@@ -584,6 +792,106 @@ face_get_table_tags (const face_t *face,
 }
 
 
+/*
+ * Memory usage.
+ */
+
+/**
+ * face_get_memory_usage:
+ * @face: A face object
+ * @start_offset: The index of the first entry to retrieve
+ * @entry_count: (inout) (optional): Input = the maximum number of entries
+ *               to return; Output = the actual number of entries returned
+ *               (may be zero)
+ * @entries: (out) (array length=entry_count): The array of entries found
+ *
+ * Fetches the heap memory @face uses, broken down by table.  The entry
+ * for a table covers its blob, any copy of the table data the blob
+ * holds, and the accelerator built for the table; the entry with tag
+ * %HB_TAG_NONE covers the face object itself and its cached shape plans.
+ * Only tables and accelerators that have been loaded show up.
+ *
+ * The font data passed to face_create() is not included, nor are
+ * accelerators shared with sibling faces made with face_create_sibling().
+ * Sizes are a close estimate: allocator overhead, and some private data
+ * of shapers, are not accounted for.
+ *
+ * Return value: Total number of entries
+ *
+ * Since: REPLACEME
+ **/
+unsigned int
+face_get_memory_usage (const face_t   *face,
+		       unsigned int    start_offset,
+		       unsigned int   *entry_count, /* IN/OUT */
+		       memory_usage_t *entries /* OUT */)
+{
+#ifndef HB_NO_MEMORY_USAGE
+  if (!face->header.is_inert ())
+  {
+    memory_usage_collector_t c;
+    c.add (HB_TAG_NONE, sizeof (face_t));
+
+#ifndef HB_NO_SANITIZE_CACHE
+    if (face->sanitize_cache)
+      c.add (HB_TAG_NONE, sizeof (sanitize_cache_t) + face->sanitize_cache->get_memory_usage ());
+#endif
+
+#ifndef HB_NO_SHAPER
+    for (const face_t::plan_node_t *node = face->shape_plans; node; node = node->next)
+      c.add (HB_TAG_NONE, sizeof (*node) + sizeof (shape_plan_t) + node->shape_plan->get_memory_usage ());
+#endif
+
+    face->table.get_memory_usage (&c);
+
+    return c.get_entries (start_offset, entry_count, entries);
+  }
+#endif
+
+  if (entry_count)
+    *entry_count = 0;
+  return 0;
+}
+
+/**
+ * face_release_memory:
+ * @face: A face object
+ *
+ * Frees the tables and accelerators @face has loaded, and the shape plans
+ * it caches, to recover memory.  All of it is rebuilt when used again,
+ * so this is for when memory is tight and @face is not expected to be
+ * used for a while.  Shape plans that callers hold on to stay valid.
+ *
+ * Tables and accelerators are loaded lazily and then shared by all
+ * threads without locking, so this must not be called while another
+ * thread might be using @face, or a font or shape plan made from it.
+ *
+ * Since: REPLACEME
+ **/
+void
+face_release_memory (face_t *face)
+{
+#ifndef HB_NO_MEMORY_USAGE
+  if (face->header.is_inert ())
+    return;
+
+#ifndef HB_NO_SHAPER
+  face_t::plan_node_t *node = face->shape_plans.get_acquire ();
+  face->shape_plans.set_relaxed (nullptr);
+  while (node)
+  {
+    face_t::plan_node_t *next = node->next;
+    shape_plan_destroy (node->shape_plan);
+    free (node);
+    node = next;
+  }
+#endif
+
+  face->table.release ();
+#endif
+}
+
+
 /*
  * Character set.
  */
@@ -59,6 +59,14 @@ HB_EXTERN face_t *
 face_create (blob_t    *blob,
 		unsigned int  index);
 
+HB_EXTERN face_t *
+face_create_from_woff (blob_t    *blob,
+			  unsigned int  index);
+
+HB_EXTERN face_t *
+face_create_sibling (face_t       *face,
+		     unsigned int  index);
+
 /**
  * reference_table_func_t:
  * @face: an #face_t to reference table for
@@ -135,6 +143,46 @@ face_set_glyph_count (face_t    *face,
 HB_EXTERN unsigned int
 face_get_glyph_count (const face_t *face);
 
+HB_EXTERN bool_t
+face_set_sanitize_cache (face_t *face,
+			 blob_t *cache);
+
+HB_EXTERN blob_t *
+face_reference_sanitize_cache (face_t *face);
+
+/**
+ * face_warm_up_flags_t:
+ * @HB_FACE_WARM_UP_FLAG_CMAP: The character to glyph mapping.
+ * @HB_FACE_WARM_UP_FLAG_METRICS: Horizontal and vertical metrics and the
+ * tables they depend on.
+ * @HB_FACE_WARM_UP_FLAG_LAYOUT: The OpenType and AAT layout tables.
+ * @HB_FACE_WARM_UP_FLAG_LAYOUT_LOOKUPS: The accelerators of every GSUB and
+ * GPOS lookup; implies @HB_FACE_WARM_UP_FLAG_LAYOUT.
+ * @HB_FACE_WARM_UP_FLAG_OUTLINES: The glyph outline tables.
+ * @HB_FACE_WARM_UP_FLAG_SHAPING: What shaping with the default font
+ * functions uses.
+ * @HB_FACE_WARM_UP_FLAG_ALL: All of the above.
+ *
+ * Flags selecting the face data that face_warm_up() loads.
+ *
+ * Since: REPLACEME
+ */
+typedef enum { /*< flags >*/
+  HB_FACE_WARM_UP_FLAG_CMAP		= 0x00000001u,
+  HB_FACE_WARM_UP_FLAG_METRICS		= 0x00000002u,
+  HB_FACE_WARM_UP_FLAG_LAYOUT		= 0x00000004u,
+  HB_FACE_WARM_UP_FLAG_LAYOUT_LOOKUPS	= 0x00000008u,
+  HB_FACE_WARM_UP_FLAG_OUTLINES		= 0x00000010u,
+
+  HB_FACE_WARM_UP_FLAG_SHAPING		= 0x0000000Fu,
+  HB_FACE_WARM_UP_FLAG_ALL		= 0x0000001Fu
+} face_warm_up_flags_t;
+
+HB_EXTERN void
+face_warm_up (face_t               *face,
+	      face_warm_up_flags_t  flags,
+	      unsigned int          threads);
+
 HB_EXTERN unsigned int
 face_get_table_tags (const face_t *face,
 			unsigned int  start_offset,
@@ -142,6 +190,36 @@ face_get_table_tags (const face_t *face,
 			tag_t     *table_tags /* OUT */);
 
 
+/*
+ * Memory usage.
+ */
+
+/**
+ * memory_usage_t:
+ * @tag: The tag of the table the memory is used for, or %HB_TAG_NONE for
+ * the object itself and caches that are not tied to a table
+ * @size: The number of bytes used
+ *
+ * An entry of the memory usage breakdown returned by
+ * face_get_memory_usage() and font_get_memory_usage().
+ *
+ * Since: REPLACEME
+ */
+typedef struct memory_usage_t {
+  tag_t        tag;
+  unsigned int size;
+} memory_usage_t;
+
+HB_EXTERN unsigned int
+face_get_memory_usage (const face_t   *face,
+		       unsigned int    start_offset,
+		       unsigned int   *entry_count, /* IN/OUT */
+		       memory_usage_t *entries /* OUT */);
+
+HB_EXTERN void
+face_release_memory (face_t *face);
+
+
 /*
  * Character set.
  */
@@ -181,6 +259,31 @@ HB_EXTERN void
 face_builder_sort_tables (face_t *face,
                              const tag_t  *tags);
 
+/**
+ * face_builder_write_func_t:
+ * @data: (array length=length): the next chunk of font data
+ * @length: length of @data in bytes
+ * @user_data: user data passed to face_builder_write()
+ *
+ * A callback receiving the font data produced by face_builder_write(),
+ * in order. @data is only valid for the duration of the call.
+ *
+ * Return value: `true` to continue, `false` to stop writing.
+ *
+ * Since: REPLACEME
+ **/
+typedef bool_t (*face_builder_write_func_t) (const char   *data,
+					     unsigned int  length,
+					     void         *user_data);
+
+HB_EXTERN unsigned int
+face_builder_get_length (face_t *face);
+
+HB_EXTERN bool_t
+face_builder_write (face_t                    *face,
+		    face_builder_write_func_t  func,
+		    void                      *user_data);
+
 
 HB_END_DECLS
 
@@ -36,6 +36,10 @@
 #include "hb-ot-face.hh"
 
 
+struct sanitize_cache_t;
+struct face_shared_tables_t;
+
+
 /*
  * hb_face_t
  */
@@ -69,6 +73,12 @@ struct hb_face_t
   hb_atomic_ptr_t<plan_node_t> shape_plans;
 #endif
 
+  /* Set by face_set_sanitize_cache(). */
+  sanitize_cache_t *sanitize_cache;
+
+  /* Set by face_create_sibling(). */
+  hb_atomic_ptr_t<face_shared_tables_t> shared_tables;
+
   hb_blob_t *reference_table (hb_tag_t tag) const
   {
     hb_blob_t *blob;
@@ -30,8 +30,11 @@
 
 #include "hb-font.hh"
 #include "hb-draw.hh"
+#include "hb-outline.hh"
 #include "hb-paint.hh"
 #include "hb-machinery.hh"
+#include "hb-memory-usage.hh"
+#include "hb-thread-pool.hh"
 
 #include "hb-ot.h"
 
@@ -1435,6 +1438,330 @@ font_draw_glyph (font_t *font,
   font->draw_glyph (glyph, dfuncs, draw_data);
 }
 
+static void
+font_draw_glyphs_move_to (draw_funcs_t *dfuncs HB_UNUSED,
+			  void *data,
+			  draw_state_t *st HB_UNUSED,
+			  float to_x, float to_y,
+			  void *user_data HB_UNUSED)
+{
+  draw_path_buffer_t *c = (draw_path_buffer_t *) data;
+
+  c->push_verb (HB_DRAW_VERB_MOVE_TO);
+  c->push_point (to_x, to_y);
+}
+
+static void
+font_draw_glyphs_line_to (draw_funcs_t *dfuncs HB_UNUSED,
+			  void *data,
+			  draw_state_t *st HB_UNUSED,
+			  float to_x, float to_y,
+			  void *user_data HB_UNUSED)
+{
+  draw_path_buffer_t *c = (draw_path_buffer_t *) data;
+
+  c->push_verb (HB_DRAW_VERB_LINE_TO);
+  c->push_point (to_x, to_y);
+}
+
+static void
+font_draw_glyphs_quadratic_to (draw_funcs_t *dfuncs HB_UNUSED,
+			       void *data,
+			       draw_state_t *st HB_UNUSED,
+			       float control_x, float control_y,
+			       float to_x, float to_y,
+			       void *user_data HB_UNUSED)
+{
+  draw_path_buffer_t *c = (draw_path_buffer_t *) data;
+
+  c->push_verb (HB_DRAW_VERB_QUADRATIC_TO);
+  c->push_point (control_x, control_y);
+  c->push_point (to_x, to_y);
+}
+
+static void
+font_draw_glyphs_cubic_to (draw_funcs_t *dfuncs HB_UNUSED,
+			   void *data,
+			   draw_state_t *st HB_UNUSED,
+			   float control1_x, float control1_y,
+			   float control2_x, float control2_y,
+			   float to_x, float to_y,
+			   void *user_data HB_UNUSED)
+{
+  draw_path_buffer_t *c = (draw_path_buffer_t *) data;
+
+  c->push_verb (HB_DRAW_VERB_CUBIC_TO);
+  c->push_point (control1_x, control1_y);
+  c->push_point (control2_x, control2_y);
+  c->push_point (to_x, to_y);
+}
+
+static void
+font_draw_glyphs_close_path (draw_funcs_t *dfuncs HB_UNUSED,
+			     void *data,
+			     draw_state_t *st HB_UNUSED,
+			     void *user_data HB_UNUSED)
+{
+  draw_path_buffer_t *c = (draw_path_buffer_t *) data;
+
+  c->push_verb (HB_DRAW_VERB_CLOSE_PATH);
+}
+
+static inline void free_static_font_draw_glyphs_funcs ();
+
+static struct font_draw_glyphs_funcs_lazy_loader_t : draw_funcs_lazy_loader_t<font_draw_glyphs_funcs_lazy_loader_t>
+{
+  static draw_funcs_t *create ()
+  {
+    draw_funcs_t *funcs = draw_funcs_create ();
+
+    draw_funcs_set_move_to_func (funcs, font_draw_glyphs_move_to, nullptr, nullptr);
+    draw_funcs_set_line_to_func (funcs, font_draw_glyphs_line_to, nullptr, nullptr);
+    draw_funcs_set_quadratic_to_func (funcs, font_draw_glyphs_quadratic_to, nullptr, nullptr);
+    draw_funcs_set_cubic_to_func (funcs, font_draw_glyphs_cubic_to, nullptr, nullptr);
+    draw_funcs_set_close_path_func (funcs, font_draw_glyphs_close_path, nullptr, nullptr);
+
+    draw_funcs_make_immutable (funcs);
+
+    atexit (free_static_font_draw_glyphs_funcs);
+
+    return funcs;
+  }
+} static_font_draw_glyphs_funcs;
+
+static inline
+void free_static_font_draw_glyphs_funcs ()
+{
+  static_font_draw_glyphs_funcs.free_instance ();
+}
+
+/**
+ * font_draw_glyphs:
+ * @font: #font_t to work upon
+ * @glyph_count: Number of glyphs in @glyphs
+ * @glyphs: (array length=glyph_count): The glyph IDs to draw
+ * @verb_count: (inout): Input = the size of @verbs;
+ *     Output = the number of verbs needed for all glyphs
+ * @verbs: (out caller-allocates) (array length=verb_count) (nullable):
+ *     Array of #draw_verb_t values to fill in
+ * @coord_count: (inout): Input = the size of @coords;
+ *     Output = the number of coordinates needed for all glyphs
+ * @coords: (out caller-allocates) (array length=coord_count) (nullable):
+ *     Array of interleaved x, y coordinates to fill in
+ * @verb_offsets: (out caller-allocates) (nullable): Array of
+ *     @glyph_count + 1 entries, receiving the index of the first verb of
+ *     each glyph, followed by the total
+ * @coord_offsets: (out caller-allocates) (nullable): Array of
+ *     @glyph_count + 1 entries, receiving the index of the first
+ *     coordinate of each glyph, followed by the total
+ *
+ * Draws the outlines of all @glyphs into a single caller-owned path
+ * buffer, in the same coordinates font_draw_glyph() would produce.
+ *
+ * This avoids setting up user draw callbacks for every glyph and lets
+ * the caller allocate storage for a whole glyph run, or atlas, at once.
+ * With the OpenType font functions, glyf, CFF and CFF2 outlines are
+ * decoded straight into the arrays, without a call per path segment.
+ * Call it with zero-sized arrays first to find out how much space is
+ * needed; the counts and offsets are filled in regardless.
+ *
+ * Return value: `true` if all verbs and coordinates fit in the arrays
+ * provided, `false` otherwise
+ *
+ * Since: REPLACEME
+ **/
+bool_t
+font_draw_glyphs (font_t *font,
+		  unsigned int glyph_count,
+		  const codepoint_t *glyphs,
+		  unsigned int *verb_count, /* IN/OUT */
+		  uint8_t *verbs, /* OUT */
+		  unsigned int *coord_count, /* IN/OUT */
+		  float *coords, /* OUT */
+		  unsigned int *verb_offsets, /* OUT */
+		  unsigned int *coord_offsets /* OUT */)
+{
+  draw_path_buffer_t buffer = {
+    verbs, verbs ? *verb_count : 0, 0,
+    coords, coords ? *coord_count : 0, 0
+  };
+  draw_funcs_t *funcs = static_font_draw_glyphs_funcs.get_unconst ();
+
+  for (unsigned i = 0; i < glyph_count; i++)
+  {
+    if (verb_offsets) verb_offsets[i] = buffer.verb_count;
+    if (coord_offsets) coord_offsets[i] = buffer.coord_count;
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_OT_FONT)
+    if (ot_font_draw_glyph_to_path (font, glyphs[i], &buffer))
+      continue;
+#endif
+    font->draw_glyph (glyphs[i], funcs, &buffer);
+  }
+  if (verb_offsets) verb_offsets[glyph_count] = buffer.verb_count;
+  if (coord_offsets) coord_offsets[glyph_count] = buffer.coord_count;
+
+  bool ret = buffer.verb_count <= buffer.verb_capacity &&
+	     buffer.coord_count <= buffer.coord_capacity;
+  *verb_count = buffer.verb_count;
+  *coord_count = buffer.coord_count;
+  return ret;
+}
+
+/**
+ * font_get_glyph_sdf:
+ * @font: #font_t to work upon
+ * @glyph: The glyph ID
+ * @x_origin: The x coordinate, in font space, of the left edge of the bitmap
+ * @y_origin: The y coordinate, in font space, of the top edge of the bitmap
+ * @spread: The distance, in font space, that maps to the full range of
+ *     bitmap values on either side of the outline
+ * @width: Width of the bitmap, in pixels
+ * @height: Height of the bitmap, in pixels
+ * @stride: Distance, in bytes, between the starts of consecutive rows
+ * @bitmap: (out caller-allocates) (array): The bitmap to fill in
+ *
+ * Renders a signed distance field of the outline of @glyph, as drawn by
+ * font_draw_glyph(), into an 8-bit, top-down bitmap.  One pixel is one
+ * unit of font space, so the font scale sets the resolution; pixel
+ * (0, 0) is centered at (@x_origin + 0.5, @y_origin - 0.5).
+ *
+ * Each pixel holds 128 on the outline, rising to 255 at @spread inside
+ * it and falling to 0 at @spread outside, under the nonzero winding rule.
+ *
+ * The outline is recorded and rendered without going through any user
+ * callbacks, and calls for different glyphs on the same font may be made
+ * concurrently.  See font_get_glyphs_sdf() to render many glyphs at once.
+ *
+ * Return value: `true` if the glyph has an outline, `false` otherwise
+ * or if the bitmap could not be rendered, for lack of memory or because
+ * it is too large; the bitmap is filled in, or cleared, either way
+ *
+ * Since: REPLACEME
+ **/
+bool_t
+font_get_glyph_sdf (font_t *font,
+		    codepoint_t glyph,
+		    float x_origin, float y_origin,
+		    float spread,
+		    unsigned int width, unsigned int height,
+		    unsigned int stride,
+		    uint8_t *bitmap /* OUT */)
+{
+#ifndef HB_NO_GLYPH_SDF
+  outline_t outline;
+  font->draw_glyph (glyph, outline_recording_pen_get_funcs (), &outline);
+  if (unlikely (outline.points.in_error () || outline.contours.in_error ()))
+    outline.reset ();
+
+  return outline.render_sdf (bitmap, width, height, stride,
+			     x_origin, y_origin, spread) &&
+	 outline.contours.length != 0;
+#else
+  for (unsigned r = 0; r < height; r++)
+    hb_memset (bitmap + r * stride, 0, width);
+  return false;
+#endif
+}
+
+/**
+ * font_get_glyphs_sdf:
+ * @font: #font_t to work upon
+ * @glyph_count: The number of glyphs
+ * @glyphs: (array length=glyph_count): The glyph IDs
+ * @x_origins: (array length=glyph_count): The x coordinate, in font space,
+ *     of the left edge of each bitmap
+ * @y_origins: (array length=glyph_count): The y coordinate, in font space,
+ *     of the top edge of each bitmap
+ * @spread: The distance, in font space, that maps to the full range of
+ *     bitmap values on either side of the outline
+ * @width: Width of each bitmap, in pixels
+ * @height: Height of each bitmap, in pixels
+ * @stride: Distance, in bytes, between the starts of consecutive rows
+ * @bitmaps: (array length=glyph_count): The bitmaps to fill in, typically
+ *     cells of one atlas
+ * @max_threads: The maximum number of threads to use, including the
+ *     calling one
+ *
+ * Calls font_get_glyph_sdf() for each of @glyphs, spreading the glyphs over
+ * up to @max_threads threads.  The threads are created for the call and
+ * joined before it returns; with @max_threads of 1, or where threads are not
+ * available, all glyphs are rendered on the calling thread.
+ *
+ * Since: REPLACEME
+ **/
+void
+font_get_glyphs_sdf (font_t *font,
+		     unsigned int glyph_count,
+		     const codepoint_t *glyphs,
+		     const float *x_origins, const float *y_origins,
+		     float spread,
+		     unsigned int width, unsigned int height,
+		     unsigned int stride,
+		     uint8_t **bitmaps /* OUT */,
+		     unsigned int max_threads)
+{
+  parallel_for (max_threads, glyph_count,
+		[&] (unsigned i)
+		{
+		  font_get_glyph_sdf (font, glyphs[i],
+				      x_origins[i], y_origins[i], spread,
+				      width, height, stride, bitmaps[i]);
+		});
+}
+
+/**
+ * font_get_glyph_a8:
+ * @font: #font_t to work upon
+ * @glyph: The glyph ID
+ * @x_origin: The x coordinate, in font space, of the left edge of the bitmap
+ * @y_origin: The y coordinate, in font space, of the top edge of the bitmap
+ * @width: Width of the bitmap, in pixels
+ * @height: Height of the bitmap, in pixels
+ * @stride: Distance, in bytes, between the starts of consecutive rows
+ * @bitmap: (out caller-allocates) (array): The bitmap to fill in
+ *
+ * Rasterizes the outline of @glyph, as drawn by font_draw_glyph(), into
+ * an 8-bit, top-down, anti-aliased coverage bitmap, without needing a
+ * graphics library.  One pixel is one unit of font space, so the font
+ * scale sets the resolution; the top-left corner of pixel (0, 0) is at
+ * (@x_origin, @y_origin).
+ *
+ * Coverage is exact area coverage of each pixel, 0 to 255.  Overlapping
+ * contours of the same direction are not summed past full coverage.
+ *
+ * Like font_get_glyph_sdf(), calls for different glyphs on the same font
+ * may be made concurrently.
+ *
+ * Return value: `true` if the glyph has an outline, `false` otherwise
+ * or if the bitmap could not be rendered, for lack of memory or because
+ * it is too large; the bitmap is filled in, or cleared, either way
+ *
+ * Since: REPLACEME
+ **/
+bool_t
+font_get_glyph_a8 (font_t *font,
+		   codepoint_t glyph,
+		   float x_origin, float y_origin,
+		   unsigned int width, unsigned int height,
+		   unsigned int stride,
+		   uint8_t *bitmap /* OUT */)
+{
+#ifndef HB_NO_OUTLINE
+  outline_t outline;
+  font->draw_glyph (glyph, outline_recording_pen_get_funcs (), &outline);
+  if (unlikely (outline.points.in_error () || outline.contours.in_error ()))
+    outline.reset ();
+
+  return outline.render_a8 (bitmap, width, height, stride,
+			    x_origin, y_origin) &&
+	 outline.contours.length != 0;
+#else
+  for (unsigned r = 0; r < height; r++)
+    hb_memset (bitmap + r * stride, 0, width);
+  return false;
+#endif
+}
+
 /**
  * font_paint_glyph:
  * @font: #font_t to work upon
@@ -1815,7 +2142,7 @@ _font_create (face_t *face)
   if (unlikely (!face))
     face = face_get_empty ();
 
-  if (!(font = object_create<font_t> ()))
+  if (!(font = object_create_pooled<font_t> ()))
     return font_get_empty ();
 
   face_make_immutable (face);
@@ -1998,7 +2325,7 @@ font_destroy (font_t *font)
   free (font->coords);
   free (font->design_coords);
 
-  free (font);
+  object_free_pooled (font);
 }
 
 /**
@@ -2921,6 +3248,80 @@ font_get_var_coords_design (font_t *font,
 }
 #endif
 
+
+/**
+ * font_get_memory_usage:
+ * @font: #font_t to work upon
+ * @start_offset: The index of the first entry to retrieve
+ * @entry_count: (inout) (optional): Input = the maximum number of entries
+ *               to return; Output = the actual number of entries returned
+ *               (may be zero)
+ * @entries: (out) (array length=entry_count): The array of entries found
+ *
+ * Fetches the heap memory @font uses, broken down by table, like
+ * face_get_memory_usage() does for faces.  The entries for tables cover
+ * the caches the OpenType font functions keep for them; the entry with
+ * tag %HB_TAG_NONE covers the font object itself, its variation
+ * coordinates, and caches that are not tied to a table.
+ *
+ * The face of @font, and its parent font, are not included.
+ *
+ * Return value: Total number of entries
+ *
+ * Since: REPLACEME
+ **/
+unsigned int
+font_get_memory_usage (const font_t   *font,
+		       unsigned int    start_offset,
+		       unsigned int   *entry_count, /* IN/OUT */
+		       memory_usage_t *entries /* OUT */)
+{
+#ifndef HB_NO_MEMORY_USAGE
+  if (!font->header.is_inert ())
+  {
+    memory_usage_collector_t c;
+    c.add (HB_TAG_NONE, sizeof (font_t) +
+			font->num_coords * (sizeof (font->coords[0]) + sizeof (font->design_coords[0])));
+
+#ifndef HB_NO_OT_FONT
+    ot_font_get_memory_usage (font, &c);
+#endif
+
+    return c.get_entries (start_offset, entry_count, entries);
+  }
+#endif
+
+  if (entry_count)
+    *entry_count = 0;
+  return 0;
+}
+
+/**
+ * font_release_memory:
+ * @font: #font_t to work upon
+ *
+ * Frees the caches @font keeps, to recover memory.  They are rebuilt
+ * when used again.  To also free the tables and accelerators of the
+ * face, see face_release_memory().
+ *
+ * The caches are used without locking, so this must not be called while
+ * another thread might be using @font.
+ *
+ * Since: REPLACEME
+ **/
+void
+font_release_memory (font_t *font)
+{
+#ifndef HB_NO_MEMORY_USAGE
+  if (font->header.is_inert ())
+    return;
+
+#ifndef HB_NO_OT_FONT
+  ot_font_release_memory (font);
+#endif
+#endif
+}
+
 #ifndef HB_DISABLE_DEPRECATED
 /*
  * Deprecated get_glyph_func():
@@ -901,6 +901,45 @@ font_draw_glyph (font_t *font,
                     codepoint_t glyph,
                     draw_funcs_t *dfuncs, void *draw_data);
 
+HB_EXTERN bool_t
+font_draw_glyphs (font_t *font,
+		  unsigned int glyph_count,
+		  const codepoint_t *glyphs,
+		  unsigned int *verb_count, /* IN/OUT */
+		  uint8_t *verbs, /* OUT */
+		  unsigned int *coord_count, /* IN/OUT */
+		  float *coords, /* OUT */
+		  unsigned int *verb_offsets, /* OUT */
+		  unsigned int *coord_offsets /* OUT */);
+
+HB_EXTERN bool_t
+font_get_glyph_sdf (font_t *font,
+		    codepoint_t glyph,
+		    float x_origin, float y_origin,
+		    float spread,
+		    unsigned int width, unsigned int height,
+		    unsigned int stride,
+		    uint8_t *bitmap /* OUT */);
+
+HB_EXTERN void
+font_get_glyphs_sdf (font_t *font,
+		     unsigned int glyph_count,
+		     const codepoint_t *glyphs,
+		     const float *x_origins, const float *y_origins,
+		     float spread,
+		     unsigned int width, unsigned int height,
+		     unsigned int stride,
+		     uint8_t **bitmaps /* OUT */,
+		     unsigned int max_threads);
+
+HB_EXTERN bool_t
+font_get_glyph_a8 (font_t *font,
+		   codepoint_t glyph,
+		   float x_origin, float y_origin,
+		   unsigned int width, unsigned int height,
+		   unsigned int stride,
+		   uint8_t *bitmap /* OUT */);
+
 HB_EXTERN void
 font_paint_glyph (font_t *font,
                      codepoint_t glyph,
@@ -1148,6 +1187,15 @@ font_set_var_named_instance (font_t *font,
 HB_EXTERN unsigned int
 font_get_var_named_instance (font_t *font);
 
+HB_EXTERN unsigned int
+font_get_memory_usage (const font_t   *font,
+		       unsigned int    start_offset,
+		       unsigned int   *entry_count, /* IN/OUT */
+		       memory_usage_t *entries /* OUT */);
+
+HB_EXTERN void
+font_release_memory (font_t *font);
+
 HB_END_DECLS
 
 #endif /* HB_FONT_H */
@@ -717,4 +717,31 @@ struct font_t
 DECLARE_NULL_INSTANCE (font_t);
 
 
+#ifndef HB_NO_MEMORY_USAGE
+struct memory_usage_collector_t;
+
+/* For font_get_memory_usage() and font_release_memory(); these only act
+ * on fonts using the OpenType font functions.  See hb-ot-font.cc. */
+HB_INTERNAL void
+ot_font_get_memory_usage (const font_t *font,
+			  memory_usage_collector_t *c);
+
+HB_INTERNAL void
+ot_font_release_memory (font_t *font);
+#endif
+
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_OT_FONT)
+struct draw_path_buffer_t;
+
+/* For font_draw_glyphs(): draws glyph straight from the glyf, CFF2 or CFF
+ * table into path, without draw callbacks.  Returns false, having drawn
+ * nothing, for fonts not using the OpenType font functions, or needing
+ * emboldening or VARC, which go through callbacks.  See hb-ot-font.cc. */
+HB_INTERNAL bool
+ot_font_draw_glyph_to_path (font_t *font,
+			    codepoint_t glyph,
+			    draw_path_buffer_t *path);
+#endif
+
+
 #endif /* HB_FONT_HH */
@@ -115,6 +115,20 @@ struct hb_transform_t
     y += y0;
   }
 
+  /* Transforms count points stored as interleaved x, y pairs. */
+  void transform_points (float *coords, unsigned count) const
+  {
+    const float xx = this->xx, yx = this->yx;
+    const float xy = this->xy, yy = this->yy;
+    const float x0 = this->x0, y0 = this->y0;
+    for (unsigned i = 0; i < count; i++)
+    {
+      float x = coords[2 * i], y = coords[2 * i + 1];
+      coords[2 * i]     = xx * x + xy * y + x0;
+      coords[2 * i + 1] = yx * x + yy * y + y0;
+    }
+  }
+
   void transform_extents (hb_extents_t &extents) const
   {
     float quad_x[4], quad_y[4];
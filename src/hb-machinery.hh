@@ -196,6 +196,15 @@ struct hb_lazy_loader_t : hb_data_wrapper_t<Data, WheresData>
     do_destroy (p);
   }
 
+  /* Heap memory used by the instance, or zero if it is not loaded. */
+  unsigned get_memory_usage () const
+  {
+    Stored *p = this->instance.get_acquire ();
+    if (!p || p == Funcs::get_null ())
+      return 0;
+    return Funcs::memory_usage (p);
+  }
+
   static void do_destroy (Stored *p)
   {
     if (p && p != const_cast<Stored *> (Funcs::get_null ()))
@@ -248,6 +257,7 @@ struct hb_lazy_loader_t : hb_data_wrapper_t<Data, WheresData>
 
   /* To be possibly overloaded by subclasses. */
   static Returned* convert (Stored *p) { return p; }
+  static unsigned memory_usage (const Stored *p) { return sizeof (Stored) + heap_size (*p); }
 
   /* By default null/init/fini the object. */
   static const Stored* get_null () { return &Null (Stored); }
@@ -287,6 +297,86 @@ struct hb_face_lazy_loader_t : hb_lazy_loader_t<T,
   hb_blob_t *get_blob () { return this->get ()->get_blob (); }
 };
 
+/* Accelerators a face shares with its siblings; see face_create_sibling(). */
+HB_INTERNAL void *
+face_shared_tables_get_accelerator (hb_face_t *face, hb_tag_t tag,
+				    void *(*create) (hb_face_t *),
+				    void (*destroy) (void *),
+				    bool *shared /* OUT */);
+
+template <typename T>
+struct hb_face_shared_accelerator_t
+{
+  T *accel;
+  bool shared; /* Owned by the face's shared tables. */
+};
+
+/* Like hb_face_lazy_loader_t, for accelerators that only depend on their
+ * own table and the glyph count.  Those are built once for all the sibling
+ * faces that share the table, and owned by the shared tables; each face
+ * only holds a small record pointing at it. */
+template <typename T, unsigned int WheresFace>
+struct hb_face_shared_lazy_loader_t : hb_lazy_loader_t<T,
+						       hb_face_shared_lazy_loader_t<T, WheresFace>,
+						       hb_face_t, WheresFace,
+						       hb_face_shared_accelerator_t<T>>
+{
+  typedef hb_face_shared_accelerator_t<T> Stored;
+
+  static Stored *create (hb_face_t *face)
+  {
+    Stored *p = (Stored *) hb_calloc (1, sizeof (Stored));
+    if (unlikely (!p))
+      return nullptr;
+    p->accel = (T *) face_shared_tables_get_accelerator (face, T::tableTag,
+							 _create, _destroy,
+							 &p->shared);
+    if (unlikely (!p->accel))
+    {
+      hb_free (p);
+      return nullptr;
+    }
+    return p;
+  }
+  static void destroy (Stored *p)
+  {
+    if (!p->shared)
+      _destroy (p->accel);
+    hb_free (p);
+  }
+
+  static const T* convert (const Stored *p)
+  {
+    if (unlikely (!p)) return nullptr; /* Not loaded yet; see get_relaxed(). */
+    return likely (p->accel) ? p->accel : &Null (T);
+  }
+
+  /* Shared accelerators are accounted to none of the faces sharing them. */
+  static unsigned memory_usage (const Stored *p)
+  {
+    unsigned size = sizeof (Stored);
+    if (!p->shared)
+      size += sizeof (T) + heap_size (*p->accel);
+    return size;
+  }
+
+  hb_blob_t *get_blob () { return this->get ()->get_blob (); }
+
+  private:
+  static void *_create (hb_face_t *face)
+  {
+    T *p = (T *) hb_calloc (1, sizeof (T));
+    if (likely (p))
+      p = new (p) T (face);
+    return p;
+  }
+  static void _destroy (void *p)
+  {
+    ((T *) p)->~T ();
+    hb_free (p);
+  }
+};
+
 template <typename T, unsigned int WheresFace, bool core=false>
 struct hb_table_lazy_loader_t : hb_lazy_loader_t<T,
 						 hb_table_lazy_loader_t<T, WheresFace, core>,
@@ -31,6 +31,91 @@
 
 #include "hb-set.hh"
 
+#ifdef HB_MAP_SWISS_TABLE
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+      defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define HB_MAP_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+
+#ifdef HB_MAP_SWISS_TABLE
+/*
+ * hashmap_group_t
+ */
+
+/* Building with HB_MAP_SWISS_TABLE, which the map_swiss_table meson
+ * option sets, makes hashmap_t keep a control byte per item and probe a
+ * group of them at once, like Abseil's Swiss tables.  Control bytes of
+ * real items hold seven bits of the item hash; the others are EMPTY or
+ * DELETED, which have the top bit set.  Groups are scanned with SSE2 or
+ * NEON, or eight bytes at a time in a uint64_t.
+ *
+ * Match masks have one bit set for each matching byte, at bit
+ * (index << SHIFT); iterate over them by clearing the lowest set bit. */
+struct hashmap_group_t
+{
+  static constexpr uint8_t EMPTY = 0x80;
+  static constexpr uint8_t DELETED = 0xFE;
+
+#if defined(__SSE2__)
+  static constexpr unsigned WIDTH = 16;
+  static constexpr unsigned SHIFT = 0;
+
+  hashmap_group_t (const uint8_t *p) : v (_mm_loadu_si128 ((const __m128i *) p)) {}
+
+  uint64_t match (uint8_t tag) const
+  { return (unsigned) _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 ((char) tag))); }
+  uint64_t match_empty () const { return match (EMPTY); }
+  uint64_t match_free () const { return (unsigned) _mm_movemask_epi8 (v); }
+
+  __m128i v;
+#elif defined(HB_MAP_NEON)
+  static constexpr unsigned WIDTH = 8;
+  static constexpr unsigned SHIFT = 3;
+
+  hashmap_group_t (const uint8_t *p) : v (vld1_u8 (p)) {}
+
+  uint64_t match (uint8_t tag) const
+  { return vget_lane_u64 (vreinterpret_u64_u8 (vceq_u8 (v, vdup_n_u8 (tag))), 0) & MSBS; }
+  uint64_t match_empty () const { return match (EMPTY); }
+  uint64_t match_free () const
+  { return vget_lane_u64 (vreinterpret_u64_u8 (v), 0) & MSBS; }
+
+  uint8x8_t v;
+#else
+  static constexpr unsigned WIDTH = 8;
+  static constexpr unsigned SHIFT = 3;
+
+  hashmap_group_t (const uint8_t *p) : v (0)
+  {
+    for (unsigned i = 0; i < WIDTH; i++)
+      v |= (uint64_t) p[i] << (i * 8);
+  }
+
+  /* May have false positives above a real match; callers check the item. */
+  uint64_t match (uint8_t tag) const
+  {
+    uint64_t x = v ^ (LSBS * tag);
+    return (x - LSBS) & ~x & MSBS;
+  }
+  /* Exact: of the values with the top bit set, only EMPTY has bit 1 clear. */
+  uint64_t match_empty () const { return v & ~(v << 6) & MSBS; }
+  uint64_t match_free () const { return v & MSBS; }
+
+  uint64_t v;
+#endif
+
+  static unsigned index (uint64_t m) { return ctz (m) >> SHIFT; }
+
+  static constexpr uint64_t LSBS = 0x0101010101010101ull;
+  static constexpr uint64_t MSBS = 0x8080808080808080ull;
+};
+#endif
+
 
 /*
  * hashmap_t
@@ -54,6 +139,14 @@ struct hashmap_t
     if (item_t::is_trivial)
     {
       items = (item_t *) malloc (sizeof (item_t) * (o.mask + 1));
+#ifdef HB_MAP_SWISS_TABLE
+      ctrl = likely (items) ? (uint8_t *) malloc (o.mask + 1) : nullptr;
+      if (unlikely (!ctrl))
+      {
+	free (items);
+	items = nullptr;
+      }
+#endif
       if (unlikely (!items))
       {
 	successful = false;
@@ -65,6 +158,9 @@ struct hashmap_t
       prime = o.prime;
       max_chain_length = o.max_chain_length;
       memcpy (items, o.items, sizeof (item_t) * (mask + 1));
+#ifdef HB_MAP_SWISS_TABLE
+      memcpy (ctrl, o.ctrl, mask + 1);
+#endif
       return;
     }
 
@@ -144,6 +240,10 @@ struct hashmap_t
   unsigned int mask;
   unsigned int prime;
   item_t *items;
+#ifdef HB_MAP_SWISS_TABLE
+  uint8_t *ctrl; /* Control bytes, one per item. */
+  using group_t = hashmap_group_t;
+#endif
 
   friend void swap (hashmap_t& a, hashmap_t& b) noexcept
   {
@@ -155,6 +255,9 @@ struct hashmap_t
     swap (a.mask, b.mask);
     swap (a.prime, b.prime);
     swap (a.items, b.items);
+#ifdef HB_MAP_SWISS_TABLE
+    swap (a.ctrl, b.ctrl);
+#endif
   }
   void init ()
   {
@@ -166,6 +269,9 @@ struct hashmap_t
     mask = 0;
     prime = 0;
     items = nullptr;
+#ifdef HB_MAP_SWISS_TABLE
+    ctrl = nullptr;
+#endif
   }
   void fini ()
   {
@@ -180,6 +286,10 @@ struct hashmap_t
       free (items);
       items = nullptr;
     }
+#ifdef HB_MAP_SWISS_TABLE
+    free (ctrl);
+    ctrl = nullptr;
+#endif
     population = occupancy = 0;
   }
 
@@ -200,6 +310,15 @@ struct hashmap_t
     unsigned int power = bit_storage (max ((unsigned) population, new_population) * 2 + 8);
     unsigned int new_size = 1u << power;
     item_t *new_items = (item_t *) malloc ((size_t) new_size * sizeof (item_t));
+#ifdef HB_MAP_SWISS_TABLE
+    /* new_size is at least 16, a multiple of the group width. */
+    uint8_t *new_ctrl = likely (new_items) ? (uint8_t *) malloc (new_size) : nullptr;
+    if (unlikely (!new_ctrl))
+    {
+      free (new_items);
+      new_items = nullptr;
+    }
+#endif
     if (unlikely (!new_items))
     {
       successful = false;
@@ -210,6 +329,11 @@ struct hashmap_t
 	new (&_) item_t ();
     else
       memset (new_items, 0, (size_t) new_size * sizeof (item_t));
+#ifdef HB_MAP_SWISS_TABLE
+    memset (new_ctrl, group_t::EMPTY, new_size);
+    free (ctrl);
+    ctrl = new_ctrl;
+#endif
 
     unsigned int old_size = size ();
     item_t *old_items = items;
@@ -247,6 +371,21 @@ struct hashmap_t
     if (unlikely ((occupancy + occupancy / 2) >= mask && !alloc ())) return false;
 
     hash &= 0x3FFFFFFF; // We only store lower 30bit of hash
+#ifdef HB_MAP_SWISS_TABLE
+    unsigned length;
+    unsigned free_slot;
+    unsigned int i = find (key, hash, &free_slot, &length);
+    if (i != (unsigned) -1)
+    {
+      if (!overwrite)
+	return false;
+    }
+    else
+      i = free_slot;
+    ctrl[i] = tag (hash);
+
+    item_t &item = items[i];
+#else
     unsigned int tombstone = (unsigned int) -1;
     unsigned int i = hash % prime;
     unsigned length = 0;
@@ -268,6 +407,7 @@ struct hashmap_t
     }
 
     item_t &item = items[tombstone == (unsigned) -1 ? i : tombstone];
+#endif
 
     if (item.is_used ())
     {
@@ -326,6 +466,19 @@ struct hashmap_t
     {
       item->set_real (false);
       population--;
+#ifdef HB_MAP_SWISS_TABLE
+      /* Probes stop at the first group with an empty slot, so in such a
+       * group the slot can go back to empty instead of being a tombstone. */
+      unsigned i = item - items;
+      if (group_t (ctrl + i / group_t::WIDTH * group_t::WIDTH).match_empty ())
+      {
+	ctrl[i] = group_t::EMPTY;
+	item->set_used (false);
+	occupancy--;
+      }
+      else
+	ctrl[i] = group_t::DELETED;
+#endif
     }
   }
 
@@ -346,6 +499,10 @@ struct hashmap_t
   item_t *fetch_item (const K &key, uint32_t hash) const
   {
     hash &= 0x3FFFFFFF; // We only store lower 30bit of hash
+#ifdef HB_MAP_SWISS_TABLE
+    unsigned i = find (key, hash);
+    return i != (unsigned) -1 ? &items[i] : nullptr;
+#else
     unsigned int i = hash % prime;
     unsigned step = 0;
     while (items[i].is_used ())
@@ -361,7 +518,54 @@ struct hashmap_t
       i = (i + ++step) & mask;
     }
     return nullptr;
+#endif
   }
+#ifdef HB_MAP_SWISS_TABLE
+  /* The top seven of the 30 hash bits kept; multiplicative hashes mix
+   * those best. */
+  static uint8_t tag (uint32_t hash) { return hash >> 23; }
+
+  /* Returns the index of the real item for key, or -1.  If free_slot is
+   * given, also returns there the slot to insert key at if it's missing.
+   * length receives the number of extra groups probed. */
+  unsigned find (const K &key, uint32_t hash,
+		 unsigned *free_slot = nullptr,
+		 unsigned *length = nullptr) const
+  {
+    uint8_t t = tag (hash);
+    unsigned groups_mask = mask / group_t::WIDTH;
+    unsigned g = (hash % prime) / group_t::WIDTH;
+    unsigned step = 0;
+    if (free_slot) *free_slot = (unsigned) -1;
+    while (true)
+    {
+      unsigned base = g * group_t::WIDTH;
+      group_t group (ctrl + base);
+      for (uint64_t m = group.match (t); m; m &= m - 1)
+      {
+	unsigned i = base + group_t::index (m);
+	if (items[i].is_real () &&
+	    (std::is_integral<K>::value || items[i].hash == hash) &&
+	    items[i] == key)
+	{
+	  if (length) *length = step;
+	  return i;
+	}
+      }
+      if (free_slot && *free_slot == (unsigned) -1)
+      {
+	uint64_t m = group.match_free ();
+	if (m) *free_slot = base + group_t::index (m);
+      }
+      if (group.match_empty ())
+	break;
+      g = (g + ++step) & groups_mask;
+    }
+    if (length) *length = step;
+    return (unsigned) -1;
+  }
+#endif
+
   /* Projection. */
   const V& operator () (K k) const { return get (k); }
 
@@ -377,6 +581,10 @@ struct hashmap_t
       _.~item_t ();
       new (&_) item_t ();
     }
+#ifdef HB_MAP_SWISS_TABLE
+    if (ctrl)
+      memset (ctrl, group_t::EMPTY, size ());
+#endif
 
     population = occupancy = 0;
   }
@@ -407,6 +615,18 @@ struct hashmap_t
 
   unsigned int get_population () const { return population; }
 
+  /* Heap memory used, including that owned by the keys and values. */
+  unsigned get_memory_usage () const
+  {
+    unsigned size = this->size () * sizeof (item_t);
+#ifdef HB_MAP_SWISS_TABLE
+    size += this->size ();
+#endif
+    for (const item_t &item : iter_items ())
+      size += heap_size (item.key) + heap_size (item.value);
+    return size;
+  }
+
   void update (const hashmap_t &other)
   {
     if (unlikely (!successful)) return;
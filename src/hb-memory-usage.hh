@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef HB_MEMORY_USAGE_HH
+#define HB_MEMORY_USAGE_HH
+
+#include "hb.hh"
+
+#include "hb-vector.hh"
+
+
+/* Gathers memory usage for face_get_memory_usage() and
+ * font_get_memory_usage(), one entry per tag, in the order the tags are
+ * first added. */
+struct memory_usage_collector_t
+{
+  void add (tag_t tag, unsigned size)
+  {
+    if (!size) return;
+    for (memory_usage_t &entry : entries)
+      if (entry.tag == tag)
+      {
+	entry.size += size;
+	return;
+      }
+    entries.push (memory_usage_t {tag, size});
+  }
+
+  unsigned get_entries (unsigned int start_offset,
+			unsigned int *entry_count, /* IN/OUT */
+			memory_usage_t *out /* OUT */) const
+  {
+    if (entry_count)
+    {
+      + entries.as_array ().sub_array (start_offset, entry_count)
+      | sink (array (out, *entry_count))
+      ;
+    }
+    return entries.length;
+  }
+
+  vector_t<memory_usage_t> entries;
+};
+
+
+#endif /* HB_MEMORY_USAGE_HH */
@@ -249,6 +249,218 @@ static inline Type *object_create (Ts... ds)
 
   return obj;
 }
+
+
+/*
+ * Object pools
+ */
+
+#if !defined(HB_NO_OBJECT_POOL) && !defined(HB_NO_MT)
+#if defined(HAVE_PTHREAD) || defined(__APPLE__)
+#include <pthread.h>
+#define HB_OBJECT_POOL_PTHREAD
+#else
+/* No way to free a thread's cache when the thread exits. */
+#define HB_NO_OBJECT_POOL
+#endif
+#endif
+
+#ifndef HB_NO_OBJECT_POOL
+
+/* Per-thread caches of the memory of destroyed objects, for the types that
+ * get created and destroyed at high rates, like buffers, fonts and shape
+ * plans.  Creating one of those after destroying another on the same
+ * thread doesn't go to malloc.
+ *
+ * An object is cached by whichever thread destroys it, and cached blocks
+ * are freed when that thread exits.  That's why the blocks are malloc'ed
+ * one by one: pool_t hands out pieces of chunks the pool owns, which
+ * could not move between threads or outlive the pool.
+ *
+ * The caches hang off a pthread key rather than a thread_local, whose
+ * destructor would need C++ runtime support the library doesn't link.
+ * The key's destructor frees a cache when its thread exits; the thread
+ * calling exit (), or unloading the library, frees its own from
+ * atexit () and deletes the key, after which objects are just freed.  With HB_NO_MT there is a single cache, freed the same
+ * way. */
+template <typename Type>
+struct object_pool_t
+{
+  static constexpr unsigned MAX_CACHED = 8;
+
+  /* Returns zeroed memory for a Type, or nullptr. */
+  static Type *alloc ()
+  {
+    cache_t *c = get_cache (false);
+    block_t *block = c ? c->head : nullptr;
+    if (!block)
+      return (Type *) calloc (1, sizeof (Type));
+    c->head = block->next;
+    c->count--;
+    memset ((void *) block, 0, sizeof (Type));
+    return (Type *) (void *) block;
+  }
+
+  /* Takes memory from alloc(), or from malloc(), of a destructed Type. */
+  static void release (Type *obj)
+  {
+    cache_t *c = get_cache (true);
+    if (unlikely (!c || c->count >= MAX_CACHED))
+    {
+      free (obj);
+      return;
+    }
+    block_t *block = (block_t *) (void *) obj;
+    block->next = c->head;
+    c->head = block;
+    c->count++;
+  }
+
+  private:
+  struct block_t { block_t *next; };
+  static_assert (sizeof (Type) >= sizeof (block_t), "");
+
+  struct cache_t
+  {
+    block_t *head;
+    unsigned count;
+  };
+
+  static void free_cache (void *data)
+  {
+    cache_t *c = (cache_t *) data;
+    while (c->head)
+    {
+      block_t *next = c->head->next;
+      free (c->head);
+      c->head = next;
+    }
+    free (c);
+  }
+
+  static atomic_int_t finished;
+
+#ifdef HB_OBJECT_POOL_PTHREAD
+  static pthread_once_t key_once;
+  static pthread_key_t key;
+  static bool key_valid;
+
+  static void create_key ()
+  {
+    key_valid = !pthread_key_create (&key, free_cache);
+    if (key_valid)
+      atexit (free_exiting_cache);
+  }
+
+  static void free_exiting_cache ()
+  {
+    finished = 1;
+    cache_t *c = (cache_t *) pthread_getspecific (key);
+    if (c)
+    {
+      pthread_setspecific (key, nullptr);
+      free_cache (c);
+    }
+    /* Also runs when the library is unloaded; threads outliving it must
+     * not call into free_cache() then.  Their caches are leaked. */
+    pthread_key_delete (key);
+  }
+
+  static cache_t *get_cache (bool create)
+  {
+    if (unlikely (finished.get_relaxed ()))
+      return nullptr;
+    pthread_once (&key_once, create_key);
+    if (unlikely (!key_valid))
+      return nullptr;
+
+    cache_t *c = (cache_t *) pthread_getspecific (key);
+    if (!c && create)
+    {
+      c = (cache_t *) calloc (1, sizeof (cache_t));
+      if (unlikely (c && pthread_setspecific (key, c)))
+      {
+	free (c);
+	c = nullptr;
+      }
+    }
+    return c;
+  }
+#else
+  static cache_t *cache;
+
+  static void free_exiting_cache ()
+  {
+    finished = 1;
+    if (cache)
+    {
+      free_cache (cache);
+      cache = nullptr;
+    }
+  }
+
+  static cache_t *get_cache (bool create)
+  {
+    if (unlikely (finished.get_relaxed ()))
+      return nullptr;
+    if (!cache && create)
+    {
+      cache = (cache_t *) calloc (1, sizeof (cache_t));
+      if (cache)
+	atexit (free_exiting_cache);
+    }
+    return cache;
+  }
+#endif
+};
+template <typename Type>
+atomic_int_t object_pool_t<Type>::finished;
+#ifdef HB_OBJECT_POOL_PTHREAD
+template <typename Type>
+pthread_once_t object_pool_t<Type>::key_once = PTHREAD_ONCE_INIT;
+template <typename Type>
+pthread_key_t object_pool_t<Type>::key;
+template <typename Type>
+bool object_pool_t<Type>::key_valid;
+#else
+template <typename Type>
+typename object_pool_t<Type>::cache_t *object_pool_t<Type>::cache;
+#endif
+
+#endif
+
+/* Like object_create(), but reusing memory cached by object_pool_t.
+ * Release the memory with object_free_pooled(); plain free() works too,
+ * just without caching it. */
+template <typename Type, typename ...Ts>
+static inline Type *object_create_pooled (Ts... ds)
+{
+#ifndef HB_NO_OBJECT_POOL
+  Type *obj = object_pool_t<Type>::alloc ();
+
+  if (unlikely (!obj))
+    return obj;
+
+  new (obj) Type (std::forward<Ts> (ds)...);
+
+  object_init (obj);
+  object_trace (obj, HB_FUNC);
+
+  return obj;
+#else
+  return object_create<Type> (std::forward<Ts> (ds)...);
+#endif
+}
+template <typename Type>
+static inline void object_free_pooled (Type *obj)
+{
+#ifndef HB_NO_OBJECT_POOL
+  object_pool_t<Type>::release (obj);
+#else
+  free (obj);
+#endif
+}
+
 template <typename Type>
 static inline void object_init (Type *obj)
 {
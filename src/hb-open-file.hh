@@ -197,6 +197,22 @@ typedef struct OpenTypeOffsetTable
     return_trace (true);
   }
 
+  /* Serializes just the header and table directory; the caller writes the
+   * table data at the offsets in records. */
+  bool serialize_directory (hb_serialize_context_t *c,
+			    hb_tag_t sfnt_tag,
+			    hb_array_t<const TableRecord> records)
+  {
+    TRACE_SERIALIZE (this);
+    if (unlikely (!c->extend_min (this))) return_trace (false);
+    sfnt_version = sfnt_tag;
+    if (unlikely (!tables.serialize (c, records.length))) return_trace (false);
+    for (unsigned i = 0; i < records.length; i++)
+      tables.arrayZ[i] = records.arrayZ[i];
+    tables.qsort ();
+    return_trace (true);
+  }
+
   bool sanitize (hb_sanitize_context_t *c) const
   {
     TRACE_SANITIZE (this);
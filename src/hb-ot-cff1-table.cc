@@ -443,12 +443,11 @@ bool OT::cff1::accelerator_t::get_extents (font_t *font, codepoint_t glyph, glyp
 
 struct cff1_path_param_t
 {
-  cff1_path_param_t (const OT::cff1::accelerator_t *cff_, font_t *font_,
-		     draw_session_t &draw_session_, point_t *delta_)
+  cff1_path_param_t (const OT::cff1::accelerator_t *cff_,
+		     cs_path_t &path_, point_t *delta_)
   {
-    draw_session = &draw_session_;
+    path = &path_;
     cff = cff_;
-    font = font_;
     delta = delta_;
   }
 
@@ -456,14 +455,14 @@ struct cff1_path_param_t
   {
     point_t point = p;
     if (delta) point.move (*delta);
-    draw_session->move_to (font->em_fscalef_x (point.x.to_real ()), font->em_fscalef_y (point.y.to_real ()));
+    path->move_to (point.x.to_real (), point.y.to_real ());
   }
 
   void line_to (const point_t &p)
   {
     point_t point = p;
     if (delta) point.move (*delta);
-    draw_session->line_to (font->em_fscalef_x (point.x.to_real ()), font->em_fscalef_y (point.y.to_real ()));
+    path->line_to (point.x.to_real (), point.y.to_real ());
   }
 
   void cubic_to (const point_t &p1, const point_t &p2, const point_t &p3)
@@ -475,15 +474,14 @@ struct cff1_path_param_t
       point2.move (*delta);
       point3.move (*delta);
     }
-    draw_session->cubic_to (font->em_fscalef_x (point1.x.to_real ()), font->em_fscalef_y (point1.y.to_real ()),
-			   font->em_fscalef_x (point2.x.to_real ()), font->em_fscalef_y (point2.y.to_real ()),
-			   font->em_fscalef_x (point3.x.to_real ()), font->em_fscalef_y (point3.y.to_real ()));
+    path->cubic_to (point1.x.to_real (), point1.y.to_real (),
+		    point2.x.to_real (), point2.y.to_real (),
+		    point3.x.to_real (), point3.y.to_real ());
   }
 
-  void end_path () { draw_session->close_path (); }
+  void end_path () { path->close_path (); }
 
-  font_t *font;
-  draw_session_t *draw_session;
+  cs_path_t *path;
   point_t *delta;
 
   const OT::cff1::accelerator_t *cff;
@@ -510,8 +508,8 @@ struct cff1_path_procs_path_t : path_procs_t<cff1_path_procs_path_t, cff1_cs_int
   }
 };
 
-static bool _get_path (const OT::cff1::accelerator_t *cff, font_t *font, codepoint_t glyph,
-		       draw_session_t &draw_session, bool in_seac = false, point_t *delta = nullptr);
+static bool _get_path (const OT::cff1::accelerator_t *cff, codepoint_t glyph,
+		       cs_path_t &path, bool in_seac = false, point_t *delta = nullptr);
 
 struct cff1_cs_opset_path_t : cff1_cs_opset_t<cff1_cs_opset_path_t, cff1_path_param_t, cff1_path_procs_path_t>
 {
@@ -528,14 +526,14 @@ struct cff1_cs_opset_path_t : cff1_cs_opset_t<cff1_cs_opset_path_t, cff1_path_pa
     codepoint_t accent = param.cff->std_code_to_glyph (env.argStack[n-1].to_int ());
 
     if (unlikely (!(!env.in_seac && base && accent
-		    && _get_path (param.cff, param.font, base, *param.draw_session, true)
-		    && _get_path (param.cff, param.font, accent, *param.draw_session, true, &delta))))
+		    && _get_path (param.cff, base, *param.path, true)
+		    && _get_path (param.cff, accent, *param.path, true, &delta))))
       env.set_error ();
   }
 };
 
-bool _get_path (const OT::cff1::accelerator_t *cff, font_t *font, codepoint_t glyph,
-		draw_session_t &draw_session, bool in_seac, point_t *delta)
+bool _get_path (const OT::cff1::accelerator_t *cff, codepoint_t glyph,
+		cs_path_t &path, bool in_seac, point_t *delta)
 {
   if (unlikely (!cff->is_valid () || (glyph >= cff->num_glyphs))) return false;
 
@@ -544,7 +542,7 @@ bool _get_path (const OT::cff1::accelerator_t *cff, font_t *font, codepoint_t gl
   cff1_cs_interp_env_t env (str, *cff, fd);
   env.set_in_seac (in_seac);
   cff1_cs_interpreter_t<cff1_cs_opset_path_t, cff1_path_param_t> interp (env);
-  cff1_path_param_t param (cff, font, draw_session, delta);
+  cff1_path_param_t param (cff, path, delta);
   if (unlikely (!interp.interpret (param))) return false;
 
   /* Let's end the path specially since it is called inside seac also */
@@ -569,7 +567,28 @@ bool OT::cff1::accelerator_t::get_path (font_t *font, codepoint_t glyph, draw_se
   return true;
 #endif
 
-  return _get_path (this, font, glyph, draw_session);
+#ifndef HB_NO_CFF_PATH_CACHE
+  cs_path_cache_t::ref_t cached = path_cache.get (glyph);
+  if (cached)
+  {
+    cached->replay (font, draw_session);
+    return true;
+  }
+#endif
+
+  cs_path_t path;
+  if (unlikely (!_get_path (this, glyph, path) || path.in_error ())) return false;
+#ifndef HB_NO_CFF_PATH_CACHE
+  cached = path_cache.set (glyph, path);
+  if (cached)
+  {
+    cached->replay (font, draw_session);
+    return true;
+  }
+#endif
+
+  path.replay (font, draw_session);
+  return true;
 }
 
 struct get_seac_param_t
@@ -30,6 +30,7 @@
 #include "hb-ot-cff-common.hh"
 #include "hb-subset-cff-common.hh"
 #include "hb-draw.hh"
+#include "hb-cff-path.hh"
 #include "hb-paint.hh"
 
 #define HB_STRING_ARRAY_NAME cff1_std_strings
@@ -1219,6 +1220,13 @@ struct cff1
 
     blob_t *get_blob () const { return blob; }
 
+    unsigned get_memory_usage () const
+    {
+      return topDict.get_memory_usage () +
+	     fontDicts.get_memory_usage () +
+	     privateDicts.get_memory_usage ();
+    }
+
     bool is_valid () const { return blob; }
     bool   is_CID () const { return topDict.is_CID (); }
 
@@ -1374,6 +1382,17 @@ struct cff1
       }
     }
 
+    unsigned get_memory_usage () const
+    {
+      unsigned size = SUPER::get_memory_usage ();
+      if (const sorted_vector_t<gname_t> *names = glyph_names.get_acquire ())
+	size += sizeof (*names) + names->get_memory_usage ();
+#ifndef HB_NO_CFF_PATH_CACHE
+      size += path_cache.get_memory_usage ();
+#endif
+      return size;
+    }
+
     bool get_glyph_name (codepoint_t glyph,
 			 char *buf, unsigned int buf_len) const
     {
@@ -1486,6 +1505,10 @@ struct cff1
 
     mutable atomic_ptr_t<sorted_vector_t<gname_t>> glyph_names;
 
+#ifndef HB_NO_CFF_PATH_CACHE
+    mutable cs_path_cache_t path_cache;
+#endif
+
     typedef accelerator_templ_t<cff1_private_dict_opset_t, cff1_private_dict_values_t> SUPER;
   };
 
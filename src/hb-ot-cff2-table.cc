@@ -154,28 +154,26 @@ bool OT::cff2::accelerator_t::paint_glyph (font_t *font, codepoint_t glyph, pain
 
 struct cff2_path_param_t
 {
-  cff2_path_param_t (font_t *font_, draw_session_t &draw_session_)
+  cff2_path_param_t (cs_path_t &path_)
   {
-    draw_session = &draw_session_;
-    font = font_;
+    path = &path_;
   }
 
   void move_to (const point_t &p)
-  { draw_session->move_to (font->em_fscalef_x (p.x.to_real ()), font->em_fscalef_y (p.y.to_real ())); }
+  { path->move_to (p.x.to_real (), p.y.to_real ()); }
 
   void line_to (const point_t &p)
-  { draw_session->line_to (font->em_fscalef_x (p.x.to_real ()), font->em_fscalef_y (p.y.to_real ())); }
+  { path->line_to (p.x.to_real (), p.y.to_real ()); }
 
   void cubic_to (const point_t &p1, const point_t &p2, const point_t &p3)
   {
-    draw_session->cubic_to (font->em_fscalef_x (p1.x.to_real ()), font->em_fscalef_y (p1.y.to_real ()),
-			   font->em_fscalef_x (p2.x.to_real ()), font->em_fscalef_y (p2.y.to_real ()),
-			   font->em_fscalef_x (p3.x.to_real ()), font->em_fscalef_y (p3.y.to_real ()));
+    path->cubic_to (p1.x.to_real (), p1.y.to_real (),
+		    p2.x.to_real (), p2.y.to_real (),
+		    p3.x.to_real (), p3.y.to_real ());
   }
 
   protected:
-  draw_session_t *draw_session;
-  font_t *font;
+  cs_path_t *path;
 };
 
 struct cff2_path_procs_path_t : path_procs_t<cff2_path_procs_path_t, cff2_cs_interp_env_t<number_t>, cff2_path_param_t>
@@ -215,12 +213,32 @@ bool OT::cff2::accelerator_t::get_path_at (font_t *font, codepoint_t glyph, draw
 
   if (unlikely (!is_valid () || (glyph >= num_glyphs))) return false;
 
+#ifndef HB_NO_CFF_PATH_CACHE
+  bool cacheable = !coords.length;
+  cs_path_cache_t::ref_t cached;
+  if (cacheable && (cached = path_cache.get (glyph)))
+  {
+    cached->replay (font, draw_session);
+    return true;
+  }
+#endif
+
+  cs_path_t path;
   unsigned int fd = fdSelect->get_fd (glyph);
   const ubytes_t str = (*charStrings)[glyph];
   cff2_cs_interp_env_t<number_t> env (str, *this, fd, coords.arrayZ, coords.length);
   cff2_cs_interpreter_t<cff2_cs_opset_path_t, cff2_path_param_t, number_t> interp (env);
-  cff2_path_param_t param (font, draw_session);
-  if (unlikely (!interp.interpret (param))) return false;
+  cff2_path_param_t param (path);
+  if (unlikely (!interp.interpret (param) || path.in_error ())) return false;
+#ifndef HB_NO_CFF_PATH_CACHE
+  if (cacheable && (cached = path_cache.set (glyph, path)))
+  {
+    cached->replay (font, draw_session);
+    return true;
+  }
+#endif
+
+  path.replay (font, draw_session);
   return true;
 }
 
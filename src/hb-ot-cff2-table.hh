@@ -30,6 +30,7 @@
 #include "hb-ot-cff-common.hh"
 #include "hb-subset-cff-common.hh"
 #include "hb-draw.hh"
+#include "hb-cff-path.hh"
 #include "hb-paint.hh"
 
 namespace CFF {
@@ -490,6 +491,13 @@ struct cff2
 
     blob_t *get_blob () const { return blob; }
 
+    unsigned get_memory_usage () const
+    {
+      return topDict.get_memory_usage () +
+	     fontDicts.get_memory_usage () +
+	     privateDicts.get_memory_usage ();
+    }
+
     bool is_valid () const { return blob; }
 
     protected:
@@ -515,12 +523,27 @@ struct cff2
   {
     accelerator_t (face_t *face) : accelerator_templ_t (face) {}
 
+    unsigned get_memory_usage () const
+    {
+#ifndef HB_NO_CFF_PATH_CACHE
+      return accelerator_templ_t::get_memory_usage () + path_cache.get_memory_usage ();
+#else
+      return accelerator_templ_t::get_memory_usage ();
+#endif
+    }
+
     HB_INTERNAL bool get_extents (font_t *font,
 				  codepoint_t glyph,
 				  glyph_extents_t *extents) const;
     HB_INTERNAL bool paint_glyph (font_t *font, codepoint_t glyph, paint_funcs_t *funcs, void *data, color_t foreground) const;
     HB_INTERNAL bool get_path (font_t *font, codepoint_t glyph, draw_session_t &draw_session) const;
     HB_INTERNAL bool get_path_at (font_t *font, codepoint_t glyph, draw_session_t &draw_session, array_t<const int> coords) const;
+
+    private:
+#ifndef HB_NO_CFF_PATH_CACHE
+    /* Default-instance paths only; blended ones depend on coords. */
+    mutable cs_path_cache_t path_cache;
+#endif
   };
 
   struct accelerator_subset_t : accelerator_templ_t<cff2_private_dict_opset_subset_t, cff2_private_dict_values_subset_t>
@@ -42,6 +42,12 @@
 #define _HB_OT_ACCELERATOR_UNDEF
 #endif
 
+/* Accelerators that sibling faces can share; see face_create_sibling(). */
+#ifndef HB_OT_SHARED_ACCELERATOR
+#define HB_OT_SHARED_ACCELERATOR(Namespace, Type) HB_OT_ACCELERATOR (Namespace, Type)
+#define _HB_OT_SHARED_ACCELERATOR_UNDEF
+#endif
+
 
 /* This lists font tables that the hb_face_t will contain and lazily
  * load.  Don't add a table unless it's used though.  This is not
@@ -85,8 +91,8 @@ HB_OT_ACCELERATOR (OT, glyf)
 
 /* CFF outlines. */
 #ifndef HB_NO_CFF
-HB_OT_ACCELERATOR (OT, cff1)
-HB_OT_ACCELERATOR (OT, cff2)
+HB_OT_SHARED_ACCELERATOR (OT, cff1)
+HB_OT_SHARED_ACCELERATOR (OT, cff2)
 #endif
 
 /* OpenType variations. */
@@ -109,8 +115,8 @@ HB_OT_ACCELERATOR (OT, kern)
 /* OpenType shaping. */
 #ifndef HB_NO_OT_LAYOUT
 HB_OT_ACCELERATOR (OT, GDEF)
-HB_OT_ACCELERATOR (OT, GSUB)
-HB_OT_ACCELERATOR (OT, GPOS)
+HB_OT_SHARED_ACCELERATOR (OT, GSUB)
+HB_OT_SHARED_ACCELERATOR (OT, GPOS)
 //HB_OT_CORE_TABLE (OT, JSTF)
 #endif
 
@@ -146,6 +152,10 @@ HB_OT_CORE_TABLE (OT, MATH)
 #endif
 
 
+#ifdef _HB_OT_SHARED_ACCELERATOR_UNDEF
+#undef HB_OT_SHARED_ACCELERATOR
+#endif
+
 #ifdef _HB_OT_ACCELERATOR_UNDEF
 #undef HB_OT_ACCELERATOR
 #endif
@@ -44,6 +44,31 @@
 #include "hb-aat-layout-kerx-table.hh"
 #include "hb-aat-layout-morx-table.hh"
 
+#ifndef HB_NO_MEMORY_USAGE
+/* For the tags of the remaining tables. */
+#include "hb-memory-usage.hh"
+#include "hb-ot-head-table.hh"
+#include "hb-ot-maxp-table.hh"
+#include "hb-ot-hhea-table.hh"
+#include "hb-ot-os2-table.hh"
+#include "hb-ot-stat-table.hh"
+#include "hb-ot-vorg-table.hh"
+#include "hb-ot-var-fvar-table.hh"
+#include "hb-ot-var-avar-table.hh"
+#include "hb-ot-var-cvar-table.hh"
+#include "hb-ot-var-gvar-table.hh"
+#include "hb-ot-var-mvar-table.hh"
+#include "hb-ot-var-varc-table.hh"
+#include "hb-ot-layout-base-table.hh"
+#include "hb-ot-math-table.hh"
+#include "hb-aat-layout-ankr-table.hh"
+#include "hb-aat-layout-trak-table.hh"
+#include "hb-aat-layout-feat-table.hh"
+#include "hb-aat-ltag-table.hh"
+#include "OT/Color/COLR/COLR.hh"
+#include "OT/Color/CPAL/CPAL.hh"
+#endif
+
 
 void hb_ot_face_t::init0 (hb_face_t *face)
 {
@@ -58,3 +83,18 @@ void hb_ot_face_t::fini ()
 #include "hb-ot-face-table-list.hh"
 #undef HB_OT_TABLE
 }
+
+#ifndef HB_NO_MEMORY_USAGE
+void hb_ot_face_t::get_memory_usage (memory_usage_collector_t *c) const
+{
+#define HB_OT_TABLE(Namespace, Type) c->add (Namespace::Type::tableTag, Type.get_memory_usage ());
+#include "hb-ot-face-table-list.hh"
+#undef HB_OT_TABLE
+}
+void hb_ot_face_t::release ()
+{
+#define HB_OT_TABLE(Namespace, Type) Type.free_instance ();
+#include "hb-ot-face-table-list.hh"
+#undef HB_OT_TABLE
+}
+#endif
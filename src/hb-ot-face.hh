@@ -45,11 +45,20 @@
 #undef HB_OT_ACCELERATOR
 #undef HB_OT_TABLE
 
+struct memory_usage_collector_t;
+
 struct hb_ot_face_t
 {
   HB_INTERNAL void init0 (hb_face_t *face);
   HB_INTERNAL void fini ();
 
+#ifndef HB_NO_MEMORY_USAGE
+  HB_INTERNAL void get_memory_usage (memory_usage_collector_t *c) const;
+  /* Frees all loaded tables and accelerators; they get loaded again on
+   * next use.  Only safe if no other thread is using the face. */
+  HB_INTERNAL void release ();
+#endif
+
 #define HB_OT_TABLE_ORDER(Namespace, Type) \
     HB_PASTE (ORDER_, HB_PASTE (Namespace, HB_PASTE (_, Type)))
   enum order_t
@@ -67,7 +76,14 @@ struct hb_ot_face_t
   hb_table_lazy_loader_t<Namespace::Type, HB_OT_TABLE_ORDER (Namespace, Type), true> Type;
 #define HB_OT_ACCELERATOR(Namespace, Type) \
   hb_face_lazy_loader_t<Namespace::Type##_accelerator_t, HB_OT_TABLE_ORDER (Namespace, Type)> Type;
+#ifndef HB_NO_FACE_SHARED_TABLES
+#define HB_OT_SHARED_ACCELERATOR(Namespace, Type) \
+  hb_face_shared_lazy_loader_t<Namespace::Type##_accelerator_t, HB_OT_TABLE_ORDER (Namespace, Type)> Type;
+#endif
 #include "hb-ot-face-table-list.hh"
+#ifndef HB_NO_FACE_SHARED_TABLES
+#undef HB_OT_SHARED_ACCELERATOR
+#endif
 #undef HB_OT_ACCELERATOR
 #undef HB_OT_CORE_TABLE
 #undef HB_OT_TABLE
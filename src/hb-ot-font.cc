@@ -33,6 +33,7 @@
 #include "hb-cache.hh"
 #include "hb-font.hh"
 #include "hb-machinery.hh"
+#include "hb-memory-usage.hh"
 #include "hb-ot-face.hh"
 #include "hb-outline.hh"
 
@@ -69,6 +70,52 @@ using ot_font_advance_cache_t = cache_t<24, 16, 8, true>;
 static user_data_key_t ot_font_cmap_cache_user_data_key;
 #endif
 
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+/* Direct-mapped cache of final, scaled glyph extents.  Only valid for
+ * one font state; dropped whenever font_t::serial changes, which covers
+ * scale, variation coordinates, slant and emboldening. */
+struct ot_font_extents_cache_t
+{
+  static constexpr unsigned SIZE = 256;
+
+  bool get (codepoint_t glyph, unsigned serial, glyph_extents_t *extents) const
+  {
+    lock_t l (lock);
+
+    if (serial != font_serial) return false;
+    const item_t &item = items[glyph % SIZE];
+    if (item.glyph != glyph) return false;
+    *extents = item.extents;
+    return true;
+  }
+
+  void set (codepoint_t glyph, unsigned serial, const glyph_extents_t &extents)
+  {
+    lock_t l (lock);
+
+    if (serial != font_serial)
+    {
+      for (auto &item : items)
+	item.glyph = HB_CODEPOINT_INVALID;
+      font_serial = serial;
+    }
+    item_t &item = items[glyph % SIZE];
+    item.glyph = glyph;
+    item.extents = extents;
+  }
+
+  struct item_t
+  {
+    codepoint_t glyph = HB_CODEPOINT_INVALID;
+    glyph_extents_t extents;
+  };
+
+  mutable mutex_t lock; /* Protects members below. */
+  unsigned font_serial = 0;
+  item_t items[SIZE];
+};
+#endif
+
 struct ot_font_t
 {
   const ot_face_t *ot_face;
@@ -80,6 +127,28 @@ struct ot_font_t
   /* h_advance caching */
   mutable atomic_int_t cached_coords_serial;
   mutable atomic_ptr_t<ot_font_advance_cache_t> advance_cache;
+
+#ifndef HB_NO_OT_FONT_OUTLINE_CACHE
+  /* Decoded glyf outlines, for drawing and extents. */
+  mutable atomic_ptr_t<OT::glyf_impl::outline_cache_t> outline_cache;
+#endif
+
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+  mutable atomic_ptr_t<ot_font_extents_cache_t> extents_cache;
+#endif
+
+#if !defined(HB_NO_PAINT) && !defined(HB_NO_OT_FONT_PAINT_CACHE)
+  /* Recorded COLR paint programs. */
+  mutable atomic_ptr_t<paint_program_cache_t> paint_cache;
+#endif
+
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_VAR_COMPOSITES) && !defined(HB_NO_OT_FONT_VARC_CACHE)
+  /* Outlines of plain glyphs used as VARC components. */
+  mutable atomic_ptr_t<OT::component_cache_t> varc_cache;
+#endif
+
+  /* Set by ot_font_set_approximate_extents(). */
+  bool approximate_extents;
 };
 
 static ot_font_t *
@@ -123,17 +192,167 @@ _ot_font_create (font_t *font)
   return ot_font;
 }
 
+/* Frees the lazily-created caches; they get created again on next use. */
+static void
+_ot_font_free_caches (ot_font_t *ot_font)
+{
+  auto *cache = ot_font->advance_cache.get_relaxed ();
+  ot_font->advance_cache.set_relaxed (nullptr);
+  free (cache);
+
+#ifndef HB_NO_OT_FONT_OUTLINE_CACHE
+  auto *outline_cache = ot_font->outline_cache.get_relaxed ();
+  ot_font->outline_cache.set_relaxed (nullptr);
+  if (outline_cache)
+  {
+    outline_cache->~outline_cache_t ();
+    free (outline_cache);
+  }
+#endif
+
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+  auto *extents_cache = ot_font->extents_cache.get_relaxed ();
+  ot_font->extents_cache.set_relaxed (nullptr);
+  if (extents_cache)
+  {
+    extents_cache->~ot_font_extents_cache_t ();
+    free (extents_cache);
+  }
+#endif
+
+#if !defined(HB_NO_PAINT) && !defined(HB_NO_OT_FONT_PAINT_CACHE)
+  auto *paint_cache = ot_font->paint_cache.get_relaxed ();
+  ot_font->paint_cache.set_relaxed (nullptr);
+  if (paint_cache)
+  {
+    paint_cache->~paint_program_cache_t ();
+    free (paint_cache);
+  }
+#endif
+
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_VAR_COMPOSITES) && !defined(HB_NO_OT_FONT_VARC_CACHE)
+  auto *varc_cache = ot_font->varc_cache.get_relaxed ();
+  ot_font->varc_cache.set_relaxed (nullptr);
+  if (varc_cache)
+  {
+    varc_cache->~component_cache_t ();
+    free (varc_cache);
+  }
+#endif
+}
+
 static void
 _ot_font_destroy (void *font_data)
 {
   ot_font_t *ot_font = (ot_font_t *) font_data;
 
-  auto *cache = ot_font->advance_cache.get_relaxed ();
-  free (cache);
+  _ot_font_free_caches (ot_font);
 
   free (ot_font);
 }
 
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+static ot_font_extents_cache_t *
+_ot_font_get_extents_cache (const ot_font_t *ot_font)
+{
+retry:
+  auto *cache = ot_font->extents_cache.get_acquire ();
+  if (unlikely (!cache))
+  {
+    cache = (ot_font_extents_cache_t *) malloc (sizeof (ot_font_extents_cache_t));
+    if (unlikely (!cache))
+      return nullptr;
+    new (cache) ot_font_extents_cache_t;
+
+    if (unlikely (!ot_font->extents_cache.cmpexch (nullptr, cache)))
+    {
+      cache->~ot_font_extents_cache_t ();
+      free (cache);
+      goto retry;
+    }
+  }
+  return cache;
+}
+#endif
+
+#if !defined(HB_NO_PAINT) && !defined(HB_NO_OT_FONT_PAINT_CACHE)
+static paint_program_cache_t *
+_ot_font_get_paint_cache (const ot_font_t *ot_font)
+{
+retry:
+  auto *cache = ot_font->paint_cache.get_acquire ();
+  if (unlikely (!cache))
+  {
+    cache = (paint_program_cache_t *) malloc (sizeof (paint_program_cache_t));
+    if (unlikely (!cache))
+      return nullptr;
+    new (cache) paint_program_cache_t;
+
+    if (unlikely (!ot_font->paint_cache.cmpexch (nullptr, cache)))
+    {
+      cache->~paint_program_cache_t ();
+      free (cache);
+      goto retry;
+    }
+  }
+  return cache;
+}
+#endif
+
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_VAR_COMPOSITES)
+static OT::component_cache_t *
+_ot_font_get_varc_cache (const ot_font_t *ot_font)
+{
+#ifndef HB_NO_OT_FONT_VARC_CACHE
+retry:
+  auto *cache = ot_font->varc_cache.get_acquire ();
+  if (unlikely (!cache))
+  {
+    cache = (OT::component_cache_t *) malloc (sizeof (OT::component_cache_t));
+    if (unlikely (!cache))
+      return nullptr;
+    new (cache) OT::component_cache_t;
+
+    if (unlikely (!ot_font->varc_cache.cmpexch (nullptr, cache)))
+    {
+      cache->~component_cache_t ();
+      free (cache);
+      goto retry;
+    }
+  }
+  return cache;
+#else
+  return nullptr;
+#endif
+}
+#endif
+
+static OT::glyf_impl::outline_cache_t *
+_ot_font_get_outline_cache (const ot_font_t *ot_font)
+{
+#ifndef HB_NO_OT_FONT_OUTLINE_CACHE
+retry:
+  auto *cache = ot_font->outline_cache.get_acquire ();
+  if (unlikely (!cache))
+  {
+    cache = (OT::glyf_impl::outline_cache_t *) malloc (sizeof (OT::glyf_impl::outline_cache_t));
+    if (unlikely (!cache))
+      return nullptr;
+    new (cache) OT::glyf_impl::outline_cache_t;
+
+    if (unlikely (!ot_font->outline_cache.cmpexch (nullptr, cache)))
+    {
+      cache->~outline_cache_t ();
+      free (cache);
+      goto retry;
+    }
+  }
+  return cache;
+#else
+  return nullptr;
+#endif
+}
+
 static bool_t
 ot_get_nominal_glyph (font_t *font HB_UNUSED,
 			 void *font_data,
@@ -418,14 +637,12 @@ ot_get_glyph_v_origin (font_t *font,
 }
 #endif
 
-static bool_t
-ot_get_glyph_extents (font_t *font,
-			 void *font_data,
-			 codepoint_t glyph,
-			 glyph_extents_t *extents,
-			 void *user_data HB_UNUSED)
+static bool
+_ot_get_glyph_extents (font_t *font,
+			  const ot_font_t *ot_font,
+			  codepoint_t glyph,
+			  glyph_extents_t *extents)
 {
-  const ot_font_t *ot_font = (const ot_font_t *) font_data;
   const ot_face_t *ot_face = ot_font->ot_face;
 
 #if !defined(HB_NO_OT_FONT_BITMAP) && !defined(HB_NO_COLOR)
@@ -433,9 +650,20 @@ ot_get_glyph_extents (font_t *font,
   if (ot_face->CBDT->get_extents (font, glyph, extents)) return true;
 #endif
 #if !defined(HB_NO_COLOR) && !defined(HB_NO_PAINT)
+#ifndef HB_NO_OT_FONT_PAINT_CACHE
+  const OT::COLR &colr = *ot_face->COLR;
+  if (colr.get_extents (font, glyph, extents,
+			colr.has_v1_data () ? _ot_font_get_paint_cache (ot_font) : nullptr)) return true;
+#else
   if (ot_face->COLR->get_extents (font, glyph, extents)) return true;
 #endif
-  if (ot_face->glyf->get_extents (font, glyph, extents)) return true;
+#endif
+  if (ot_font->approximate_extents && font->num_coords &&
+      ot_face->glyf->get_extents_approximate (font, glyph, extents))
+    return true;
+  if (ot_face->glyf->get_extents (font, glyph, extents,
+				  font->num_coords ? _ot_font_get_outline_cache (ot_font) : nullptr))
+    return true;
 #ifndef HB_NO_OT_FONT_CFF
   if (ot_face->cff2->get_extents (font, glyph, extents)) return true;
   if (ot_face->cff1->get_extents (font, glyph, extents)) return true;
@@ -444,6 +672,41 @@ ot_get_glyph_extents (font_t *font,
   return false;
 }
 
+static bool_t
+ot_get_glyph_extents (font_t *font,
+			 void *font_data,
+			 codepoint_t glyph,
+			 glyph_extents_t *extents,
+			 void *user_data HB_UNUSED)
+{
+  const ot_font_t *ot_font = (const ot_font_t *) font_data;
+
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+  /* Extents of static glyf glyphs come straight from the glyph header;
+   * only cache the expensive cases. */
+  ot_font_extents_cache_t *cache = nullptr;
+  if (font->num_coords || !ot_font->ot_face->glyf->has_data ()
+#if !defined(HB_NO_COLOR) && !defined(HB_NO_PAINT)
+      || ot_font->ot_face->COLR->has_v1_data ()
+#endif
+     )
+  {
+    cache = _ot_font_get_extents_cache (ot_font);
+    if (cache && cache->get (glyph, font->serial, extents))
+      return true;
+  }
+
+  if (!_ot_get_glyph_extents (font, ot_font, glyph, extents))
+    return false;
+
+  if (cache)
+    cache->set (glyph, font->serial, *extents);
+  return true;
+#else
+  return _ot_get_glyph_extents (font, ot_font, glyph, extents);
+#endif
+}
+
 #ifndef HB_NO_OT_FONT_GLYPH_NAMES
 static bool_t
 ot_get_glyph_name (font_t *font HB_UNUSED,
@@ -513,11 +776,12 @@ ot_get_font_v_extents (font_t *font,
 #ifndef HB_NO_DRAW
 static void
 ot_draw_glyph (font_t *font,
-		  void *font_data HB_UNUSED,
+		  void *font_data,
 		  codepoint_t glyph,
 		  draw_funcs_t *draw_funcs, void *draw_data,
 		  void *user_data)
 {
+  const ot_font_t *ot_font = (const ot_font_t *) font_data;
   bool embolden = font->x_strength || font->y_strength;
   outline_t outline;
 
@@ -525,10 +789,13 @@ ot_draw_glyph (font_t *font,
     draw_session_t draw_session (embolden ? outline_recording_pen_get_funcs () : draw_funcs,
 				    embolden ? &outline : draw_data, font->slant_xy);
 #ifndef HB_NO_VAR_COMPOSITES
-    if (!font->face->table.VARC->get_path (font, glyph, draw_session))
+    const OT::VARC &varc = *font->face->table.VARC;
+    if (!varc.get_path (font, glyph, draw_session,
+			varc.has_data () ? _ot_font_get_varc_cache (ot_font) : nullptr))
 #endif
     // Keep the following in synch with VARC::get_path_at()
-    if (!font->face->table.glyf->get_path (font, glyph, draw_session))
+    if (!font->face->table.glyf->get_path (font, glyph, draw_session,
+					   _ot_font_get_outline_cache (ot_font)))
 #ifndef HB_NO_CFF
     if (!font->face->table.cff2->get_path (font, glyph, draw_session))
     if (!font->face->table.cff1->get_path (font, glyph, draw_session))
@@ -561,7 +828,17 @@ ot_paint_glyph (font_t *font,
                    void *user_data)
 {
 #ifndef HB_NO_COLOR
+#ifndef HB_NO_OT_FONT_PAINT_CACHE
+  const OT::COLR &colr = *font->face->table.COLR;
+  if (colr.has_v0_data () || colr.has_v1_data ())
+  {
+    const ot_font_t *ot_font = (const ot_font_t *) font_data;
+    if (colr.paint_glyph_cached (font, glyph, paint_funcs, paint_data, palette, foreground,
+				 _ot_font_get_paint_cache (ot_font))) return;
+  }
+#else
   if (font->face->table.COLR->paint_glyph (font, glyph, paint_funcs, paint_data, palette, foreground)) return;
+#endif
   if (font->face->table.SVG->paint_glyph (font, glyph, paint_funcs, paint_data)) return;
 #ifndef HB_NO_OT_FONT_BITMAP
   if (font->face->table.CBDT->paint_glyph (font, glyph, paint_funcs, paint_data)) return;
@@ -659,4 +936,115 @@ ot_font_set_funcs (font_t *font)
 		     _ot_font_destroy);
 }
 
+/**
+ * ot_font_set_approximate_extents:
+ * @font: #font_t to work upon
+ * @approximate: Whether to allow approximate extents
+ *
+ * Allows font_get_glyph_extents() to return conservative, approximate
+ * extents for simple glyphs of variable TrueType fonts.  These are the
+ * default-instance bounding box from the glyph header, grown by a bound
+ * on the glyph variation deltas at the current coordinates.  They are
+ * never smaller than the exact extents, but may be larger.
+ *
+ * This avoids decoding the glyph outline and is meant for callers, like
+ * line breakers and hit testers, that query extents for many glyphs and
+ * can tolerate some slack.
+ *
+ * Has no effect unless @font uses the OpenType font functions, as set up
+ * by ot_font_set_funcs().
+ *
+ * Since: REPLACEME
+ **/
+void
+ot_font_set_approximate_extents (font_t *font,
+				    bool_t approximate)
+{
+  if (object_is_immutable (font))
+    return;
+  if (font->klass != _ot_get_font_funcs ())
+    return;
+
+  ot_font_t *ot_font = (ot_font_t *) font->user_data;
+  if ((bool) approximate == ot_font->approximate_extents)
+    return;
+
+  ot_font->approximate_extents = approximate;
+  font->serial++;
+}
+
+#ifndef HB_NO_MEMORY_USAGE
+void
+ot_font_get_memory_usage (const font_t *font,
+			  memory_usage_collector_t *c)
+{
+  if (font->klass != _ot_get_font_funcs ())
+    return;
+
+  const ot_font_t *ot_font = (const ot_font_t *) font->user_data;
+  c->add (HB_TAG_NONE, sizeof (ot_font_t));
+
+  if (ot_font->advance_cache.get_acquire ())
+    c->add (HB_OT_TAG_hmtx, sizeof (ot_font_advance_cache_t));
+
+#ifndef HB_NO_OT_FONT_OUTLINE_CACHE
+  if (auto *outline_cache = ot_font->outline_cache.get_acquire ())
+    c->add (HB_OT_TAG_glyf, sizeof (*outline_cache) + outline_cache->get_memory_usage ());
+#endif
+
+#ifndef HB_NO_OT_FONT_EXTENTS_CACHE
+  if (ot_font->extents_cache.get_acquire ())
+    c->add (HB_TAG_NONE, sizeof (ot_font_extents_cache_t));
+#endif
+
+#if !defined(HB_NO_PAINT) && !defined(HB_NO_OT_FONT_PAINT_CACHE)
+  if (auto *paint_cache = ot_font->paint_cache.get_acquire ())
+    c->add (HB_OT_TAG_COLR, sizeof (*paint_cache) + paint_cache->get_memory_usage ());
+#endif
+
+#if !defined(HB_NO_DRAW) && !defined(HB_NO_VAR_COMPOSITES) && !defined(HB_NO_OT_FONT_VARC_CACHE)
+  if (auto *varc_cache = ot_font->varc_cache.get_acquire ())
+    c->add (OT::VARC::tableTag, sizeof (*varc_cache) + varc_cache->get_memory_usage ());
+#endif
+}
+
+void
+ot_font_release_memory (font_t *font)
+{
+  if (font->klass != _ot_get_font_funcs ())
+    return;
+
+  _ot_font_free_caches ((ot_font_t *) font->user_data);
+}
+#endif
+
+#ifndef HB_NO_DRAW
+bool
+ot_font_draw_glyph_to_path (font_t *font,
+			    codepoint_t glyph,
+			    draw_path_buffer_t *path)
+{
+  if (font->klass != _ot_get_font_funcs () ||
+      font->x_strength || font->y_strength)
+    return false;
+#ifndef HB_NO_VAR_COMPOSITES
+  /* VARC composites draw their components through transforming pens. */
+  if (font->face->table.VARC->has_data ())
+    return false;
+#endif
+
+  const ot_font_t *ot_font = (const ot_font_t *) font->user_data;
+  draw_session_t draw_session (path, font->slant_xy);
+  // Keep the following in synch with ot_draw_glyph()
+  if (!font->face->table.glyf->get_path (font, glyph, draw_session,
+					 _ot_font_get_outline_cache (ot_font)))
+#ifndef HB_NO_CFF
+  if (!font->face->table.cff2->get_path (font, glyph, draw_session))
+  if (!font->face->table.cff1->get_path (font, glyph, draw_session))
+#endif
+  {}
+  return true;
+}
+#endif
+
 #endif
@@ -39,6 +39,10 @@ HB_BEGIN_DECLS
 HB_EXTERN void
 hb_ot_font_set_funcs (hb_font_t *font);
 
+HB_EXTERN void
+hb_ot_font_set_approximate_extents (hb_font_t *font,
+				    hb_bool_t approximate);
+
 
 HB_END_DECLS
 
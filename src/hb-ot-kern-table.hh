@@ -393,6 +393,8 @@ struct kern
 
     hb_blob_t *get_blob () const { return table.get_blob (); }
 
+    unsigned get_memory_usage () const { return accel_data.get_memory_usage (); }
+
     bool apply (AAT::hb_aat_apply_context_t *c) const
     {
       return table->apply (c, &accel_data);
@@ -30,6 +30,7 @@
 #define HB_OT_LAYOUT_GSUBGPOS_HH
 
 #include "hb.hh"
+#include "hb-arena.hh"
 #include "hb-buffer.hh"
 #include "hb-map.hh"
 #include "hb-set.hh"
@@ -4374,23 +4375,35 @@ struct Extension
 struct ot_layout_lookup_accelerator_t
 {
   template <typename TLookup>
-  static ot_layout_lookup_accelerator_t *create (const TLookup &lookup)
+  static unsigned get_size (const TLookup &lookup)
   {
-    unsigned count = lookup.get_subtable_count ();
-
-    unsigned size = sizeof (ot_layout_lookup_accelerator_t) -
-		    HB_VAR_ARRAY * sizeof (accelerate_subtables_context_t::applicable_t) +
-		    count * sizeof (accelerate_subtables_context_t::applicable_t);
+    return sizeof (ot_layout_lookup_accelerator_t) -
+	   HB_VAR_ARRAY * sizeof (accelerate_subtables_context_t::applicable_t) +
+	   lookup.get_subtable_count () * sizeof (accelerate_subtables_context_t::applicable_t);
+  }
 
+  template <typename TLookup>
+  static ot_layout_lookup_accelerator_t *create (const TLookup &lookup)
+  {
     /* The following is a calloc because when we are collecting subtables,
      * some of them might be invalid and hence not collect; as a result,
      * we might not fill in all the count entries of the subtables array.
      * Zeroing it allows the set digest to gatekeep it without having to
      * initialize it further. */
-    auto *thiz = (ot_layout_lookup_accelerator_t *) calloc (1, size);
+    return create (lookup, calloc (1, get_size (lookup)));
+  }
+
+  /* Builds the accelerator in memory, which must be get_size() bytes and
+   * zeroed, as above. */
+  template <typename TLookup>
+  static ot_layout_lookup_accelerator_t *create (const TLookup &lookup, void *memory)
+  {
+    auto *thiz = (ot_layout_lookup_accelerator_t *) memory;
     if (unlikely (!thiz))
       return nullptr;
 
+    unsigned count = lookup.get_subtable_count ();
+
     accelerate_subtables_context_t c_accelerate_subtables (thiz->subtables);
     lookup.dispatch (&c_accelerate_subtables);
 
@@ -4818,6 +4831,8 @@ struct GSUBGPOS
   template <typename T>
   struct accelerator_t
   {
+    static constexpr tag_t tableTag = T::tableTag;
+
     accelerator_t (face_t *face)
     {
       sanitize_context_t sc;
@@ -4842,39 +4857,60 @@ struct GSUBGPOS
     }
     ~accelerator_t ()
     {
-      for (unsigned int i = 0; i < this->lookup_count; i++)
-	free (this->accels[i]);
+      /* Lookup accelerators live in arena. */
       free (this->accels);
       this->table.destroy ();
     }
 
     blob_t *get_blob () const { return table.get_blob (); }
 
+    unsigned get_memory_usage () const
+    { return lookup_count * sizeof (*accels) + arena.get_memory_usage (); }
+
     ot_layout_lookup_accelerator_t *get_accel (unsigned lookup_index) const
     {
       if (unlikely (lookup_index >= lookup_count)) return nullptr;
 
-    retry:
       auto *accel = accels[lookup_index].get_acquire ();
       if (unlikely (!accel))
       {
-	accel = ot_layout_lookup_accelerator_t::create (table->get_lookup (lookup_index));
+	const auto &lookup = table->get_lookup (lookup_index);
+	void *memory = arena.alloc (ot_layout_lookup_accelerator_t::get_size (lookup));
+	accel = ot_layout_lookup_accelerator_t::create (lookup, memory);
 	if (unlikely (!accel))
 	  return nullptr;
 
+	/* If another thread beat us to it, use theirs; ours stays in the
+	 * arena unused, which only happens on a race. */
 	if (unlikely (!accels[lookup_index].cmpexch (nullptr, accel)))
-	{
-	  free (accel);
-	  goto retry;
-	}
+	  accel = accels[lookup_index].get_acquire ();
       }
 
       return accel;
     }
 
+    /* Builds the accelerators of the given lookups that are not built yet,
+     * next to each other in the arena and in the given order, so that
+     * applying them in that order walks memory forward. */
+    template <typename Iterable,
+	      requires (is_iterable (Iterable))>
+    void materialize (const Iterable &lookup_indices) const
+    {
+      unsigned size = 0;
+      for (unsigned lookup_index : lookup_indices)
+	if (lookup_index < lookup_count && !accels[lookup_index].get_acquire ())
+	  size += (ot_layout_lookup_accelerator_t::get_size (table->get_lookup (lookup_index)) +
+		   arena_t::ALIGN - 1) & ~(arena_t::ALIGN - 1);
+      if (!size || !arena.reserve (size)) return;
+
+      for (unsigned lookup_index : lookup_indices)
+	get_accel (lookup_index);
+    }
+
     blob_ptr_t<T> table;
     unsigned int lookup_count;
     atomic_ptr_t<ot_layout_lookup_accelerator_t> *accels;
+    mutable arena_t arena;
   };
 
   protected:
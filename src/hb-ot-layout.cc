@@ -2073,6 +2073,21 @@ void ot_map_t::position (const ot_shape_plan_t *plan, font_t *font, buffer_t *bu
     (void) buffer->message (font, "end table GPOS script tag '%c%c%c%c'", HB_UNTAG (chosen_script[1]));
 }
 
+/* Builds the accelerators of all lookups of the map up front, so that
+ * each table's come out back to back and in the order they are applied,
+ * rather than scattered in the order the buffers happen to need them.
+ *
+ * Off unless built with HB_OT_LAYOUT_EAGER_LOOKUPS: it makes plan
+ * creation slower and builds accelerators for lookups that the text
+ * shaped may never reach, for a locality gain that is unmeasured. */
+void ot_map_t::materialize_lookups (face_t *face) const
+{
+#ifdef HB_OT_LAYOUT_EAGER_LOOKUPS
+  face->table.GSUB->materialize (+ iter (lookups[0]) | map (&lookup_map_t::index));
+  face->table.GPOS->materialize (+ iter (lookups[1]) | map (&lookup_map_t::index));
+#endif
+}
+
 void
 ot_layout_substitute_lookup (OT::ot_apply_context_t *c,
 				const OT::SubstLookup &lookup,
@@ -388,6 +388,8 @@ hb_ot_map_builder_t::compile (hb_ot_map_t                  &m,
       }
     }
   }
+
+  m.materialize_lookups (face);
 }
 
 
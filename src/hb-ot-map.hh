@@ -160,12 +160,20 @@ struct ot_map_t
     return lookups[table_index].as_array ().sub_array (start, end - start);
   }
 
+  unsigned get_memory_usage () const
+  {
+    return features.get_memory_usage () +
+	   lookups[0].get_memory_usage () + lookups[1].get_memory_usage () +
+	   stages[0].get_memory_usage () + stages[1].get_memory_usage ();
+  }
+
   HB_INTERNAL void collect_lookups (unsigned int table_index, set_t *lookups) const;
   template <typename Proxy>
   HB_INTERNAL void apply (const Proxy &proxy,
 			  const struct ot_shape_plan_t *plan, font_t *font, buffer_t *buffer) const;
   HB_INTERNAL void substitute (const struct ot_shape_plan_t *plan, font_t *font, buffer_t *buffer) const;
   HB_INTERNAL void position (const struct ot_shape_plan_t *plan, font_t *font, buffer_t *buffer) const;
+  HB_INTERNAL void materialize_lookups (face_t *face) const;
 
   public:
   tag_t chosen_script[2];
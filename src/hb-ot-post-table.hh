@@ -161,6 +161,14 @@ struct post
       table.destroy ();
     }
 
+    unsigned get_memory_usage () const
+    {
+      unsigned size = index_to_offset.get_memory_usage ();
+      if (gids_sorted_by_name.get_acquire ())
+	size += get_glyph_count () * sizeof (uint16_t);
+      return size;
+    }
+
     bool get_glyph_name (hb_codepoint_t glyph,
 			 char *buf, unsigned int buf_len) const
     {
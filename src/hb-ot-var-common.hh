@@ -322,7 +322,8 @@ struct tuple_delta_t
   }
 
   vector_t<tuple_delta_t> change_tuple_var_axis_limit (tag_t axis_tag, Triple axis_limit,
-                                                          TripleDistances axis_triple_distances) const
+                                                          TripleDistances axis_triple_distances,
+                                                          rebase_tent_cache_t *solver_cache = nullptr) const
   {
     vector_t<tuple_delta_t> out;
     Triple *tent;
@@ -342,7 +343,9 @@ struct tuple_delta_t
       return out;
     }
 
-    rebase_tent_result_t solutions = rebase_tent (*tent, axis_limit, axis_triple_distances);
+    rebase_tent_result_t solutions = solver_cache
+                                   ? solver_cache->rebase_tent (*tent, axis_limit, axis_triple_distances)
+                                   : rebase_tent (*tent, axis_limit, axis_triple_distances);
     for (auto &t : solutions)
     {
       tuple_delta_t new_var = *this;
@@ -1040,7 +1043,8 @@ struct TupleVariationData
     }
 
     bool change_tuple_variations_axis_limits (const hashmap_t<tag_t, Triple>& normalized_axes_location,
-                                              const hashmap_t<tag_t, TripleDistances>& axes_triple_distances)
+                                              const hashmap_t<tag_t, TripleDistances>& axes_triple_distances,
+                                              rebase_tent_cache_t *solver_cache)
     {
       /* sort axis_tag/axis_limits, make result deterministic */
       vector_t<tag_t> axis_tags;
@@ -1062,7 +1066,7 @@ struct TupleVariationData
         vector_t<tuple_delta_t> new_vars;
         for (const tuple_delta_t& var : tuple_vars)
         {
-          vector_t<tuple_delta_t> out = var.change_tuple_var_axis_limit (axis_tag, *axis_limit, axis_triple_distances);
+          vector_t<tuple_delta_t> out = var.change_tuple_var_axis_limit (axis_tag, *axis_limit, axis_triple_distances, solver_cache);
           if (!out) continue;
 
           unsigned new_len = new_vars.length + out.length;
@@ -1181,6 +1185,9 @@ struct TupleVariationData
       return true;
     }
 
+    public:
+    /* Only touches this glyph's deltas, so separate glyphs can be optimized
+     * concurrently. */
     bool iup_optimize (const contour_point_vector_t& contour_points)
     {
       for (tuple_delta_t& var : tuple_vars)
@@ -1188,17 +1195,33 @@ struct TupleVariationData
         if (!var.optimize (contour_points, is_composite))
           return false;
       }
-      return true;
+      return !tuple_vars.in_error ();
     }
 
-    public:
     bool instantiate (const hashmap_t<tag_t, Triple>& normalized_axes_location,
                       const hashmap_t<tag_t, TripleDistances>& axes_triple_distances,
                       contour_point_vector_t* contour_points = nullptr,
-                      bool optimize = false)
+                      bool optimize = false,
+                      rebase_tent_cache_t *solver_cache = nullptr)
+    {
+      if (!instantiate_deltas (normalized_axes_location, axes_triple_distances,
+                               contour_points, optimize, solver_cache))
+        return false;
+
+      if (optimize && !iup_optimize (*contour_points)) return false;
+      return !tuple_vars.in_error ();
+    }
+
+    /* instantiate () without the final IUP optimization, for callers that
+     * run iup_optimize () themselves. */
+    bool instantiate_deltas (const hashmap_t<tag_t, Triple>& normalized_axes_location,
+                             const hashmap_t<tag_t, TripleDistances>& axes_triple_distances,
+                             contour_point_vector_t* contour_points = nullptr,
+                             bool optimize = false,
+                             rebase_tent_cache_t *solver_cache = nullptr)
     {
       if (!tuple_vars) return true;
-      if (!change_tuple_variations_axis_limits (normalized_axes_location, axes_triple_distances))
+      if (!change_tuple_variations_axis_limits (normalized_axes_location, axes_triple_distances, solver_cache))
         return false;
       /* compute inferred deltas only for gvar */
       if (contour_points)
@@ -1212,7 +1235,6 @@ struct TupleVariationData
       if (!merge_tuple_variations (optimize ? contour_points : nullptr))
         return false;
 
-      if (optimize && !iup_optimize (*contour_points)) return false;
       return !tuple_vars.in_error ();
     }
 
@@ -1575,7 +1597,7 @@ struct item_variations_t
   {
     if (!create_from_item_varstore (varStore, plan->axes_old_index_tag_map, inner_maps))
       return false;
-    if (!instantiate_tuple_vars (plan->axes_location, plan->axes_triple_distances))
+    if (!instantiate_tuple_vars (plan->axes_location, plan->axes_triple_distances, &plan->rebase_tent_cache))
       return false;
     return as_item_varstore (optimize, use_no_variation_idx);
   }
@@ -1614,10 +1636,12 @@ struct item_variations_t
   }
 
   bool instantiate_tuple_vars (const hashmap_t<tag_t, Triple>& normalized_axes_location,
-                               const hashmap_t<tag_t, TripleDistances>& axes_triple_distances)
+                               const hashmap_t<tag_t, TripleDistances>& axes_triple_distances,
+                               rebase_tent_cache_t *solver_cache = nullptr)
   {
     for (tuple_variations_t& tuple_vars : vars)
-      if (!tuple_vars.instantiate (normalized_axes_location, axes_triple_distances))
+      if (!tuple_vars.instantiate (normalized_axes_location, axes_triple_distances,
+                                   nullptr, false, solver_cache))
         return false;
 
     if (!build_region_list ()) return false;
@@ -158,7 +158,8 @@ struct cvar
                                      tuple_variations))
       return_trace (false);
 
-    if (!tuple_variations.instantiate (c->plan->axes_location, c->plan->axes_triple_distances))
+    if (!tuple_variations.instantiate (c->plan->axes_location, c->plan->axes_triple_distances,
+                                       nullptr, false, &c->plan->rebase_tent_cache))
       return_trace (false);
 
     if (!tuple_variations.compile_bytes (c->plan->axes_index_map, c->plan->axes_old_index_tag_map,
@@ -30,6 +30,7 @@
 
 #include "hb-open-type.hh"
 #include "hb-ot-var-common.hh"
+#include "hb-thread-pool.hh"
 
 /*
  * gvar -- Glyph Variation Table
@@ -120,16 +121,38 @@ struct glyph_variations_t
     unsigned count = plan->new_to_old_gid_list.length;
     bool iup_optimize = false;
     iup_optimize = plan->flags & HB_SUBSET_FLAGS_OPTIMIZE_IUP_DELTAS;
+
+    vector_t<const contour_point_vector_t *> glyph_points;
+    if (iup_optimize && unlikely (!glyph_points.resize (count)))
+      return false;
+
+    /* Instancing shares the plan's rebase_tent cache, so it is done
+     * serially; the IUP optimization that follows is per-glyph and is what
+     * dominates when enabled. */
     for (unsigned i = 0; i < count; i++)
     {
       codepoint_t new_gid = plan->new_to_old_gid_list[i].first;
       contour_point_vector_t *all_points;
       if (!plan->new_gid_contour_points_map.has (new_gid, &all_points))
         return false;
-      if (!glyph_variations[i].instantiate (plan->axes_location, plan->axes_triple_distances, all_points, iup_optimize))
+      if (!glyph_variations[i].instantiate_deltas (plan->axes_location, plan->axes_triple_distances, all_points, iup_optimize,
+                                                   &plan->rebase_tent_cache))
         return false;
+      if (iup_optimize)
+        glyph_points.arrayZ[i] = all_points;
     }
-    return true;
+    if (!iup_optimize)
+      return true;
+
+    atomic_int_t failed;
+    parallel_for (plan->max_threads, count,
+                  [&] (unsigned i)
+                  {
+                    if (failed.get_relaxed ()) return;
+                    if (!glyph_variations.arrayZ[i].iup_optimize (*glyph_points.arrayZ[i]))
+                      failed.set_relaxed (1);
+                  });
+    return !failed.get_relaxed ();
   }
 
   bool compile_bytes (const map_t& axes_index_map,
@@ -588,29 +611,67 @@ struct gvar
     }
     ~accelerator_t () { table.destroy (); }
 
+    unsigned get_memory_usage () const
+    { return shared_tuple_active_idx.get_memory_usage (); }
+
     private:
 
-    static float infer_delta (const array_t<contour_point_t> points,
-			      const array_t<contour_point_t> deltas,
-			      unsigned int target, unsigned int prev, unsigned int next,
-			      float contour_point_t::*m)
+    /* Interpolates one coordinate axis across a gap of unreferenced
+     * points between the referenced points prev and next.  Everything that
+     * only depends on the ends of the gap is worked out once per gap
+     * instead of once per point. */
+    struct infer_axis_t
+    {
+      infer_axis_t (float prev_val_, float next_val_,
+		    float prev_delta_, float next_delta_)
+      {
+	prev_val = prev_val_;
+	denom = next_val_ - prev_val_;
+	prev_delta = prev_delta_;
+	delta_diff = next_delta_ - prev_delta_;
+
+	if (prev_val_ == next_val_)
+	{
+	  lo = hi = prev_val_;
+	  lo_delta = hi_delta = (prev_delta_ == next_delta_) ? prev_delta_ : 0.f;
+	}
+	else if (prev_val_ < next_val_)
+	{
+	  lo = prev_val_; lo_delta = prev_delta_;
+	  hi = next_val_; hi_delta = next_delta_;
+	}
+	else
+	{
+	  lo = next_val_; lo_delta = next_delta_;
+	  hi = prev_val_; hi_delta = prev_delta_;
+	}
+      }
+
+      float operator () (float target_val) const
+      {
+	if (target_val <= lo) return lo_delta;
+	if (target_val >= hi) return hi_delta;
+
+	/* linear interpolation */
+	float r = (target_val - prev_val) / denom;
+	return prev_delta + r * delta_diff;
+      }
+
+      float lo, hi, lo_delta, hi_delta;
+      float prev_val, denom, prev_delta, delta_diff;
+    };
+
+    /* Accumulation kernels.  Deltas are kept as separate x and y float
+     * arrays so that these loops vectorize. */
+    static void add_deltas (float *__restrict acc, const int *__restrict deltas,
+			    unsigned count, float scalar)
     {
-      float target_val = points.arrayZ[target].*m;
-      float prev_val = points.arrayZ[prev].*m;
-      float next_val = points.arrayZ[next].*m;
-      float prev_delta =  deltas.arrayZ[prev].*m;
-      float next_delta =  deltas.arrayZ[next].*m;
-
-      if (prev_val == next_val)
-	return (prev_delta == next_delta) ? prev_delta : 0.f;
-      else if (target_val <= min (prev_val, next_val))
-	return (prev_val < next_val) ? prev_delta : next_delta;
-      else if (target_val >= max (prev_val, next_val))
-	return (prev_val > next_val) ? prev_delta : next_delta;
-
-      /* linear interpolation */
-      float r = (target_val - prev_val) / (next_val - prev_val);
-      return prev_delta + r * (next_delta - prev_delta);
+      if (scalar == 1.0f)
+	for (unsigned i = 0; i < count; i++)
+	  acc[i] += deltas[i];
+      else
+	for (unsigned i = 0; i < count; i++)
+	  acc[i] += deltas[i] * scalar;
     }
 
     static unsigned int next_index (unsigned int i, unsigned int start, unsigned int end)
@@ -637,9 +698,11 @@ struct gvar
       contour_point_vector_t orig_points_vec; // Populated lazily
       auto orig_points = orig_points_vec.as_array ();
 
-      /* flag is used to indicate referenced point */
-      contour_point_vector_t deltas_vec; // Populated lazily
-      auto deltas = deltas_vec.as_array ();
+      /* Accumulated deltas, and whether each point was referenced
+       * explicitly by the current tuple. */
+      vector_t<float> deltas_x; // Populated lazily
+      vector_t<float> deltas_y; // Populated lazily
+      vector_t<uint8_t> referenced; // Populated lazily
 
       vector_t<unsigned> end_points; // Populated lazily
 
@@ -650,6 +713,7 @@ struct gvar
       vector_t<int> x_deltas;
       vector_t<int> y_deltas;
       unsigned count = points.length;
+      unsigned first = phantom_only ? count - 4 : 0;
       bool flush = false;
       do
       {
@@ -661,12 +725,11 @@ struct gvar
 	if (unlikely (!iterator.var_data_bytes.check_range (p, length)))
 	  return false;
 
-	if (!deltas)
+	if (!deltas_x)
 	{
-	  if (unlikely (!deltas_vec.resize (count, false))) return false;
-	  deltas = deltas_vec.as_array ();
-	  memset (deltas.arrayZ + (phantom_only ? count - 4 : 0), 0,
-		     (phantom_only ? 4 : count) * sizeof (deltas[0]));
+	  if (unlikely (!deltas_x.resize (count) ||
+			!deltas_y.resize (count)))
+	    return false;
 	}
 
 	const HBUINT8 *end = p + length;
@@ -692,85 +755,41 @@ struct gvar
 	    if (unlikely (orig_points_vec.in_error ())) return false;
 	    orig_points = orig_points_vec.as_array ();
 	  }
+	  if (!referenced)
+	  {
+	    if (unlikely (!referenced.resize (count))) return false;
+	  }
+	  else
+	    memset (referenced.arrayZ, 0, count * sizeof (referenced[0]));
 
 	  if (flush)
 	  {
-	    for (unsigned int i = phantom_only ? count - 4 : 0; i < count; i++)
-	      points.arrayZ[i].translate (deltas.arrayZ[i]);
+	    for (unsigned int i = first; i < count; i++)
+	    {
+	      points.arrayZ[i].x += deltas_x.arrayZ[i];
+	      points.arrayZ[i].y += deltas_y.arrayZ[i];
+	    }
 	    flush = false;
-
 	  }
-	  memset (deltas.arrayZ + (phantom_only ? count - 4 : 0), 0,
-		     (phantom_only ? 4 : count) * sizeof (deltas[0]));
+	  memset (deltas_x.arrayZ + first, 0, (count - first) * sizeof (deltas_x[0]));
+	  memset (deltas_y.arrayZ + first, 0, (count - first) * sizeof (deltas_y[0]));
 	}
 
-	if (HB_OPTIMIZE_SIZE_VAL)
+	if (apply_to_all)
 	{
-	  for (unsigned int i = 0; i < num_deltas; i++)
-	  {
-	    unsigned int pt_index;
-	    if (apply_to_all)
-	      pt_index = i;
-	    else
-	    {
-	      pt_index = indices[i];
-	      if (unlikely (pt_index >= deltas.length)) continue;
-	    }
-	    if (phantom_only && pt_index < count - 4) continue;
-	    auto &delta = deltas.arrayZ[pt_index];
-	    delta.flag = 1;	/* this point is referenced, i.e., explicit deltas specified */
-	    delta.x += x_deltas.arrayZ[i] * scalar;
-	    delta.y += y_deltas.arrayZ[i] * scalar;
-	  }
+	  add_deltas (deltas_x.arrayZ + first, x_deltas.arrayZ + first, count - first, scalar);
+	  add_deltas (deltas_y.arrayZ + first, y_deltas.arrayZ + first, count - first, scalar);
 	}
 	else
-	{
-	  /* Ouch. Four cases... for optimization. */
-	  if (scalar != 1.0f)
-	  {
-	    if (apply_to_all)
-	      for (unsigned int i = phantom_only ? count - 4 : 0; i < count; i++)
-	      {
-		unsigned int pt_index = i;
-		auto &delta = deltas.arrayZ[pt_index];
-		delta.x += x_deltas.arrayZ[i] * scalar;
-		delta.y += y_deltas.arrayZ[i] * scalar;
-	      }
-	    else
-	      for (unsigned int i = 0; i < num_deltas; i++)
-	      {
-		unsigned int pt_index = indices[i];
-		if (unlikely (pt_index >= deltas.length)) continue;
-		if (phantom_only && pt_index < count - 4) continue;
-		auto &delta = deltas.arrayZ[pt_index];
-		delta.flag = 1;	/* this point is referenced, i.e., explicit deltas specified */
-		delta.x += x_deltas.arrayZ[i] * scalar;
-		delta.y += y_deltas.arrayZ[i] * scalar;
-	      }
-	  }
-	  else
+	  for (unsigned int i = 0; i < num_deltas; i++)
 	  {
-	    if (apply_to_all)
-	      for (unsigned int i = phantom_only ? count - 4 : 0; i < count; i++)
-	      {
-		unsigned int pt_index = i;
-		auto &delta = deltas.arrayZ[pt_index];
-		delta.x += x_deltas.arrayZ[i];
-		delta.y += y_deltas.arrayZ[i];
-	      }
-	    else
-	      for (unsigned int i = 0; i < num_deltas; i++)
-	      {
-		unsigned int pt_index = indices[i];
-		if (unlikely (pt_index >= deltas.length)) continue;
-		if (phantom_only && pt_index < count - 4) continue;
-		auto &delta = deltas.arrayZ[pt_index];
-		delta.flag = 1;	/* this point is referenced, i.e., explicit deltas specified */
-		delta.x += x_deltas.arrayZ[i];
-		delta.y += y_deltas.arrayZ[i];
-	      }
+	    unsigned int pt_index = indices[i];
+	    if (unlikely (pt_index >= count)) continue;
+	    if (phantom_only && pt_index < first) continue;
+	    referenced.arrayZ[pt_index] = 1; /* explicit deltas specified */
+	    deltas_x.arrayZ[pt_index] += x_deltas.arrayZ[i] * scalar;
+	    deltas_y.arrayZ[pt_index] += y_deltas.arrayZ[i] * scalar;
 	  }
-	}
 
 	/* infer deltas for unreferenced points */
 	if (!apply_to_all && !phantom_only)
@@ -783,13 +802,14 @@ struct gvar
 	    if (unlikely (end_points.in_error ())) return false;
 	  }
 
+	  const uint8_t *ref = referenced.arrayZ;
 	  unsigned start_point = 0;
 	  for (unsigned end_point : end_points)
 	  {
 	    /* Check the number of unreferenced points in a contour. If no unref points or no ref points, nothing to do. */
 	    unsigned unref_count = 0;
 	    for (unsigned i = start_point; i < end_point + 1; i++)
-	      unref_count += deltas.arrayZ[i].flag;
+	      unref_count += ref[i];
 	    unref_count = (end_point - start_point + 1) - unref_count;
 
 	    unsigned j = start_point;
@@ -806,24 +826,28 @@ struct gvar
 	      {
 		i = j;
 		j = next_index (i, start_point, end_point);
-		if (deltas.arrayZ[i].flag && !deltas.arrayZ[j].flag) break;
+		if (ref[i] && !ref[j]) break;
 	      }
 	      prev = j = i;
 	      for (;;)
 	      {
 		i = j;
 		j = next_index (i, start_point, end_point);
-		if (!deltas.arrayZ[i].flag && deltas.arrayZ[j].flag) break;
+		if (!ref[i] && ref[j]) break;
 	      }
 	      next = j;
 	      /* Infer deltas for all unref points in the gap between prev and next */
+	      infer_axis_t infer_x (orig_points.arrayZ[prev].x, orig_points.arrayZ[next].x,
+				    deltas_x.arrayZ[prev], deltas_x.arrayZ[next]);
+	      infer_axis_t infer_y (orig_points.arrayZ[prev].y, orig_points.arrayZ[next].y,
+				    deltas_y.arrayZ[prev], deltas_y.arrayZ[next]);
 	      i = prev;
 	      for (;;)
 	      {
 		i = next_index (i, start_point, end_point);
 		if (i == next) break;
-		deltas.arrayZ[i].x = infer_delta (orig_points, deltas, i, prev, next, &contour_point_t::x);
-		deltas.arrayZ[i].y = infer_delta (orig_points, deltas, i, prev, next, &contour_point_t::y);
+		deltas_x.arrayZ[i] = infer_x (orig_points.arrayZ[i].x);
+		deltas_y.arrayZ[i] = infer_y (orig_points.arrayZ[i].y);
 		if (--unref_count == 0) goto no_more_gaps;
 	      }
 	    }
@@ -838,13 +862,83 @@ struct gvar
 
       if (flush)
       {
-	for (unsigned int i = phantom_only ? count - 4 : 0; i < count; i++)
-	  points.arrayZ[i].translate (deltas.arrayZ[i]);
+	for (unsigned int i = first; i < count; i++)
+	{
+	  points.arrayZ[i].x += deltas_x.arrayZ[i];
+	  points.arrayZ[i].y += deltas_y.arrayZ[i];
+	}
       }
 
       return true;
     }
 
+    /* Bounds the absolute x and y distance apply_deltas_to_points() can
+     * move any point of @glyph at @coords, without needing the points.
+     * @num_points includes phantoms.  Inferred deltas interpolate between
+     * explicit ones, so bounding the explicit deltas is enough. */
+    bool get_delta_bounds (codepoint_t glyph,
+			   array_t<const int> coords,
+			   unsigned num_points,
+			   float *x_bound, float *y_bound) const
+    {
+      *x_bound = *y_bound = 0.f;
+      if (unlikely (glyph >= glyphCount)) return true;
+
+      bytes_t var_data_bytes = table->get_glyph_var_data_bytes (table.get_blob (), glyphCount, glyph);
+      if (!var_data_bytes.as<GlyphVariationData> ()->has_data ()) return true;
+      vector_t<unsigned int> shared_indices;
+      GlyphVariationData::tuple_iterator_t iterator;
+      if (!GlyphVariationData::get_tuple_iterator (var_data_bytes, table->axisCount,
+						   var_data_bytes.arrayZ,
+						   shared_indices, &iterator))
+	return true; /* so isn't applied at all */
+
+      unsigned num_coords = table->axisCount;
+      array_t<const F2DOT14> shared_tuples = (table+table->sharedTuples).as_array (table->sharedTupleCount * num_coords);
+
+      vector_t<unsigned int> private_indices;
+      vector_t<int> x_deltas;
+      vector_t<int> y_deltas;
+      do
+      {
+	float scalar = iterator.current_tuple->calculate_scalar (coords, num_coords, shared_tuples,
+								 &shared_tuple_active_idx);
+	if (scalar == 0.f) continue;
+	const HBUINT8 *p = iterator.get_serialized_data ();
+	unsigned int length = iterator.current_tuple->get_data_size ();
+	if (unlikely (!iterator.var_data_bytes.check_range (p, length)))
+	  return false;
+
+	const HBUINT8 *end = p + length;
+
+	bool has_private_points = iterator.current_tuple->has_private_points ();
+	if (has_private_points &&
+	    !GlyphVariationData::decompile_points (p, private_indices, end))
+	  return false;
+	const array_t<unsigned int> &indices = has_private_points ? private_indices : shared_indices;
+
+	unsigned int num_deltas = indices.length ? indices.length : num_points;
+	if (unlikely (!x_deltas.resize (num_deltas, false))) return false;
+	if (unlikely (!GlyphVariationData::decompile_deltas (p, x_deltas, end))) return false;
+	if (unlikely (!y_deltas.resize (num_deltas, false))) return false;
+	if (unlikely (!GlyphVariationData::decompile_deltas (p, y_deltas, end))) return false;
+
+	int max_x = 0, max_y = 0;
+	for (unsigned int i = 0; i < num_deltas; i++)
+	{
+	  int x = x_deltas.arrayZ[i];
+	  int y = y_deltas.arrayZ[i];
+	  max_x = max (max_x, x < 0 ? -x : x);
+	  max_y = max (max_y, y < 0 ? -y : y);
+	}
+	if (scalar < 0.f) scalar = -scalar;
+	*x_bound += max_x * scalar;
+	*y_bound += max_y * scalar;
+      } while (iterator.move_to_next ());
+
+      return true;
+    }
+
     unsigned int get_axis_count () const { return table->axisCount; }
 
     private:
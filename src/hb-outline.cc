@@ -218,6 +218,368 @@ void outline_t::embolden (float x_strength, float y_strength,
   }
 }
 
+/* Line segments an outline is flattened into for render_sdf() and
+ * render_a8(), in pixel space: x to the right and y down from the
+ * top-left bitmap corner. */
+struct outline_segment_t
+{
+  float ax, ay, bx, by;
+};
+
+struct outline_flattener_t
+{
+  /* Flattening tolerance, in pixels. */
+  static constexpr float TOLERANCE = .2f;
+  static constexpr unsigned MAX_STEPS = 64;
+
+  void line_to (float x, float y)
+  {
+    segments.push (outline_segment_t {cx, cy, x, y});
+    cx = x;
+    cy = y;
+  }
+
+  static unsigned steps_for (float deviation)
+  {
+    float n = ceilf (sqrtf (deviation / TOLERANCE));
+    return n < 1.f ? 1 : n > MAX_STEPS ? MAX_STEPS : (unsigned) n;
+  }
+
+  void quadratic_to (float x1, float y1, float x2, float y2)
+  {
+    float x0 = cx, y0 = cy;
+    unsigned n = steps_for (.25f * hypotf (x0 - 2 * x1 + x2, y0 - 2 * y1 + y2));
+    for (unsigned i = 1; i < n; i++)
+    {
+      float t = (float) i / n, s = 1 - t;
+      line_to (s * s * x0 + 2 * s * t * x1 + t * t * x2,
+	       s * s * y0 + 2 * s * t * y1 + t * t * y2);
+    }
+    line_to (x2, y2);
+  }
+
+  void cubic_to (float x1, float y1, float x2, float y2, float x3, float y3)
+  {
+    float x0 = cx, y0 = cy;
+    unsigned n = steps_for (.75f * max (hypotf (x0 - 2 * x1 + x2, y0 - 2 * y1 + y2),
+					hypotf (x1 - 2 * x2 + x3, y1 - 2 * y2 + y3)));
+    for (unsigned i = 1; i < n; i++)
+    {
+      float t = (float) i / n, s = 1 - t;
+      float a = s * s * s, b = 3 * s * s * t, c = 3 * s * t * t, d = t * t * t;
+      line_to (a * x0 + b * x1 + c * x2 + d * x3,
+	       a * y0 + b * y1 + c * y2 + d * y3);
+    }
+    line_to (x3, y3);
+  }
+
+  /* Flattens all contours, closing them, mapped to pixel space. */
+  void flatten (const outline_t &outline, float x_origin, float y_origin)
+  {
+    const auto &points = outline.points;
+    unsigned first = 0;
+    for (unsigned contour : outline.contours)
+    {
+      if (contour <= first) continue;
+      float sx = points[first].x - x_origin, sy = y_origin - points[first].y;
+      cx = sx;
+      cy = sy;
+      for (unsigned i = first + 1; i < contour;)
+      {
+	const outline_point_t &p = points[i];
+	float x = p.x - x_origin, y = y_origin - p.y;
+	switch (p.type)
+	{
+	  case outline_point_t::type_t::MOVE_TO:
+	  case outline_point_t::type_t::LINE_TO:
+	    line_to (x, y);
+	    i++;
+	    break;
+	  case outline_point_t::type_t::QUADRATIC_TO:
+	    if (unlikely (i + 2 > contour)) { i = contour; break; }
+	    quadratic_to (x, y,
+			  points[i + 1].x - x_origin, y_origin - points[i + 1].y);
+	    i += 2;
+	    break;
+	  case outline_point_t::type_t::CUBIC_TO:
+	    if (unlikely (i + 3 > contour)) { i = contour; break; }
+	    cubic_to (x, y,
+		      points[i + 1].x - x_origin, y_origin - points[i + 1].y,
+		      points[i + 2].x - x_origin, y_origin - points[i + 2].y);
+	    i += 3;
+	    break;
+	}
+      }
+      if (cx != sx || cy != sy)
+	line_to (sx, sy);
+      first = contour;
+    }
+  }
+
+  vector_t<outline_segment_t> segments;
+  float cx = 0, cy = 0;
+};
+
+/* Sets *size to rows * cols, for sizing a vector_t; false if that does
+ * not fit one. */
+static bool
+render_buffer_size (unsigned rows, unsigned cols, unsigned *size)
+{
+  return !unsigned_mul_overflows (rows, cols, size) && *size <= (unsigned) INT_MAX;
+}
+
+static void
+render_clear (uint8_t *bitmap, unsigned width, unsigned height, unsigned stride)
+{
+  for (unsigned r = 0; r < height; r++)
+    hb_memset (bitmap + r * stride, 0, width);
+}
+
+#ifndef HB_NO_GLYPH_SDF
+bool outline_t::render_sdf (uint8_t *bitmap,
+			    unsigned width, unsigned height, unsigned stride,
+			    float x_origin, float y_origin,
+			    float spread) const
+{
+  if (unlikely (!width || !height)) return true;
+  if (!(spread > 0.f)) spread = 1.f;
+
+  outline_flattener_t flattener;
+  flattener.flatten (*this, x_origin, y_origin);
+
+  /* Squared distances, capped at the spread, and per-row winding deltas:
+   * a segment crossing the center line of a row changes the winding of
+   * every pixel left of the crossing, which is recorded as a +dir at the
+   * start of the row and a -dir just past the last such pixel. */
+  vector_t<float> dist2;
+  vector_t<int> winding;
+  unsigned dist2_size, winding_size;
+  if (unlikely (flattener.segments.in_error () ||
+		width == UINT_MAX ||
+		!render_buffer_size (width, height, &dist2_size) ||
+		!render_buffer_size (width + 1, height, &winding_size) ||
+		!dist2.resize_exact (dist2_size, false) ||
+		!winding.resize_exact (winding_size)))
+  {
+    render_clear (bitmap, width, height, stride);
+    return false;
+  }
+  const float max_dist2 = spread * spread;
+  for (float &d : dist2) d = max_dist2;
+
+  for (const outline_segment_t &seg : flattener.segments)
+  {
+    float dx = seg.bx - seg.ax, dy = seg.by - seg.ay;
+    float len2 = dx * dx + dy * dy;
+    float inv_len2 = len2 ? 1.f / len2 : 0.f;
+
+    /* Only pixels within the spread of the segment's bounds can move. */
+    float x_min = min (seg.ax, seg.bx) - spread, x_max = max (seg.ax, seg.bx) + spread;
+    float y_min = min (seg.ay, seg.by) - spread, y_max = max (seg.ay, seg.by) + spread;
+    int c0 = max ((int) floorf (x_min - .5f), 0), c1 = min ((int) ceilf (x_max + .5f), (int) width);
+    int r0 = max ((int) floorf (y_min - .5f), 0), r1 = min ((int) ceilf (y_max + .5f), (int) height);
+
+    for (int r = r0; r < r1; r++)
+    {
+      /* Kept to a single select, with t clamped to [0, 1] arithmetically,
+       * so that compilers vectorize it without fast-math. */
+      float *row = dist2.arrayZ + r * width;
+      float py = r + .5f - seg.ay;
+      for (int c = c0; c < c1; c++)
+      {
+	float px = c + .5f - seg.ax;
+	float t = (px * dx + py * dy) * inv_len2;
+	t = .5f * (fabsf (t) - fabsf (t - 1.f) + 1.f);
+	float ex = px - t * dx, ey = py - t * dy;
+	float d2 = ex * ex + ey * ey;
+	float cur = row[c];
+	row[c] = d2 < cur ? d2 : cur;
+      }
+    }
+
+    if (seg.ay == seg.by) continue;
+    int dir = seg.by > seg.ay ? 1 : -1;
+    float top = min (seg.ay, seg.by), bottom = max (seg.ay, seg.by);
+    /* Rows whose center lies in [top, bottom). */
+    int w0 = max ((int) ceilf (top - .5f), 0);
+    int w1 = min ((int) ceilf (bottom - .5f), (int) height);
+    float slope = dx / dy;
+    for (int r = w0; r < w1; r++)
+    {
+      float cross = seg.ax + (r + .5f - seg.ay) * slope;
+      int k = (int) ceilf (cross - .5f);
+      k = k < 0 ? 0 : k > (int) width ? (int) width : k;
+      int *deltas = winding.arrayZ + r * (width + 1);
+      deltas[0] += dir;
+      deltas[k] -= dir;
+    }
+  }
+
+  const float scale = 127.5f / spread;
+  for (unsigned r = 0; r < height; r++)
+  {
+    const float *row = dist2.arrayZ + r * width;
+    const int *deltas = winding.arrayZ + r * (width + 1);
+    uint8_t *out = bitmap + r * stride;
+    int w = 0;
+    for (unsigned c = 0; c < width; c++)
+    {
+      w += deltas[c];
+      float d = sqrtf (row[c]) * scale;
+      float v = 127.5f + (w ? d : -d);
+      out[c] = (uint8_t) (v < 0.f ? 0.f : v > 255.f ? 255.f : v + .5f);
+    }
+  }
+  return true;
+}
+#endif
+
+/* Adds to a row of render_a8()'s accumulation buffer the signed area a
+ * line from x0 to x1, both within [0, width], of signed height d covers
+ * within each pixel, and to the pixel past it the rest of d. */
+static void
+a8_accumulate (float *row, float x0, float x1, float d)
+{
+  float xa = min (x0, x1), xb = max (x0, x1);
+  float xa_floor = floorf (xa);
+  unsigned ia = (unsigned) xa_floor;
+  unsigned ib = (unsigned) ceilf (xb);
+
+  if (ib <= ia + 1)
+  {
+    /* Within one pixel. */
+    float xm = .5f * (x0 + x1) - xa_floor;
+    row[ia] += d - d * xm;
+    row[ia + 1] += d * xm;
+  }
+  else
+  {
+    float s = 1.f / (xb - xa);
+    float fa = xa - xa_floor;
+    float a0 = .5f * s * (1.f - fa) * (1.f - fa);
+    float fb = xb - ceilf (xb) + 1.f;
+    float am = .5f * s * fb * fb;
+    row[ia] += d * a0;
+    if (ib == ia + 2)
+      row[ia + 1] += d * (1.f - a0 - am);
+    else
+    {
+      float a1 = s * (1.5f - fa);
+      row[ia + 1] += d * (a1 - a0);
+      for (unsigned i = ia + 2; i < ib - 1; i++)
+	row[i] += d * s;
+      float a2 = a1 + (ib - ia - 3) * s;
+      row[ib - 1] += d * (1.f - a2 - am);
+    }
+    row[ib] += d * am;
+  }
+}
+
+bool outline_t::render_a8 (uint8_t *bitmap,
+			   unsigned width, unsigned height, unsigned stride,
+			   float x_origin, float y_origin) const
+{
+  if (unlikely (!width || !height)) return true;
+
+  outline_flattener_t flattener;
+  flattener.flatten (*this, x_origin, y_origin);
+
+  /* Accumulation buffer: each segment adds, to the pixels it passes
+   * through, the signed area it covers within them, and to the pixel past
+   * them the rest of its signed height in that row.  A running sum along
+   * a row then gives the coverage of every pixel.  Rows have two spare
+   * cells, for segments touching the right edge. */
+  const unsigned row_size = width + 2;
+  vector_t<float> acc;
+  unsigned acc_size;
+  if (unlikely (flattener.segments.in_error () ||
+		row_size < width ||
+		!render_buffer_size (row_size, height, &acc_size) ||
+		!acc.resize_exact (acc_size)))
+  {
+    render_clear (bitmap, width, height, stride);
+    return false;
+  }
+
+  const float w = width, h = height;
+  for (const outline_segment_t &seg : flattener.segments)
+  {
+    float x0 = seg.ax, y0 = seg.ay, x1 = seg.bx, y1 = seg.by;
+    if (y0 == y1) continue;
+
+    float dir = 1.f;
+    if (y0 > y1)
+    {
+      dir = -1.f;
+      float t;
+      t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+    }
+    if (y1 <= 0.f || y0 >= h) continue;
+
+    float dxdy = (x1 - x0) / (y1 - y0);
+    float x = x0;
+    if (y0 < 0.f)
+    {
+      x -= y0 * dxdy;
+      y0 = 0.f;
+    }
+    if (y1 > h) y1 = h;
+
+    for (unsigned r = (unsigned) y0; r < height && r < y1; r++)
+    {
+      float *row = acc.arrayZ + r * row_size;
+      float dy = min ((float) r + 1.f, y1) - max ((float) r, y0);
+      float x_next = x + dxdy * dy;
+      float d = dy * dir;
+
+      /* Split the part of the segment in this row where it leaves the
+       * bitmap sideways.  Area left of the bitmap still counts towards
+       * the pixels right of it, so what is left of it goes into column 0;
+       * what is right of it does not matter, and lands in the spare
+       * cells. */
+      float xs = x < 0.f ? 0.f : x > w ? w : x;
+      float t0 = 0.f;
+      float bounds[2] = {0.f, w};
+      if (x_next < x) { bounds[0] = w; bounds[1] = 0.f; }
+      for (float b : bounds)
+	if ((x < b) != (x_next < b))
+	{
+	  float t = (b - x) / (x_next - x);
+	  a8_accumulate (row, xs, b, d * (t - t0));
+	  xs = b;
+	  t0 = t;
+	}
+      a8_accumulate (row, xs, x_next < 0.f ? 0.f : x_next > w ? w : x_next,
+		     d * (1.f - t0));
+
+      x = x_next;
+    }
+  }
+
+  for (unsigned r = 0; r < height; r++)
+  {
+    float *row = acc.arrayZ + r * row_size;
+    uint8_t *out = bitmap + r * stride;
+
+    /* The running sum is serial; the conversion after it is kept
+     * separate and branch-free so that compilers vectorize it. */
+    float sum = 0.f;
+    for (unsigned c = 0; c < width; c++)
+    {
+      sum += row[c];
+      row[c] = sum;
+    }
+    for (unsigned c = 0; c < width; c++)
+    {
+      float v = fabsf (row[c]);
+      v = v < 1.f ? v : 1.f;
+      out[c] = (uint8_t) (v * 255.f + .5f);
+    }
+  }
+  return true;
+}
+
 static void
 outline_recording_pen_move_to (draw_funcs_t *dfuncs HB_UNUSED,
 				  void *data,
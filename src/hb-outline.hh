@@ -72,6 +72,23 @@ struct hb_outline_t
   HB_INTERNAL void embolden (float x_strength, float y_strength,
 			     float x_shift, float y_shift);
 
+#ifndef HB_NO_GLYPH_SDF
+  /* Fills a width x height, 8-bit bitmap with the signed distance from
+   * each pixel center to the outline; see font_get_glyph_sdf().  On
+   * failure, for lack of memory or with dimensions too large to render,
+   * clears the bitmap and returns false. */
+  HB_INTERNAL bool render_sdf (uint8_t *bitmap,
+			       unsigned width, unsigned height, unsigned stride,
+			       float x_origin, float y_origin,
+			       float spread) const;
+#endif
+
+  /* Fills a width x height, 8-bit bitmap with the anti-aliased coverage
+   * of the outline; see font_get_glyph_a8().  Fails like render_sdf(). */
+  HB_INTERNAL bool render_a8 (uint8_t *bitmap,
+			      unsigned width, unsigned height, unsigned stride,
+			      float x_origin, float y_origin) const;
+
   hb_vector_t<hb_outline_point_t> points;
   hb_vector_t<unsigned> contours;
 };
@@ -144,7 +144,7 @@ void free_static_draw_extents_funcs ()
   static_draw_extents_funcs.free_instance ();
 }
 
-static draw_funcs_t *
+draw_funcs_t *
 draw_extents_get_funcs ()
 {
   return static_draw_extents_funcs.get_unconst ();
@@ -128,5 +128,10 @@ struct hb_paint_extents_context_t
 HB_INTERNAL hb_paint_funcs_t *
 hb_paint_extents_get_funcs ();
 
+/* Draw funcs that accumulate the bounds of everything drawn into an
+ * extents_t.  Defined in hb-paint-extents.cc. */
+HB_INTERNAL draw_funcs_t *
+draw_extents_get_funcs ();
+
 
 #endif /* HB_PAINT_EXTENTS_HH */
@@ -0,0 +1,476 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "hb.hh"
+
+#ifndef HB_NO_PAINT
+
+#include "hb-paint-program.hh"
+#include "hb-paint-extents.hh"
+
+#include "hb-machinery.hh"
+
+
+/*
+ * Recording.
+ */
+
+static void
+paint_program_push_transform (paint_funcs_t *funcs HB_UNUSED,
+			      void *paint_data,
+			      float xx, float yx,
+			      float xy, float yy,
+			      float dx, float dy,
+			      void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::PUSH_TRANSFORM);
+  op->v[0] = xx; op->v[1] = yx;
+  op->v[2] = xy; op->v[3] = yy;
+  op->v[4] = dx; op->v[5] = dy;
+}
+
+static void
+paint_program_pop_transform (paint_funcs_t *funcs HB_UNUSED,
+			     void *paint_data,
+			     void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  p->push_op (paint_program_t::POP_TRANSFORM);
+}
+
+static bool_t
+paint_program_color_glyph (paint_funcs_t *funcs HB_UNUSED,
+			   void *paint_data,
+			   codepoint_t glyph,
+			   font_t *font HB_UNUSED,
+			   void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::COLOR_GLYPH);
+  op->index = glyph;
+  p->open_color_glyphs.push (p->ops.length - 1);
+
+  /* Record the fallback; replay decides. */
+  return false;
+}
+
+static void
+paint_program_push_clip_glyph (paint_funcs_t *funcs HB_UNUSED,
+			       void *paint_data,
+			       codepoint_t glyph,
+			       font_t *font HB_UNUSED,
+			       void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::PUSH_CLIP_GLYPH);
+  op->index = glyph;
+}
+
+static void
+paint_program_push_clip_rectangle (paint_funcs_t *funcs HB_UNUSED,
+				   void *paint_data,
+				   float xmin, float ymin, float xmax, float ymax,
+				   void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::PUSH_CLIP_RECTANGLE);
+  op->v[0] = xmin; op->v[1] = ymin;
+  op->v[2] = xmax; op->v[3] = ymax;
+}
+
+static void
+paint_program_pop_clip (paint_funcs_t *funcs HB_UNUSED,
+			void *paint_data,
+			void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  p->push_op (paint_program_t::POP_CLIP);
+}
+
+static void
+paint_program_color (paint_funcs_t *funcs HB_UNUSED,
+		     void *paint_data,
+		     bool_t is_foreground HB_UNUSED,
+		     color_t color HB_UNUSED,
+		     void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  /* The painter noted the color just before painting it. */
+  if (unlikely (!p->colors.length))
+  {
+    p->successful = false;
+    return;
+  }
+
+  auto *op = p->push_op (paint_program_t::COLOR);
+  op->index = p->colors.length - 1;
+}
+
+static bool_t
+paint_program_image (paint_funcs_t *funcs HB_UNUSED,
+		     void *paint_data,
+		     blob_t *blob HB_UNUSED,
+		     unsigned int width HB_UNUSED,
+		     unsigned int height HB_UNUSED,
+		     tag_t format HB_UNUSED,
+		     float slant HB_UNUSED,
+		     glyph_extents_t *extents HB_UNUSED,
+		     void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  /* Images are not recorded. */
+  p->successful = false;
+  return false;
+}
+
+static void
+paint_program_record_color_line (paint_program_t *p,
+				 paint_program_t::op_t *op,
+				 color_line_t *color_line)
+{
+  unsigned first_color = p->colors.length;
+  unsigned len = color_line_get_color_stops (color_line, 0, nullptr, nullptr);
+
+  op->index = p->stops.length;
+  op->mode = (uint8_t) color_line_get_extend (color_line);
+
+  color_stop_t stops[16];
+  unsigned start = 0;
+  while (start < len)
+  {
+    unsigned count = ARRAY_LENGTH (stops);
+    color_line_get_color_stops (color_line, start, &count, stops);
+    if (unlikely (!count)) break;
+    for (unsigned i = 0; i < count; i++)
+      p->stops.push (paint_program_t::stop_t {stops[i].offset, first_color + start + i});
+    start += count;
+  }
+
+  op->count = p->stops.length - op->index;
+  if (unlikely (p->colors.length != first_color + op->count))
+    p->successful = false;
+}
+
+static void
+paint_program_linear_gradient (paint_funcs_t *funcs HB_UNUSED,
+			       void *paint_data,
+			       color_line_t *color_line,
+			       float x0, float y0,
+			       float x1, float y1,
+			       float x2, float y2,
+			       void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::LINEAR_GRADIENT);
+  op->v[0] = x0; op->v[1] = y0;
+  op->v[2] = x1; op->v[3] = y1;
+  op->v[4] = x2; op->v[5] = y2;
+  paint_program_record_color_line (p, op, color_line);
+}
+
+static void
+paint_program_radial_gradient (paint_funcs_t *funcs HB_UNUSED,
+			       void *paint_data,
+			       color_line_t *color_line,
+			       float x0, float y0, float r0,
+			       float x1, float y1, float r1,
+			       void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::RADIAL_GRADIENT);
+  op->v[0] = x0; op->v[1] = y0; op->v[2] = r0;
+  op->v[3] = x1; op->v[4] = y1; op->v[5] = r1;
+  paint_program_record_color_line (p, op, color_line);
+}
+
+static void
+paint_program_sweep_gradient (paint_funcs_t *funcs HB_UNUSED,
+			      void *paint_data,
+			      color_line_t *color_line,
+			      float cx, float cy,
+			      float start_angle,
+			      float end_angle,
+			      void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::SWEEP_GRADIENT);
+  op->v[0] = cx; op->v[1] = cy;
+  op->v[2] = start_angle; op->v[3] = end_angle;
+  paint_program_record_color_line (p, op, color_line);
+}
+
+static void
+paint_program_push_group (paint_funcs_t *funcs HB_UNUSED,
+			  void *paint_data,
+			  void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  p->push_op (paint_program_t::PUSH_GROUP);
+}
+
+static void
+paint_program_pop_group (paint_funcs_t *funcs HB_UNUSED,
+			 void *paint_data,
+			 paint_composite_mode_t mode,
+			 void *user_data HB_UNUSED)
+{
+  paint_program_t *p = (paint_program_t *) paint_data;
+
+  auto *op = p->push_op (paint_program_t::POP_GROUP);
+  op->mode = (uint8_t) mode;
+}
+
+static inline void free_static_paint_program_funcs ();
+
+static struct paint_program_funcs_lazy_loader_t : paint_funcs_lazy_loader_t<paint_program_funcs_lazy_loader_t>
+{
+  static paint_funcs_t *create ()
+  {
+    paint_funcs_t *funcs = paint_funcs_create ();
+
+    paint_funcs_set_push_transform_func (funcs, paint_program_push_transform, nullptr, nullptr);
+    paint_funcs_set_pop_transform_func (funcs, paint_program_pop_transform, nullptr, nullptr);
+    paint_funcs_set_color_glyph_func (funcs, paint_program_color_glyph, nullptr, nullptr);
+    paint_funcs_set_push_clip_glyph_func (funcs, paint_program_push_clip_glyph, nullptr, nullptr);
+    paint_funcs_set_push_clip_rectangle_func (funcs, paint_program_push_clip_rectangle, nullptr, nullptr);
+    paint_funcs_set_pop_clip_func (funcs, paint_program_pop_clip, nullptr, nullptr);
+    paint_funcs_set_color_func (funcs, paint_program_color, nullptr, nullptr);
+    paint_funcs_set_image_func (funcs, paint_program_image, nullptr, nullptr);
+    paint_funcs_set_linear_gradient_func (funcs, paint_program_linear_gradient, nullptr, nullptr);
+    paint_funcs_set_radial_gradient_func (funcs, paint_program_radial_gradient, nullptr, nullptr);
+    paint_funcs_set_sweep_gradient_func (funcs, paint_program_sweep_gradient, nullptr, nullptr);
+    paint_funcs_set_push_group_func (funcs, paint_program_push_group, nullptr, nullptr);
+    paint_funcs_set_pop_group_func (funcs, paint_program_pop_group, nullptr, nullptr);
+
+    paint_funcs_make_immutable (funcs);
+
+    atexit (free_static_paint_program_funcs);
+
+    return funcs;
+  }
+} static_paint_program_funcs;
+
+static inline
+void free_static_paint_program_funcs ()
+{
+  static_paint_program_funcs.free_instance ();
+}
+
+paint_funcs_t *
+paint_program_get_funcs ()
+{
+  return static_paint_program_funcs.get_unconst ();
+}
+
+
+/*
+ * Replay.
+ */
+
+static unsigned int
+paint_program_get_color_stops (color_line_t *color_line HB_UNUSED,
+			       void *color_line_data,
+			       unsigned int start,
+			       unsigned int *count,
+			       color_stop_t *color_stops,
+			       void *user_data)
+{
+  const paint_program_t::op_t *op = (const paint_program_t::op_t *) color_line_data;
+  const paint_program_t::replay_context_t *c = (const paint_program_t::replay_context_t *) user_data;
+  const paint_program_t *p = c->program;
+
+  if (count && color_stops)
+  {
+    unsigned int i;
+    for (i = 0; i < *count && start + i < op->count; i++)
+    {
+      const paint_program_t::stop_t &stop = p->stops.arrayZ[op->index + start + i];
+      color_stops[i].offset = stop.offset;
+      color_stops[i].color = c->get_color (p->colors.arrayZ[stop.color],
+					   &color_stops[i].is_foreground);
+    }
+    *count = i;
+  }
+
+  return op->count;
+}
+
+static paint_extend_t
+paint_program_get_extend (color_line_t *color_line HB_UNUSED,
+			  void *color_line_data,
+			  void *user_data HB_UNUSED)
+{
+  const paint_program_t::op_t *op = (const paint_program_t::op_t *) color_line_data;
+  return (paint_extend_t) op->mode;
+}
+
+void
+paint_program_t::replay (font_t *font,
+			 paint_funcs_t *funcs, void *data,
+			 color_t foreground) const
+{
+  replay_context_t c = {this, funcs, data, foreground};
+
+  for (unsigned i = 0; i < ops.length; i++)
+  {
+    const op_t &op = ops.arrayZ[i];
+    switch (op.type)
+    {
+    case PUSH_TRANSFORM:
+      funcs->push_transform (data, op.v[0], op.v[1], op.v[2], op.v[3], op.v[4], op.v[5]);
+      break;
+    case POP_TRANSFORM:
+      funcs->pop_transform (data);
+      break;
+    case COLOR_GLYPH:
+      if (funcs->color_glyph (data, op.index, font))
+      {
+	/* Skip the recorded fallback; it starts with this pop. */
+	funcs->pop_transform (data);
+	i = op.count - 1;
+      }
+      break;
+    case PUSH_CLIP_GLYPH:
+      funcs->push_clip_glyph (data, op.index, font);
+      break;
+    case PUSH_CLIP_RECTANGLE:
+      funcs->push_clip_rectangle (data, op.v[0], op.v[1], op.v[2], op.v[3]);
+      break;
+    case POP_CLIP:
+      funcs->pop_clip (data);
+      break;
+    case COLOR:
+    {
+      bool_t is_foreground;
+      color_t color = c.get_color (colors.arrayZ[op.index], &is_foreground);
+      funcs->color (data, is_foreground, color);
+      break;
+    }
+    case LINEAR_GRADIENT:
+    {
+      color_line_t cl = {
+	(void *) &op,
+	paint_program_get_color_stops, &c,
+	paint_program_get_extend, nullptr
+      };
+      funcs->linear_gradient (data, &cl, op.v[0], op.v[1], op.v[2], op.v[3], op.v[4], op.v[5]);
+      break;
+    }
+    case RADIAL_GRADIENT:
+    {
+      color_line_t cl = {
+	(void *) &op,
+	paint_program_get_color_stops, &c,
+	paint_program_get_extend, nullptr
+      };
+      funcs->radial_gradient (data, &cl, op.v[0], op.v[1], op.v[2], op.v[3], op.v[4], op.v[5]);
+      break;
+    }
+    case SWEEP_GRADIENT:
+    {
+      color_line_t cl = {
+	(void *) &op,
+	paint_program_get_color_stops, &c,
+	paint_program_get_extend, nullptr
+      };
+      funcs->sweep_gradient (data, &cl, op.v[0], op.v[1], op.v[2], op.v[3]);
+      break;
+    }
+    case PUSH_GROUP:
+      funcs->push_group (data);
+      break;
+    case POP_GROUP:
+      funcs->pop_group (data, (paint_composite_mode_t) op.mode);
+      break;
+    default:
+      return;
+    }
+  }
+}
+
+
+void
+paint_program_t::get_extents (font_t *font,
+			      paint_extents_context_t *c) const
+{
+  for (unsigned i = 0; i < ops.length; i++)
+  {
+    const op_t &op = ops.arrayZ[i];
+    switch (op.type)
+    {
+    case PUSH_TRANSFORM:
+      c->push_transform (transform_t {op.v[0], op.v[1], op.v[2], op.v[3], op.v[4], op.v[5]});
+      break;
+    case POP_TRANSFORM:
+      c->pop_transform ();
+      break;
+    case COLOR_GLYPH:
+      /* Extents always measure the fallback. */
+      break;
+    case PUSH_CLIP_GLYPH:
+    {
+      extents_t extents;
+      font_draw_glyph (font, op.index, draw_extents_get_funcs (), &extents);
+      c->push_clip (extents);
+      break;
+    }
+    case PUSH_CLIP_RECTANGLE:
+      c->push_clip (extents_t {op.v[0], op.v[1], op.v[2], op.v[3]});
+      break;
+    case POP_CLIP:
+      c->pop_clip ();
+      break;
+    case COLOR:
+    case LINEAR_GRADIENT:
+    case RADIAL_GRADIENT:
+    case SWEEP_GRADIENT:
+      c->paint ();
+      break;
+    case PUSH_GROUP:
+      c->push_group ();
+      break;
+    case POP_GROUP:
+      c->pop_group ((paint_composite_mode_t) op.mode);
+      break;
+    default:
+      return;
+    }
+  }
+}
+
+
+#endif
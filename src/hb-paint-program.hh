@@ -0,0 +1,291 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_PAINT_PROGRAM_HH
+#define HB_PAINT_PROGRAM_HH
+
+#include "hb.hh"
+#include "hb-cache-entry.hh"
+#include "hb-paint.hh"
+#include "hb-map.hh"
+#include "hb-mutex.hh"
+
+
+struct paint_extents_context_t;
+
+/* A color glyph's paint graph flattened into the sequence of paint calls
+ * it makes for one font state: offsets and layer indirections followed,
+ * variations applied, transforms and clip boxes resolved and color lines
+ * read out.
+ *
+ * A program is recorded by painting with paint_program_get_funcs() and the
+ * program as paint data.  The COLR painter helps by calling note_color()
+ * for every color it resolves, so that replay can still honor the
+ * foreground color and custom palette of the caller, and by calling
+ * end_color_glyph() after the fallback of a PaintColrGlyph, so that replay
+ * can skip it if the caller's color_glyph() callback succeeds. */
+struct paint_program_t
+{
+  enum op_type_t : uint8_t
+  {
+    PUSH_TRANSFORM,
+    POP_TRANSFORM,
+    COLOR_GLYPH,
+    PUSH_CLIP_GLYPH,
+    PUSH_CLIP_RECTANGLE,
+    POP_CLIP,
+    COLOR,
+    LINEAR_GRADIENT,
+    RADIAL_GRADIENT,
+    SWEEP_GRADIENT,
+    PUSH_GROUP,
+    POP_GROUP,
+  };
+
+  struct op_t
+  {
+    uint8_t type;
+    uint8_t mode;	/* Composite mode, or extend of a color line. */
+    unsigned index;	/* Glyph, color, or first color stop. */
+    unsigned count;	/* Number of color stops, or end of a color glyph fallback. */
+    float v[6];
+  };
+
+  struct color_ref_t
+  {
+    static constexpr unsigned FOREGROUND = 0xFFFF;
+
+    unsigned index;	/* Palette entry, or FOREGROUND. */
+    bool has_color;	/* Whether the palette had the entry. */
+    color_t color;	/* Palette color, before alpha. */
+    float alpha;
+  };
+
+  struct stop_t
+  {
+    float offset;
+    unsigned color;	/* Index into colors. */
+  };
+
+  void reset ()
+  {
+    ops.reset ();
+    colors.reset ();
+    stops.reset ();
+    open_color_glyphs.reset ();
+    successful = true;
+  }
+
+  bool in_error () const
+  {
+    return !successful ||
+	   ops.in_error () || colors.in_error () || stops.in_error ();
+  }
+
+  unsigned get_memory_usage () const
+  {
+    return ops.get_memory_usage () +
+	   colors.get_memory_usage () +
+	   stops.get_memory_usage () +
+	   open_color_glyphs.get_memory_usage ();
+  }
+
+  /* Recording. */
+
+  op_t *push_op (op_type_t type)
+  {
+    op_t *op = ops.push ();
+    if (unlikely (ops.in_error ())) return op;
+    hb_memset (op, 0, sizeof (*op));
+    op->type = type;
+    return op;
+  }
+
+  void note_color (unsigned index, float alpha,
+		   bool has_color, color_t color)
+  {
+    colors.push (color_ref_t {index, has_color, color, alpha});
+  }
+
+  void end_color_glyph ()
+  {
+    if (unlikely (!open_color_glyphs.length))
+    {
+      successful = false;
+      return;
+    }
+    unsigned i = open_color_glyphs.pop ();
+    ops.arrayZ[i].count = ops.length;
+  }
+
+  /* Replay. */
+
+  struct replay_context_t
+  {
+    const paint_program_t *program;
+    paint_funcs_t *funcs;
+    void *data;
+    color_t foreground;
+
+    color_t get_color (const color_ref_t &ref, bool_t *is_foreground) const
+    {
+      color_t color = foreground;
+
+      *is_foreground = true;
+
+      if (ref.index != color_ref_t::FOREGROUND)
+      {
+	if (!funcs->custom_palette_color (data, ref.index, &color) &&
+	    ref.has_color)
+	  color = ref.color;
+
+	*is_foreground = false;
+      }
+
+      return HB_COLOR (color_get_blue (color),
+		       color_get_green (color),
+		       color_get_red (color),
+		       color_get_alpha (color) * ref.alpha);
+    }
+  };
+
+  HB_INTERNAL void replay (font_t *font,
+			   paint_funcs_t *funcs, void *data,
+			   color_t foreground) const;
+
+  /* Bounds of what replay would paint, without going through callbacks. */
+  HB_INTERNAL void get_extents (font_t *font,
+				paint_extents_context_t *c) const;
+
+  vector_t<op_t> ops;
+  vector_t<color_ref_t> colors;
+  vector_t<stop_t> stops;
+
+  /* Recording state. */
+  vector_t<unsigned> open_color_glyphs;
+  bool successful = true;
+};
+
+HB_INTERNAL paint_funcs_t *
+paint_program_get_funcs ();
+
+
+/* Per-font cache of paint programs.  Entries are only valid for one
+ * font state, which font_t::serial identifies, and one palette; the
+ * whole cache is dropped when the serial changes or when it would grow
+ * past MAX_OPS operations.  Programs are handed out as references to the
+ * cached entries, and replayed after the lock is dropped.
+ *
+ * Glyphs whose program cannot be replayed, because recording failed or
+ * it is too long, get an entry in error, so that they are painted
+ * directly instead of being recorded again every time. */
+struct paint_program_cache_t
+{
+  static constexpr unsigned MAX_OPS = 1u << 13;
+  static constexpr unsigned ANY_PALETTE = (unsigned) -1;
+
+  typedef cache_entry_t<paint_program_t>::ref_t ref_t;
+
+  ref_t get (codepoint_t gid, unsigned palette, unsigned serial) const
+  {
+    lock_t l (lock);
+
+    if (serial != font_serial) return ref_t ();
+
+    const item_t *item;
+    if (!glyphs.has (gid, &item)) return ref_t ();
+    if (palette != ANY_PALETTE && item->palette != palette) return ref_t ();
+
+    return item->program;
+  }
+
+  /* Moves program into the cache, and returns the cached program to use
+   * in its place; that is in error if program cannot be replayed.
+   * Returns nothing, leaving program alone, if it could not be cached. */
+  ref_t set (codepoint_t gid, unsigned palette, unsigned serial,
+	     paint_program_t &program)
+  {
+    if (unlikely (program.ops.length > MAX_OPS || program.in_error ()))
+    {
+      /* Keep just the verdict. */
+      program.reset ();
+      program.successful = false;
+    }
+    program.open_color_glyphs.fini ();
+    /* Entries in error count as one operation, so that they are bounded
+     * too. */
+    unsigned num_program_ops = max (program.ops.length, 1u);
+
+    lock_t l (lock);
+
+    if (serial != font_serial || num_ops + num_program_ops > MAX_OPS)
+    {
+      glyphs.reset ();
+      num_ops = 0;
+      font_serial = serial;
+    }
+
+    const item_t *old;
+    if (glyphs.has (gid, &old))
+    {
+      if (old->palette == palette) return old->program;
+      num_ops -= old->num_ops;
+    }
+
+    item_t item;
+    item.palette = palette;
+    item.num_ops = num_program_ops;
+    item.program = cache_entry_t<paint_program_t>::create (program);
+    if (unlikely (!item.program)) return ref_t ();
+
+    ref_t ret = item.program;
+    if (likely (glyphs.set (gid, std::move (item))))
+      num_ops += num_program_ops;
+    return ret;
+  }
+
+  unsigned get_memory_usage () const
+  {
+    lock_t l (lock);
+    return glyphs.get_memory_usage ();
+  }
+
+  protected:
+  struct item_t
+  {
+    unsigned palette = 0;
+    unsigned num_ops = 0;
+    ref_t program;
+
+    unsigned get_memory_usage () const { return program.get_memory_usage (); }
+  };
+
+  mutable mutex_t lock; /* Protects members below. */
+  unsigned font_serial = 0;
+  unsigned num_ops = 0;
+  hashmap_t<codepoint_t, item_t> glyphs;
+};
+
+
+#endif /* HB_PAINT_PROGRAM_HH */
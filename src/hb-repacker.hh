@@ -34,6 +34,8 @@
 #include "graph/gsubgpos-graph.hh"
 #include "graph/serialize.hh"
 
+#include <time.h>
+
 using graph::graph_t;
 
 /*
@@ -41,6 +43,81 @@ using graph::graph_t;
  * docs/repacker.md
  */
 
+/*
+ * Overflow resolution strategies. The ones that were applied on the way
+ * to the final packing are reported back in repack_stats_t::strategies.
+ * Values match subset_repack_strategy_t.
+ */
+enum repack_strategy_t
+{
+  REPACK_STRATEGY_NONE			= 0x00u,
+  REPACK_STRATEGY_SORT			= 0x01u,
+  REPACK_STRATEGY_SPACE_ASSIGNMENT	= 0x02u,
+  REPACK_STRATEGY_ISOLATION		= 0x04u,
+  REPACK_STRATEGY_DUPLICATION		= 0x08u,
+  REPACK_STRATEGY_PRIORITY		= 0x10u,
+  REPACK_STRATEGY_EXTENSION_PROMOTION	= 0x20u,
+};
+
+/*
+ * Limits on the amount of work overflow resolution may do. Once any limit
+ * is hit the round loop stops; GSUB/GPOS then fall back straight to
+ * extension promotion and subtable splitting, everything else fails.
+ * The limits cover the whole resolution, including the re-run with
+ * extension promotion that GSUB/GPOS get when the first attempt fails.
+ */
+struct repack_budget_t
+{
+  /* Rounds that duplicate or reprioritize objects. Rounds which only
+   * isolate subgraphs into new spaces do not count towards this. */
+  unsigned max_rounds = 32;
+  /* Cap on all rounds, isolation ones included. 0 means no limit. */
+  unsigned max_total_rounds = 0;
+  /* Wall time for the whole resolution in milliseconds. 0 means no limit.
+   * Checked between rounds, so the round running when time runs out,
+   * which includes re-sorting the graph, still completes. */
+  unsigned max_time_ms = 0;
+};
+
+struct repack_stats_t
+{
+  unsigned strategies = REPACK_STRATEGY_NONE;
+  unsigned rounds = 0;
+  unsigned total_rounds = 0;
+  bool budget_exceeded = false;
+};
+
+struct repack_deadline_t
+{
+  repack_deadline_t (unsigned max_time_ms) :
+    max_time_ms (max_time_ms),
+    start_ms (max_time_ms ? now_ms () : 0) {}
+
+  bool expired () const
+  { return max_time_ms && now_ms () - start_ms >= max_time_ms; }
+
+  /* Wall time: the budget is about how long callers wait. */
+  static uint64_t now_ms ()
+  {
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (likely (!clock_gettime (CLOCK_MONOTONIC, &ts)))
+      return (uint64_t) ts.tv_sec * 1000u + (uint64_t) ts.tv_nsec / 1000000u;
+#elif defined(_WIN32)
+    LARGE_INTEGER count, frequency;
+    if (likely (QueryPerformanceCounter (&count) &&
+		QueryPerformanceFrequency (&frequency) &&
+		frequency.QuadPart >= 1000))
+      return (uint64_t) count.QuadPart / ((uint64_t) frequency.QuadPart / 1000u);
+#endif
+    /* Coarse, but wall time still. */
+    return (uint64_t) time (nullptr) * 1000u;
+  }
+
+  unsigned max_time_ms;
+  uint64_t start_ms;
+};
+
 struct lookup_size_t
 {
   unsigned lookup_index;
@@ -83,7 +160,7 @@ bool _presplit_subtables_if_needed (graph::gsubgpos_graph_context_t& ext_context
   // The loop below can modify the contents of ext_context.lookups if new subtables are added
   // to a lookup during a split. So save the initial set of lookup indices so the iteration doesn't
   // risk access free'd memory if ext_context.lookups gets resized.
-  hb_set_t lookup_indices(ext_context.lookups.keys ());
+  set_t lookup_indices(ext_context.lookups.keys ());
   for (unsigned lookup_index : lookup_indices)
   {
     graph::Lookup* lookup = ext_context.lookups.get(lookup_index);
@@ -120,7 +197,7 @@ bool _promote_extensions_if_needed (graph::gsubgpos_graph_context_t& ext_context
   if (!ext_context.lookups) return true;
 
   unsigned total_lookup_table_sizes = 0;
-  hb_vector_t<lookup_size_t> lookup_sizes;
+  vector_t<lookup_size_t> lookup_sizes;
   lookup_sizes.alloc (ext_context.lookups.get_population (), true);
 
   for (unsigned lookup_index : ext_context.lookups.keys ())
@@ -129,7 +206,7 @@ bool _promote_extensions_if_needed (graph::gsubgpos_graph_context_t& ext_context
     total_lookup_table_sizes += lookup_v.table_size ();
 
     const graph::Lookup* lookup = ext_context.lookups.get(lookup_index);
-    hb_set_t visited;
+    set_t visited;
     lookup_sizes.push (lookup_size_t {
         lookup_index,
         ext_context.graph.find_subgraph_size (lookup_index, visited),
@@ -166,7 +243,7 @@ bool _promote_extensions_if_needed (graph::gsubgpos_graph_context_t& ext_context
     if (!layers_full)
     {
       size_t lookup_size = ext_context.graph.vertices_[p.lookup_index].table_size ();
-      hb_set_t visited;
+      set_t visited;
       size_t subtables_size = ext_context.graph.find_subgraph_size (p.lookup_index, visited, 1) - lookup_size;
       size_t remaining_size = p.size - subtables_size - lookup_size;
 
@@ -189,11 +266,11 @@ bool _promote_extensions_if_needed (graph::gsubgpos_graph_context_t& ext_context
 }
 
 static inline
-bool _try_isolating_subgraphs (const hb_vector_t<graph::overflow_record_t>& overflows,
+bool _try_isolating_subgraphs (const vector_t<graph::overflow_record_t>& overflows,
                                graph_t& sorted_graph)
 {
   unsigned space = 0;
-  hb_set_t roots_to_isolate;
+  set_t roots_to_isolate;
 
   for (int i = overflows.length - 1; i >= 0; i--)
   {
@@ -214,7 +291,7 @@ bool _try_isolating_subgraphs (const hb_vector_t<graph::overflow_record_t>& over
 
   if (!roots_to_isolate) return false;
 
-  unsigned maximum_to_move = hb_max ((sorted_graph.num_roots_for_space (space) / 2u), 1u);
+  unsigned maximum_to_move = max ((sorted_graph.num_roots_for_space (space) / 2u), 1u);
   if (roots_to_isolate.get_population () > maximum_to_move) {
     // Only move at most half of the roots in a space at a time.
     unsigned extra = roots_to_isolate.get_population () - maximum_to_move;
@@ -239,7 +316,7 @@ bool _try_isolating_subgraphs (const hb_vector_t<graph::overflow_record_t>& over
 }
 
 static inline
-bool _resolve_shared_overflow(const hb_vector_t<graph::overflow_record_t>& overflows,
+bool _resolve_shared_overflow(const vector_t<graph::overflow_record_t>& overflows,
                               int overflow_index,
                               graph_t& sorted_graph)
 {
@@ -248,7 +325,7 @@ bool _resolve_shared_overflow(const hb_vector_t<graph::overflow_record_t>& overf
   // Find all of the parents in overflowing links that link to this
   // same child node. We will then try duplicating the child node and
   // re-assigning all of these parents to the duplicate.
-  hb_set_t parents;
+  set_t parents;
   parents.add(r.parent);
   for (int i = overflow_index - 1; i >= 0; i--) {
     const graph::overflow_record_t& r2 = overflows[i];
@@ -287,9 +364,10 @@ bool _resolve_shared_overflow(const hb_vector_t<graph::overflow_record_t>& overf
 }
 
 static inline
-bool _process_overflows (const hb_vector_t<graph::overflow_record_t>& overflows,
-                         hb_set_t& priority_bumped_parents,
-                         graph_t& sorted_graph)
+bool _process_overflows (const vector_t<graph::overflow_record_t>& overflows,
+                         set_t& priority_bumped_parents,
+                         graph_t& sorted_graph,
+                         repack_stats_t& stats)
 {
   bool resolution_attempted = false;
 
@@ -303,6 +381,7 @@ bool _process_overflows (const hb_vector_t<graph::overflow_record_t>& overflows,
       // The child object is shared, we may be able to eliminate the overflow
       // by duplicating it.
       if (!_resolve_shared_overflow(overflows, i, sorted_graph)) continue;
+      stats.strategies |= REPACK_STRATEGY_DUPLICATION;
       return true;
     }
 
@@ -321,6 +400,7 @@ bool _process_overflows (const hb_vector_t<graph::overflow_record_t>& overflows,
       //                     the length of other offsets.
       if (sorted_graph.raise_childrens_priority (r.parent)) {
         priority_bumped_parents.add (r.parent);
+        stats.strategies |= REPACK_STRATEGY_PRIORITY;
         resolution_attempted = true;
       }
       continue;
@@ -334,11 +414,13 @@ bool _process_overflows (const hb_vector_t<graph::overflow_record_t>& overflows,
   return resolution_attempted;
 }
 
-inline bool
-hb_resolve_graph_overflows (hb_tag_t table_tag,
-                            unsigned max_rounds ,
-                            bool always_recalculate_extensions,
-                            graph_t& sorted_graph /* IN/OUT */)
+static inline bool
+_resolve_graph_overflows (tag_t table_tag,
+                          const repack_budget_t& budget,
+                          const repack_deadline_t& deadline,
+                          bool always_recalculate_extensions,
+                          graph_t& sorted_graph, /* IN/OUT */
+                          repack_stats_t& stats /* OUT */)
 {
   DEBUG_MSG (SUBSET_REPACK, nullptr, "Repacking %c%c%c%c.", HB_UNTAG(table_tag));
   sorted_graph.sort_shortest_distance ();
@@ -348,6 +430,7 @@ hb_resolve_graph_overflows (hb_tag_t table_tag,
     return false;
   }
 
+  stats.strategies |= REPACK_STRATEGY_SORT;
   bool will_overflow = graph::will_overflow (sorted_graph);
   if (!will_overflow)
     return true;
@@ -370,34 +453,52 @@ hb_resolve_graph_overflows (hb_tag_t table_tag,
         DEBUG_MSG (SUBSET_REPACK, nullptr, "Extensions promotion failed.");
         return false;
       }
+      stats.strategies |= REPACK_STRATEGY_EXTENSION_PROMOTION;
     }
 
     DEBUG_MSG (SUBSET_REPACK, nullptr, "Assigning spaces to 32 bit subgraphs.");
     if (sorted_graph.assign_spaces ())
+    {
+      stats.strategies |= REPACK_STRATEGY_SPACE_ASSIGNMENT;
       sorted_graph.sort_shortest_distance ();
+    }
     else
       sorted_graph.sort_shortest_distance_if_needed ();
   }
 
-  unsigned round = 0;
-  hb_vector_t<graph::overflow_record_t> overflows;
+  // Rounds are counted in stats, so that a re-run with extension promotion
+  // continues from the rounds already spent rather than starting afresh.
+  bool no_resolution = false;
+  vector_t<graph::overflow_record_t> overflows;
   // TODO(garretrieger): select a good limit for max rounds.
   while (!sorted_graph.in_error ()
          && graph::will_overflow (sorted_graph, &overflows)
-         && round < max_rounds) {
-    DEBUG_MSG (SUBSET_REPACK, nullptr, "=== Overflow resolution round %u ===", round);
+         && stats.rounds < budget.max_rounds) {
+    if ((budget.max_total_rounds && stats.total_rounds >= budget.max_total_rounds)
+        || deadline.expired ())
+    {
+      DEBUG_MSG (SUBSET_REPACK, nullptr, "Repacking budget exceeded after %u rounds.", stats.total_rounds);
+      stats.budget_exceeded = true;
+      break;
+    }
+
+    DEBUG_MSG (SUBSET_REPACK, nullptr, "=== Overflow resolution round %u ===", stats.rounds);
     print_overflows (sorted_graph, overflows);
 
-    hb_set_t priority_bumped_parents;
+    set_t priority_bumped_parents;
 
-    if (!_try_isolating_subgraphs (overflows, sorted_graph))
+    stats.total_rounds++;
+    if (_try_isolating_subgraphs (overflows, sorted_graph))
+      stats.strategies |= REPACK_STRATEGY_ISOLATION;
+    else
     {
       // Don't count space isolation towards round limit. Only increment
       // round counter if space isolation made no changes.
-      round++;
-      if (!_process_overflows (overflows, priority_bumped_parents, sorted_graph))
+      stats.rounds++;
+      if (!_process_overflows (overflows, priority_bumped_parents, sorted_graph, stats))
       {
         DEBUG_MSG (SUBSET_REPACK, nullptr, "No resolution available :(");
+        no_resolution = true;
         break;
       }
     }
@@ -413,11 +514,19 @@ hb_resolve_graph_overflows (hb_tag_t table_tag,
 
   if (graph::will_overflow (sorted_graph))
   {
+    if (!no_resolution && stats.rounds >= budget.max_rounds)
+    {
+      DEBUG_MSG (SUBSET_REPACK, nullptr, "Repacking round budget exceeded.");
+      stats.budget_exceeded = true;
+    }
+
     if (is_gsub_or_gpos && !always_recalculate_extensions) {
       // If this a GSUB/GPOS table and we didn't try to extension promotion and table splitting then
-      // as a last ditch effort, re-run the repacker with it enabled.
+      // as a last ditch effort, re-run the repacker with it enabled. This is also the fallback once
+      // the budget is exhausted: promotion and splitting run in a single pass, and the round loop
+      // of the re-run only gets the rounds and time left.
       DEBUG_MSG (SUBSET_REPACK, nullptr, "Failed to find a resolution. Re-running with extension promotion and table splitting enabled.");
-      return hb_resolve_graph_overflows (table_tag, max_rounds, true, sorted_graph);
+      return _resolve_graph_overflows (table_tag, budget, deadline, true, sorted_graph, stats);
     }
 
     DEBUG_MSG (SUBSET_REPACK, nullptr, "Offset overflow resolution failed.");
@@ -427,6 +536,34 @@ hb_resolve_graph_overflows (hb_tag_t table_tag,
   return true;
 }
 
+inline bool
+resolve_graph_overflows (tag_t table_tag,
+                         const repack_budget_t& budget,
+                         bool always_recalculate_extensions,
+                         graph_t& sorted_graph, /* IN/OUT */
+                         repack_stats_t* stats = nullptr /* OUT */)
+{
+  repack_stats_t local_stats;
+  if (!stats) stats = &local_stats;
+  *stats = repack_stats_t ();
+
+  repack_deadline_t deadline (budget.max_time_ms);
+  return _resolve_graph_overflows (table_tag, budget, deadline,
+                                   always_recalculate_extensions,
+                                   sorted_graph, *stats);
+}
+
+inline bool
+resolve_graph_overflows (tag_t table_tag,
+                         unsigned max_rounds ,
+                         bool always_recalculate_extensions,
+                         graph_t& sorted_graph /* IN/OUT */)
+{
+  repack_budget_t budget;
+  budget.max_rounds = max_rounds;
+  return resolve_graph_overflows (table_tag, budget, always_recalculate_extensions, sorted_graph);
+}
+
 /*
  * Attempts to modify the topological sorting of the provided object graph to
  * eliminate offset overflows in the links between objects of the graph. If a
@@ -437,15 +574,20 @@ hb_resolve_graph_overflows (hb_tag_t table_tag,
  * affect the functionality of the graph. For example shared objects may be
  * duplicated.
  *
+ * The work done is bounded by budget. An overflowing graph can not be
+ * serialized, so when the budget runs out before a resolution is found
+ * nullptr is returned and stats->budget_exceeded is set.
+ *
  * For a detailed writeup describing how the algorithm operates see:
  * docs/repacker.md
  */
 template<typename T>
-inline hb_blob_t*
-hb_resolve_overflows (const T& packed,
-                      hb_tag_t table_tag,
-                      unsigned max_rounds = 32,
-                      bool recalculate_extensions = false) {
+inline blob_t*
+resolve_overflows (const T& packed,
+                   tag_t table_tag,
+                   const repack_budget_t& budget,
+                   bool recalculate_extensions = false,
+                   repack_stats_t* stats = nullptr /* OUT */) {
   graph_t sorted_graph (packed);
   if (sorted_graph.in_error ())
   {
@@ -467,10 +609,21 @@ hb_resolve_overflows (const T& packed,
     return nullptr;
   }
 
-  if (!hb_resolve_graph_overflows (table_tag, max_rounds, recalculate_extensions, sorted_graph))
+  if (!resolve_graph_overflows (table_tag, budget, recalculate_extensions, sorted_graph, stats))
     return nullptr;
 
   return graph::serialize (sorted_graph);
 }
 
+template<typename T>
+inline blob_t*
+resolve_overflows (const T& packed,
+                   tag_t table_tag,
+                   unsigned max_rounds = 32,
+                   bool recalculate_extensions = false) {
+  repack_budget_t budget;
+  budget.max_rounds = max_rounds;
+  return resolve_overflows (packed, table_tag, budget, recalculate_extensions);
+}
+
 #endif /* HB_REPACKER_HH */
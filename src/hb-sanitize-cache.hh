@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_SANITIZE_CACHE_HH
+#define HB_SANITIZE_CACHE_HH
+
+#include "hb.hh"
+
+#include "hb-blob.hh"
+#include "hb-map.hh"
+#include "hb-mutex.hh"
+#include "hb-open-type.hh"
+#include "hb-sha256.hh"
+
+
+/* Tables of a face that are known to pass sanitizing without edits.
+ *
+ * Verdicts are recorded as tables of the face get sanitized, and can be
+ * exported and fed back to a later face on the same font file, to skip
+ * sanitizing those tables there.  Each verdict carries the table length,
+ * the glyph count it was checked against and a SHA-256 digest of the
+ * whole table, so a table that differs in any byte is sanitized again. */
+struct sanitize_cache_t
+{
+  static constexpr tag_t MAGIC = HB_TAG ('h','b','S','C');
+  static constexpr unsigned VERSION = 2;
+
+  struct verdict_t
+  {
+    unsigned length;
+    unsigned num_glyphs;
+    sha256_t::digest_t digest;
+
+    bool operator == (const verdict_t &o) const
+    {
+      return length == o.length &&
+	     num_glyphs == o.num_glyphs &&
+	     digest == o.digest;
+    }
+  };
+
+  /* Serialized form, all big-endian. */
+  struct header_t
+  {
+    OT::Tag		magic;
+    OT::HBUINT32	version;
+    OT::HBUINT32	count;
+    public:
+    DEFINE_SIZE_STATIC (12);
+  };
+  struct record_t
+  {
+    OT::Tag		tag;
+    OT::HBUINT32	length;
+    OT::HBUINT32	num_glyphs;
+    OT::HBUINT8		digest[sha256_t::DIGEST_SIZE];
+    public:
+    DEFINE_SIZE_STATIC (12 + sha256_t::DIGEST_SIZE);
+  };
+
+  static verdict_t make_verdict (const blob_t *blob, unsigned num_glyphs)
+  {
+    return verdict_t {blob->length, num_glyphs,
+		      sha256_t::digest (blob->data, blob->length)};
+  }
+
+  bool is_trusted (tag_t tag, const blob_t *blob, unsigned num_glyphs) const
+  {
+    if (!blob->length) return false;
+
+    verdict_t verdict = make_verdict (blob, num_glyphs);
+
+    lock_t l (lock);
+    const verdict_t *trusted;
+    return verdicts.has (tag, &trusted) && *trusted == verdict;
+  }
+
+  void record (tag_t tag, const blob_t *blob, unsigned num_glyphs)
+  {
+    if (!blob->length) return;
+
+    verdict_t verdict = make_verdict (blob, num_glyphs);
+
+    lock_t l (lock);
+    verdicts.set (tag, verdict);
+  }
+
+  /* Adds the verdicts in a blob made by serialize().  Returns false if the
+   * blob is not one. */
+  bool load (const blob_t *blob)
+  {
+    const char *data = blob->data;
+    unsigned length = blob->length;
+    if (length < header_t::static_size) return false;
+
+    const header_t &header = * (const header_t *) data;
+    if (header.magic != MAGIC || header.version != VERSION) return false;
+    unsigned count = header.count;
+    if ((length - header_t::static_size) / record_t::static_size < count) return false;
+
+    lock_t l (lock);
+    const record_t *records = (const record_t *) (data + header_t::static_size);
+    for (unsigned i = 0; i < count; i++)
+    {
+      verdict_t verdict = {records[i].length, records[i].num_glyphs, {}};
+      for (unsigned j = 0; j < sha256_t::DIGEST_SIZE; j++)
+	verdict.digest.bytes[j] = records[i].digest[j];
+      verdicts.set (records[i].tag, verdict);
+    }
+    return !verdicts.in_error ();
+  }
+
+  blob_t *serialize () const
+  {
+    lock_t l (lock);
+
+    unsigned size = header_t::static_size + verdicts.get_population () * record_t::static_size;
+    char *data = (char *) calloc (1, size);
+    if (unlikely (!data)) return blob_get_empty ();
+
+    header_t &header = * (header_t *) data;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.count = verdicts.get_population ();
+
+    record_t *record = (record_t *) (data + header_t::static_size);
+    for (auto _ : verdicts.iter ())
+    {
+      record->tag = _.first;
+      record->length = _.second.length;
+      record->num_glyphs = _.second.num_glyphs;
+      for (unsigned j = 0; j < sha256_t::DIGEST_SIZE; j++)
+	record->digest[j] = _.second.digest.bytes[j];
+      record++;
+    }
+
+    return blob_create (data, size, HB_MEMORY_MODE_WRITABLE, data, free);
+  }
+
+  unsigned get_memory_usage () const
+  {
+    lock_t l (lock);
+    return verdicts.get_memory_usage ();
+  }
+
+  protected:
+  mutable mutex_t lock; /* Protects members below. */
+  hashmap_t<tag_t, verdict_t> verdicts;
+};
+
+
+#endif /* HB_SANITIZE_CACHE_HH */
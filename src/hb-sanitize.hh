@@ -117,6 +117,24 @@
 #define HB_SANITIZE_MAX_SUBTABLES 0x4000
 #endif
 
+/* Sanitize verdicts a face remembers; see face_set_sanitize_cache(). */
+HB_INTERNAL bool
+face_sanitize_cache_is_trusted (const hb_face_t *face, hb_tag_t tag,
+				const hb_blob_t *blob, unsigned num_glyphs);
+HB_INTERNAL void
+face_sanitize_cache_record (const hb_face_t *face, hb_tag_t tag,
+			    const hb_blob_t *blob, unsigned num_glyphs);
+
+/* Tables a face shares with its siblings; see face_create_sibling(). */
+HB_INTERNAL hb_blob_t *
+face_shared_tables_reference (const hb_face_t *face, hb_tag_t tag,
+			      const hb_blob_t *blob, unsigned num_glyphs,
+			      bool lazy);
+HB_INTERNAL hb_blob_t *
+face_shared_tables_set (const hb_face_t *face, hb_tag_t tag,
+			const char *data, unsigned length, unsigned num_glyphs,
+			bool lazy, hb_blob_t *sanitized);
+
 struct hb_sanitize_context_t :
        hb_dispatch_context_t<hb_sanitize_context_t, bool, HB_DEBUG_SANITIZE>
 {
@@ -125,7 +143,7 @@ struct hb_sanitize_context_t :
 	length (0),
 	max_ops (0), max_subtables (0),
         recursion_depth (0),
-	writable (false), edit_count (0),
+	writable (false), edit_count (0), edited (false),
 	blob (nullptr),
 	num_glyphs (65536),
 	num_glyphs_set (false),
@@ -431,6 +449,7 @@ struct hb_sanitize_context_t :
     bool sane;
 
     init (blob);
+    edited = false;
 
   retry:
     DEBUG_MSG_FUNC (SANITIZE, start, "start");
@@ -451,6 +470,7 @@ struct hb_sanitize_context_t :
       if (edit_count)
       {
 	DEBUG_MSG_FUNC (SANITIZE, start, "passed first round with %u edits; going for second round", edit_count);
+	edited = true;
 
 	/* sanitize again to ensure no toe-stepping */
 	edit_count = 0;
@@ -470,6 +490,7 @@ struct hb_sanitize_context_t :
 	if (start)
 	{
 	  writable = true;
+	  edited = true;
 	  /* ok, we made it writable by relocating.  try again */
 	  DEBUG_MSG_FUNC (SANITIZE, start, "retry");
 	  goto retry;
@@ -497,7 +518,35 @@ struct hb_sanitize_context_t :
   {
     if (!num_glyphs_set)
       set_num_glyphs (hb_face_get_glyph_count (face));
-    return sanitize_blob<Type> (hb_face_reference_table (face, tableTag));
+    hb_blob_t *blob = hb_face_reference_table (face, tableTag);
+#ifndef HB_NO_FACE_SHARED_TABLES
+    /* Sanitized by a sibling face already? */
+    if (hb_blob_t *shared = face_shared_tables_reference (face, tableTag, blob,
+							  num_glyphs, lazy_some_gpos))
+    {
+      hb_blob_destroy (blob);
+      return shared;
+    }
+    const char *data = blob->data;
+    unsigned length = blob->length;
+#endif
+#ifndef HB_NO_SANITIZE_CACHE
+    if (face_sanitize_cache_is_trusted (face, tableTag, blob, num_glyphs))
+      hb_blob_make_immutable (blob);
+    else
+    {
+      blob = sanitize_blob<Type> (blob);
+      if (!edited)
+	face_sanitize_cache_record (face, tableTag, blob, num_glyphs);
+    }
+#else
+    blob = sanitize_blob<Type> (blob);
+#endif
+#ifndef HB_NO_FACE_SHARED_TABLES
+    blob = face_shared_tables_set (face, tableTag, data, length,
+				   num_glyphs, lazy_some_gpos, blob);
+#endif
+    return blob;
   }
 
   const char *start, *end;
@@ -507,6 +556,7 @@ struct hb_sanitize_context_t :
   int recursion_depth;
   bool writable;
   unsigned int edit_count;
+  bool edited; /* Whether the last sanitize_blob() edited the blob. */
   hb_blob_t *blob;
   unsigned int num_glyphs;
   bool  num_glyphs_set;
@@ -0,0 +1,143 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#ifndef HB_SHA256_HH
+#define HB_SHA256_HH
+
+#include "hb.hh"
+
+
+/* SHA-256 (FIPS 180-4), for telling whether data is byte for byte what
+ * it was when last seen. */
+struct sha256_t
+{
+  static constexpr unsigned DIGEST_SIZE = 32;
+
+  struct digest_t
+  {
+    uint8_t bytes[DIGEST_SIZE];
+
+    bool operator == (const digest_t &o) const
+    { return 0 == memcmp (bytes, o.bytes, DIGEST_SIZE); }
+  };
+
+  static digest_t digest (const char *data, unsigned length)
+  {
+    sha256_t sha;
+    sha.update ((const uint8_t *) data, length);
+    return sha.finish ();
+  }
+
+  void update (const uint8_t *data, unsigned length)
+  {
+    total += length;
+    if (fill)
+    {
+      unsigned n = min (length, 64u - fill);
+      memcpy (block + fill, data, n);
+      fill += n;
+      data += n;
+      length -= n;
+      if (fill < 64) return;
+      compress (block);
+      fill = 0;
+    }
+    for (; length >= 64; data += 64, length -= 64)
+      compress (data);
+    memcpy (block, data, length);
+    fill = length;
+  }
+
+  digest_t finish ()
+  {
+    uint64_t bits = total * 8;
+    static const uint8_t pad[64] = {0x80};
+    update (pad, fill < 56 ? 56 - fill : 120 - fill);
+    uint8_t length_bytes[8];
+    for (unsigned i = 0; i < 8; i++)
+      length_bytes[i] = bits >> (56 - 8 * i);
+    update (length_bytes, 8);
+
+    digest_t d;
+    for (unsigned i = 0; i < 8; i++)
+    {
+      d.bytes[4 * i + 0] = state[i] >> 24;
+      d.bytes[4 * i + 1] = state[i] >> 16;
+      d.bytes[4 * i + 2] = state[i] >> 8;
+      d.bytes[4 * i + 3] = state[i];
+    }
+    return d;
+  }
+
+  private:
+  static uint32_t rotr (uint32_t x, unsigned n) { return (x >> n) | (x << (32 - n)); }
+
+  void compress (const uint8_t *p)
+  {
+    static const uint32_t K[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    uint32_t w[64];
+    for (unsigned i = 0; i < 16; i++)
+      w[i] = (uint32_t) p[4 * i] << 24 | (uint32_t) p[4 * i + 1] << 16 |
+	     (uint32_t) p[4 * i + 2] << 8 | (uint32_t) p[4 * i + 3];
+    for (unsigned i = 16; i < 64; i++)
+    {
+      uint32_t s0 = rotr (w[i - 15], 7) ^ rotr (w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr (w[i - 2], 17) ^ rotr (w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (unsigned i = 0; i < 64; i++)
+    {
+      uint32_t t1 = h + (rotr (e, 6) ^ rotr (e, 11) ^ rotr (e, 25)) +
+		    ((e & f) ^ (~e & g)) + K[i] + w[i];
+      uint32_t t2 = (rotr (a, 2) ^ rotr (a, 13) ^ rotr (a, 22)) +
+		    ((a & b) ^ (a & c) ^ (b & c));
+      h = g; g = f; f = e; e = d + t1;
+      d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+  }
+
+  uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  uint8_t block[64];
+  unsigned fill = 0;
+  uint64_t total = 0;
+};
+
+
+#endif /* HB_SHA256_HH */
@@ -240,7 +240,7 @@ shape_plan_create2 (face_t                     *face,
 
   if (unlikely (!props))
     goto bail;
-  if (!(shape_plan = object_create<shape_plan_t> ()))
+  if (!(shape_plan = object_create_pooled<shape_plan_t> ()))
     goto bail;
 
   if (unlikely (!face))
@@ -269,7 +269,7 @@ bail3:
 #endif
   shape_plan->key.fini ();
 bail2:
-  free (shape_plan);
+  object_free_pooled (shape_plan);
 bail:
   return shape_plan_get_empty ();
 }
@@ -320,7 +320,7 @@ shape_plan_destroy (shape_plan_t *shape_plan)
 {
   if (!object_destroy (shape_plan)) return;
 
-  free (shape_plan);
+  object_free_pooled (shape_plan);
 }
 
 /**
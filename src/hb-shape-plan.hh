@@ -71,6 +71,16 @@ struct hb_shape_plan_t
 #ifndef HB_NO_OT_SHAPE
   hb_ot_shape_plan_t ot;
 #endif
+
+  /* Shaper-private data is not accounted for. */
+  unsigned get_memory_usage () const
+  {
+    unsigned size = key.num_user_features * sizeof (hb_feature_t);
+#ifndef HB_NO_OT_SHAPE
+    size += ot.map.get_memory_usage ();
+#endif
+    return size;
+  }
 };
 
 
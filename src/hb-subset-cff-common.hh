@@ -31,6 +31,7 @@
 
 #include "hb-subset-plan.hh"
 #include "hb-cff-interp-cs-common.hh"
+#include "hb-thread-pool.hh"
 
 namespace CFF {
 
@@ -387,7 +388,14 @@ struct subr_closures_t
       local_closures[i].clear();
   }
 
-  bool in_error () const { return local_closures.in_error (); }
+  bool in_error () const
+  {
+    if (global_closure.in_error () || local_closures.in_error ()) return true;
+    for (const set_t &closure : local_closures)
+      if (closure.in_error ()) return true;
+    return false;
+  }
+
   set_t  global_closure;
   vector_t<set_t> local_closures;
 };
@@ -759,29 +767,26 @@ struct subr_subsetter_t
       return false;
     }
 
+    if (unlikely (!collect_glyph_fds ()))
+      return false;
+
     /* phase 1 & 2 */
+    unsigned i = 0;
     for (auto _ : plan->new_to_old_gid_list)
     {
       codepoint_t new_glyph = _.first;
       codepoint_t old_glyph = _.second;
-
-      const ubytes_t str = (*acc.charStrings)[old_glyph];
-      unsigned int fd = acc.fdSelect->get_fd (old_glyph);
-      if (unlikely (fd >= acc.fdCount))
-        return false;
+      unsigned int fd = glyph_fds.arrayZ[i++];
 
       if (cff_accelerator)
       {
-        // parsed string already exists in accelerator, copy it and move
-        // on.
-        if (cached_charstrings)
-          cached_charstrings[new_glyph] = &cff_accelerator->parsed_charstrings[old_glyph];
-        else
-          parsed_charstrings[new_glyph] = cff_accelerator->parsed_charstrings[old_glyph];
-
+        // parsed string already exists in accelerator, point to it and
+        // move on.
+        cached_charstrings.arrayZ[new_glyph] = &cff_accelerator->parsed_charstrings[old_glyph];
         continue;
       }
 
+      const ubytes_t str = (*acc.charStrings)[old_glyph];
       ENV env (str, acc, fd);
       cs_interpreter_t<ENV, OPSET, subr_subset_param_t> interp (env);
 
@@ -851,10 +856,10 @@ struct subr_subsetter_t
     if (unlikely (!buffArray.resize_exact (num_glyphs)))
       return false;
     codepoint_t last = 0;
+    unsigned i = 0;
     for (auto _ : plan->new_to_old_gid_list)
     {
       codepoint_t gid = _.first;
-      codepoint_t old_glyph = _.second;
 
       if (endchar_op != OpCode_Invalid)
         for (; last < gid; last++)
@@ -866,9 +871,7 @@ struct subr_subsetter_t
 	}
 
       last++; // Skip over gid
-      unsigned int  fd = acc.fdSelect->get_fd (old_glyph);
-      if (unlikely (fd >= acc.fdCount))
-	return false;
+      unsigned int  fd = glyph_fds.arrayZ[i++];
       if (unlikely (!encode_str (get_parsed_charstring (gid), fd, buffArray.arrayZ[gid], encode_prefix)))
 	return false;
     }
@@ -1047,25 +1050,95 @@ struct subr_subsetter_t
                             const vector_t<parsed_cs_str_vec_t>& local_subrs)
   {
     closures.reset ();
-    for (auto _ : plan->new_to_old_gid_list)
+    unsigned count = plan->new_to_old_gid_list.length;
+    unsigned num_chunks = min (plan->max_threads, count);
+    if (num_chunks <= 1)
     {
-      codepoint_t new_glyph = _.first;
-      codepoint_t old_glyph = _.second;
-      unsigned int fd = acc.fdSelect->get_fd (old_glyph);
-      if (unlikely (fd >= acc.fdCount))
+      closure_subroutines (global_subrs, local_subrs, 0, count, closures);
+      return !closures.in_error ();
+    }
+
+    /* The closure only reads parsed charstrings, so chunks of glyphs can be
+     * walked concurrently, each into sets of its own that are merged at the
+     * end.  A subroutine reached from several chunks is walked once per
+     * chunk. */
+    vector_t<subr_closures_t> chunk_closures;
+    if (unlikely (!chunk_closures.alloc (num_chunks, true)))
+      return false;
+    for (unsigned i = 0; i < num_chunks; i++)
+      chunk_closures.push (closures.local_closures.length);
+    if (unlikely (chunk_closures.in_error ()))
+      return false;
+
+    parallel_for (num_chunks, num_chunks,
+		  [&] (unsigned i)
+		  {
+		    closure_subroutines (global_subrs, local_subrs,
+					 count * i / num_chunks,
+					 count * (i + 1) / num_chunks,
+					 chunk_closures.arrayZ[i]);
+		  });
+
+    for (const subr_closures_t &chunk : chunk_closures)
+    {
+      if (unlikely (chunk.in_error ()))
         return false;
+      closures.global_closure.union_ (chunk.global_closure);
+      for (unsigned fd = 0; fd < closures.local_closures.length; fd++)
+	closures.local_closures.arrayZ[fd].union_ (chunk.local_closures.arrayZ[fd]);
+    }
+    return !closures.in_error ();
+  }
+
+  /* Closure of the glyphs at [start, end) of plan->new_to_old_gid_list. */
+  void closure_subroutines (const parsed_cs_str_vec_t& global_subrs,
+                            const vector_t<parsed_cs_str_vec_t>& local_subrs,
+                            unsigned start, unsigned end,
+                            subr_closures_t &out)
+  {
+    for (unsigned i = start; i < end; i++)
+    {
+      codepoint_t new_glyph = plan->new_to_old_gid_list.arrayZ[i].first;
+      unsigned int fd = glyph_fds.arrayZ[i];
 
       // Note: const cast is safe here because the collect_subr_refs_in_str only performs a
       //       closure and does not modify any of the charstrings.
       subr_subset_param_t  param (const_cast<parsed_cs_str_t*> (&get_parsed_charstring (new_glyph)),
                                   const_cast<parsed_cs_str_vec_t*> (&global_subrs),
                                   const_cast<parsed_cs_str_vec_t*> (&local_subrs[fd]),
-                                  &closures.global_closure,
-                                  &closures.local_closures[fd],
+                                  &out.global_closure,
+                                  &out.local_closures[fd],
                                   plan->flags & HB_SUBSET_FLAGS_NO_HINTING);
       collect_subr_refs_in_str (get_parsed_charstring (new_glyph), param);
     }
+  }
+
+  /* Look up the font dict of each retained glyph once, in
+   * new_to_old_gid_list order; parsing, closure and encoding all walk the
+   * glyphs in that order.  FDSelect format 3 is a binary search per lookup,
+   * but consecutive glyphs almost always share a range, so remember the
+   * last one. */
+  bool collect_glyph_fds ()
+  {
+    if (unlikely (!glyph_fds.resize_exact (plan->new_to_old_gid_list.length, false)))
+      return false;
 
+    pair_t<unsigned, codepoint_t> range {0, 0};
+    codepoint_t range_start = 0;
+    unsigned i = 0;
+    for (auto _ : plan->new_to_old_gid_list)
+    {
+      codepoint_t old_glyph = _.second;
+      if (old_glyph < range_start || old_glyph >= range.second)
+      {
+	range = acc.fdSelect->get_fd_range (old_glyph);
+	range_start = old_glyph;
+      }
+      unsigned fd = range.first;
+      if (unlikely (fd >= acc.fdCount))
+	return false;
+      glyph_fds.arrayZ[i++] = fd;
+    }
     return true;
   }
 
@@ -1196,6 +1269,9 @@ struct subr_subsetter_t
 
   subr_remaps_t			remaps;
 
+  /* Font dict index of each entry in plan->new_to_old_gid_list. */
+  vector_t<unsigned>		glyph_fds;
+
   private:
 
   parsed_cs_str_vec_t		parsed_charstrings;
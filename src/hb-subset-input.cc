@@ -334,6 +334,91 @@ subset_input_set_flags (subset_input_t *input,
   input->flags = (subset_flags_t) value;
 }
 
+/**
+ * subset_input_get_max_threads:
+ * @input: a #subset_input_t object.
+ *
+ * Gets the maximum number of threads subsetting with @input may use.
+ *
+ * Return value: the maximum number of threads.
+ *
+ * Since: REPLACEME
+ **/
+HB_EXTERN unsigned int
+subset_input_get_max_threads (const subset_input_t *input)
+{
+  return input->max_threads;
+}
+
+/**
+ * subset_input_set_max_threads:
+ * @input: a #subset_input_t object.
+ * @max_threads: the maximum number of threads to use, including the
+ * calling one
+ *
+ * Lets subsetting spread its most expensive steps over up to @max_threads
+ * threads, which are created for the purpose and joined before subsetting
+ * returns.  Currently that is the IUP delta optimization done with
+ * %HB_SUBSET_FLAGS_OPTIMIZE_IUP_DELTAS, and the CFF subroutine closure of
+ * preprocessed faces or with %HB_SUBSET_FLAGS_NO_HINTING.  The output does
+ * not depend on the number of threads.
+ *
+ * The default, 1, does all the work on the calling thread.  Where threads
+ * are not available, so does any other value.
+ *
+ * Since: REPLACEME
+ **/
+HB_EXTERN void
+subset_input_set_max_threads (subset_input_t *input,
+				 unsigned int    max_threads)
+{
+  input->max_threads = max (max_threads, 1u);
+}
+
+/**
+ * subset_input_get_repack_budget:
+ * @input: a #subset_input_t object.
+ * @max_rounds: (out) (optional): the maximum number of repacking rounds
+ * @max_time_ms: (out) (optional): the time limit in milliseconds, or 0
+ *
+ * Gets the limits on resolving offset overflows set on @input.
+ *
+ * Since: REPLACEME
+ **/
+HB_EXTERN void
+subset_input_get_repack_budget (const subset_input_t *input,
+				   unsigned int         *max_rounds,
+				   unsigned int         *max_time_ms)
+{
+  if (max_rounds) *max_rounds = input->repack_max_rounds;
+  if (max_time_ms) *max_time_ms = input->repack_max_time_ms;
+}
+
+/**
+ * subset_input_set_repack_budget:
+ * @input: a #subset_input_t object.
+ * @max_rounds: the maximum number of repacking rounds
+ * @max_time_ms: the time limit in milliseconds, or 0 for none
+ *
+ * Limits the work done to resolve offset overflows in each subset table.
+ * A round duplicates or reprioritizes objects of the table; @max_time_ms
+ * is wall time, checked between rounds.  Once a limit is hit GSUB and GPOS
+ * fall back to extension promotion and subtable splitting, and any other
+ * table fails to subset, as does subsetting.
+ *
+ * The defaults are 32 rounds and no time limit.
+ *
+ * Since: REPLACEME
+ **/
+HB_EXTERN void
+subset_input_set_repack_budget (subset_input_t *input,
+				   unsigned int    max_rounds,
+				   unsigned int    max_time_ms)
+{
+  input->repack_max_rounds = max_rounds;
+  input->repack_max_time_ms = max_time_ms;
+}
+
 /**
  * subset_input_set_user_data: (skip)
  * @input: a #subset_input_t object.
@@ -119,6 +119,13 @@ struct hb_subset_input_t
   // If set loca format will always be the long version.
   bool force_long_loca = false;
 
+  // Threads subsetting may use, the calling one included.
+  unsigned max_threads = 1;
+
+  // Limits on resolving offset overflows; see repack_budget_t.
+  unsigned repack_max_rounds = 32;
+  unsigned repack_max_time_ms = 0;
+
   hb_hashmap_t<hb_tag_t, Triple> axes_location;
   hb_map_t glyph_map;
 #ifdef HB_EXPERIMENTAL_API
@@ -34,6 +34,16 @@
 
 constexpr static unsigned MAX_LOOKBACK = 8;
 
+/* Buffers reused across the contours of a glyph. */
+struct iup_scratch_t
+{
+  vector_t<unsigned> costs;
+  vector_t<int> chain;
+  vector_t<int> x_deltas, y_deltas;
+  contour_point_vector_t points;
+  vector_t<bool> indices;
+};
+
 static void _iup_contour_bound_forced_set (const array_t<const contour_point_t> contour_points,
                                            const array_t<const int> x_deltas,
                                            const array_t<const int> y_deltas,
@@ -172,82 +182,51 @@ static bool rotate_set (const set_t& org_set,
   return !out.in_error ();
 }
 
-/* Given two reference coordinates (start and end of contour_points array),
- * output interpolated deltas for points in between */
-static bool _iup_segment (const array_t<const contour_point_t> contour_points,
-                          const array_t<const int> x_deltas,
-                          const array_t<const int> y_deltas,
-                          const contour_point_t& p1, const contour_point_t& p2,
-                          int p1_dx, int p2_dx,
-                          int p1_dy, int p2_dy,
-                          vector_t<double>& interp_x_deltas, /* OUT */
-                          vector_t<double>& interp_y_deltas /* OUT */)
+/* Linear interpolation of deltas along one axis between two reference
+ * points, clamped to the reference deltas outside of their range. */
+struct iup_axis_t
 {
-  unsigned n = contour_points.length;
-  if (unlikely (!interp_x_deltas.resize (n, false) ||
-                !interp_y_deltas.resize (n, false)))
-    return false;
-
-  for (unsigned j = 0; j < 2; j++)
+  iup_axis_t (double c1, double c2, double d1, double d2)
   {
-    double x1, x2, d1, d2;
-    double *out;
-    if (j == 0)
+    if (c1 > c2)
     {
-      x1 = static_cast<double> (p1.x);
-      x2 = static_cast<double> (p2.x);
-      d1 = p1_dx;
-      d2 = p2_dx;
-      out = interp_x_deltas.arrayZ;
+      swap (c1, c2);
+      swap (d1, d2);
     }
-    else
+    lo = c1;
+    hi = c2;
+    if (c1 == c2)
     {
-      x1 = static_cast<double> (p1.y);
-      x2 = static_cast<double> (p2.y);
-      d1 = p1_dy;
-      d2 = p2_dy;
-      out = interp_y_deltas.arrayZ;
+      d_lo = d_hi = d1 == d2 ? d1 : 0.0;
+      scale = 0.0;
     }
-
-    if (x1 == x2)
-    {
-      if (d1 == d2)
-      {
-        for (unsigned i = 0; i < n; i++)
-          out[i] = d1;
-      }
-      else
-      {
-        for (unsigned i = 0; i < n; i++)
-          out[i] = 0.0;
-      }
-      continue;
-    }
-
-    if (x1 > x2)
+    else
     {
-      swap (x1, x2);
-      swap (d1, d2);
+      d_lo = d1;
+      d_hi = d2;
+      scale = (d2 - d1) / (c2 - c1);
     }
+  }
 
-    double scale = (d2 - d1) / (x2 - x1);
-    for (unsigned i = 0; i < n; i++)
-    {
-      double x = (j == 0 ? static_cast<double> (contour_points.arrayZ[i].x) : static_cast<double> (contour_points.arrayZ[i].y));
-      double d;
-      if (x <= x1)
-        d = d1;
-      else if (x >= x2)
-        d = d2;
-      else
-        d = d1 + (x - x1) * scale;
-
-      out[i] = d;
-    }
+  double interpolate (double c) const
+  {
+    if (c <= lo) return d_lo;
+    if (c >= hi) return d_hi;
+    return d_lo + (c - lo) * scale;
   }
-  return true;
-}
 
+  double lo, hi;
+  double d_lo, d_hi;
+  double scale;
+};
+
+/* Given two reference points p1 and p2 (just outside of the contour_points
+ * array on either side), check whether the deltas of all points in between
+ * can be inferred by interpolation within tolerance.
+ *
+ * This is called for every candidate pair of the dynamic programming below,
+ * so it does not materialize the interpolated deltas and compares squared
+ * distances. */
 static bool _can_iup_in_between (const array_t<const contour_point_t> contour_points,
                                  const array_t<const int> x_deltas,
                                  const array_t<const int> y_deltas,
@@ -256,20 +235,18 @@ static bool _can_iup_in_between (const array_t<const contour_point_t> contour_po
                                  int p1_dy, int p2_dy,
                                  double tolerance)
 {
-  vector_t<double> interp_x_deltas, interp_y_deltas;
-  if (!_iup_segment (contour_points, x_deltas, y_deltas,
-                     p1, p2, p1_dx, p2_dx, p1_dy, p2_dy,
-                     interp_x_deltas, interp_y_deltas))
-    return false;
+  const iup_axis_t x_axis (static_cast<double> (p1.x), static_cast<double> (p2.x), p1_dx, p2_dx);
+  const iup_axis_t y_axis (static_cast<double> (p1.y), static_cast<double> (p2.y), p1_dy, p2_dy);
+  double tolerance_sq = tolerance * tolerance;
 
   unsigned num = contour_points.length;
-
+  const contour_point_t *points = contour_points.arrayZ;
   for (unsigned i = 0; i < num; i++)
   {
-    double dx = static_cast<double> (x_deltas.arrayZ[i]) - interp_x_deltas.arrayZ[i];
-    double dy = static_cast<double> (y_deltas.arrayZ[i]) - interp_y_deltas.arrayZ[i];
-  
-    if (sqrt (dx * dx + dy * dy) > tolerance)
+    double dx = static_cast<double> (x_deltas.arrayZ[i]) - x_axis.interpolate (static_cast<double> (points[i].x));
+    double dy = static_cast<double> (y_deltas.arrayZ[i]) - y_axis.interpolate (static_cast<double> (points[i].y));
+
+    if (dx * dx + dy * dy > tolerance_sq)
       return false;
   }
   return true;
@@ -332,6 +309,7 @@ static bool _iup_contour_optimize_dp (const contour_point_vector_t& contour_poin
 static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_points,
                                    const array_t<const int> x_deltas,
                                    const array_t<const int> y_deltas,
+                                   iup_scratch_t& scratch,
                                    array_t<bool> opt_indices, /* OUT */
                                    double tolerance = 0.0)
 {
@@ -342,11 +320,12 @@ static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_
     return false;
 
   bool all_within_tolerance = true;
+  double tolerance_sq = tolerance * tolerance;
   for (unsigned i = 0; i < n; i++)
   {
     int dx = x_deltas.arrayZ[i];
     int dy = y_deltas.arrayZ[i];
-    if (sqrt ((double) dx * dx + (double) dy * dy) > tolerance)
+    if ((double) dx * dx + (double) dy * dy > tolerance_sq)
     {
       all_within_tolerance = false;
       break;
@@ -391,8 +370,8 @@ static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_
     if (k < 0)
       return false;
 
-    vector_t<int> rot_x_deltas, rot_y_deltas;
-    contour_point_vector_t rot_points;
+    vector_t<int> &rot_x_deltas = scratch.x_deltas, &rot_y_deltas = scratch.y_deltas;
+    contour_point_vector_t &rot_points = scratch.points;
     set_t rot_forced_set;
     if (!rotate_array (contour_points, k, rot_points) ||
         !rotate_array (x_deltas, k, rot_x_deltas) ||
@@ -400,8 +379,8 @@ static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_
         !rotate_set (forced_set, k, n, rot_forced_set))
       return false;
 
-    vector_t<unsigned> costs;
-    vector_t<int> chain;
+    vector_t<unsigned> &costs = scratch.costs;
+    vector_t<int> &chain = scratch.chain;
 
     if (!_iup_contour_optimize_dp (rot_points, rot_x_deltas, rot_y_deltas,
                                    rot_forced_set, tolerance, n,
@@ -423,17 +402,18 @@ static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_
     for (unsigned i : solution)
       opt_indices.arrayZ[i] = true;
 
-    vector_t<bool> rot_indices;
+    vector_t<bool> &rot_indices = scratch.indices;
     const array_t<const bool> opt_indices_array (opt_indices.arrayZ, opt_indices.length);
-    rotate_array (opt_indices_array, -k, rot_indices);
+    if (!rotate_array (opt_indices_array, -k, rot_indices))
+      return false;
 
     for (unsigned i = 0; i < n; i++)
       opt_indices.arrayZ[i] = rot_indices.arrayZ[i];
   }
   else
   {
-    vector_t<int> repeat_x_deltas, repeat_y_deltas;
-    contour_point_vector_t repeat_points;
+    vector_t<int> &repeat_x_deltas = scratch.x_deltas, &repeat_y_deltas = scratch.y_deltas;
+    contour_point_vector_t &repeat_points = scratch.points;
 
     if (unlikely (!repeat_x_deltas.resize (n * 2, false) ||
                   !repeat_y_deltas.resize (n * 2, false) ||
@@ -441,20 +421,17 @@ static bool _iup_contour_optimize (const array_t<const contour_point_t> contour_
       return false;
 
     unsigned contour_point_size = static_size (contour_point_t);
-    for (unsigned i = 0; i < n; i++)
-    {
-      memcpy ((void *) repeat_x_deltas.arrayZ, (const void *) x_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
-      memcpy ((void *) (repeat_x_deltas.arrayZ + n), (const void *) x_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
+    memcpy ((void *) repeat_x_deltas.arrayZ, (const void *) x_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
+    memcpy ((void *) (repeat_x_deltas.arrayZ + n), (const void *) x_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
 
-      memcpy ((void *) repeat_y_deltas.arrayZ, (const void *) y_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
-      memcpy ((void *) (repeat_y_deltas.arrayZ + n), (const void *) y_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
+    memcpy ((void *) repeat_y_deltas.arrayZ, (const void *) y_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
+    memcpy ((void *) (repeat_y_deltas.arrayZ + n), (const void *) y_deltas.arrayZ, n * sizeof (repeat_x_deltas[0]));
 
-      memcpy ((void *) repeat_points.arrayZ, (const void *) contour_points.arrayZ, n * contour_point_size);
-      memcpy ((void *) (repeat_points.arrayZ + n), (const void *) contour_points.arrayZ, n * contour_point_size);
-    }
+    memcpy ((void *) repeat_points.arrayZ, (const void *) contour_points.arrayZ, n * contour_point_size);
+    memcpy ((void *) (repeat_points.arrayZ + n), (const void *) contour_points.arrayZ, n * contour_point_size);
 
-    vector_t<unsigned> costs;
-    vector_t<int> chain;
+    vector_t<unsigned> &costs = scratch.costs;
+    vector_t<int> &chain = scratch.chain;
     if (!_iup_contour_optimize_dp (repeat_points, repeat_x_deltas, repeat_y_deltas,
                                    forced_set, tolerance, n,
                                    costs, chain))
@@ -516,6 +493,7 @@ bool iup_delta_optimize (const contour_point_vector_t& contour_points,
 
   if (end_points.in_error ()) return false;
 
+  iup_scratch_t scratch;
   unsigned start = 0;
   for (unsigned end : end_points)
   {
@@ -523,6 +501,7 @@ bool iup_delta_optimize (const contour_point_vector_t& contour_points,
     if (!_iup_contour_optimize (contour_points.as_array ().sub_array (start, len),
                                 x_deltas.as_array ().sub_array (start, len),
                                 y_deltas.as_array ().sub_array (start, len),
+                                scratch,
                                 opt_indices.as_array ().sub_array (start, len),
                                 tolerance))
       return false;
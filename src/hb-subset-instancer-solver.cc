@@ -432,3 +432,21 @@ rebase_tent (Triple tent, Triple axisLimit, TripleDistances axis_triple_distance
 
   return out;
 }
+
+rebase_tent_result_t
+rebase_tent_cache_t::rebase_tent (Triple tent, Triple axisLimit, TripleDistances axis_triple_distances)
+{
+  key_t key {tent, axisLimit, axis_triple_distances};
+  rebase_tent_result_t *cached;
+  if (cache.has (key, &cached))
+  {
+    hits++;
+    return *cached;
+  }
+
+  misses++;
+  rebase_tent_result_t out = ::rebase_tent (tent, axisLimit, axis_triple_distances);
+  /* A failed insertion only costs us the memoization. */
+  cache.set (key, out);
+  return out;
+}
@@ -26,6 +26,7 @@
 #define HB_SUBSET_INSTANCER_SOLVER_HH
 
 #include "hb.hh"
+#include "hb-map.hh"
 
 /* pre-normalized distances */
 struct TripleDistances
@@ -111,4 +112,45 @@ HB_INTERNAL rebase_tent_result_t rebase_tent (Triple tent,
 					      Triple axisLimit,
 					      TripleDistances axis_triple_distances);
 
+/* Memoizes rebase_tent () results.  During partial instancing the same
+ * (tent, axisLimit) pairs come up for the regions of gvar, cvar and every
+ * ItemVariationStore being instanced, so the subset plan keeps one of these
+ * around for its whole lifetime and shares it between all of them. */
+struct rebase_tent_cache_t
+{
+  struct key_t
+  {
+    Triple tent;
+    Triple axis_limit;
+    TripleDistances distances;
+
+    bool operator == (const key_t &o) const
+    {
+      return tent == o.tent &&
+	     axis_limit == o.axis_limit &&
+	     distances.negative == o.distances.negative &&
+	     distances.positive == o.distances.positive;
+    }
+
+    uint32_t hash () const
+    {
+      uint32_t current = tent.hash ();
+      current = current * 31 + axis_limit.hash ();
+      current = current * 31 + ::hash (distances.negative);
+      current = current * 31 + ::hash (distances.positive);
+      return current;
+    }
+  };
+
+  HB_INTERNAL rebase_tent_result_t rebase_tent (Triple tent,
+						Triple axisLimit,
+						TripleDistances axis_triple_distances);
+
+  bool in_error () const { return cache.in_error (); }
+
+  hashmap_t<key_t, rebase_tent_result_t> cache;
+  unsigned hits = 0;
+  unsigned misses = 0;
+};
+
 #endif /* HB_SUBSET_INSTANCER_SOLVER_HH */
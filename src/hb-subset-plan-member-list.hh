@@ -125,6 +125,8 @@ HB_SUBSET_PLAN_MEMBER (vector_t<int>, normalized_coords)
 HB_SUBSET_PLAN_MEMBER (hashmap_t E(<tag_t, Triple>), user_axes_location)
 //axis->TripleDistances map (distances in the pre-normalized space)
 HB_SUBSET_PLAN_MEMBER (hashmap_t E(<tag_t, TripleDistances>), axes_triple_distances)
+//memoized instancer solver results, shared by all tables being instanced
+HB_SUBSET_PLAN_MEMBER (mutable rebase_tent_cache_t, rebase_tent_cache)
 
 //retained old axis index -> new axis index mapping in fvar axis array
 HB_SUBSET_PLAN_MEMBER (map_t, axes_index_map)
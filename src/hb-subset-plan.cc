@@ -1297,6 +1297,9 @@ subset_plan_t::subset_plan_t (face_t *face,
 
   attach_accelerator_data = input->attach_accelerator_data;
   force_long_loca = input->force_long_loca;
+  max_threads = input->max_threads;
+  repack_max_rounds = input->repack_max_rounds;
+  repack_max_time_ms = input->repack_max_time_ms;
 #ifdef HB_EXPERIMENTAL_API
   force_long_loca = force_long_loca || (flags & HB_SUBSET_FLAGS_IFTB_REQUIREMENTS);
 #endif
@@ -1386,6 +1389,12 @@ subset_plan_t::subset_plan_t (face_t *face,
 
 subset_plan_t::~subset_plan_t()
 {
+  if (rebase_tent_cache.hits + rebase_tent_cache.misses)
+    DEBUG_MSG (SUBSET, nullptr, "Instancer solver: %u tents rebased, %u solved, %u from cache.",
+	       rebase_tent_cache.hits + rebase_tent_cache.misses,
+	       rebase_tent_cache.misses,
+	       rebase_tent_cache.hits);
+
   face_destroy (dest);
 
   map_destroy (codepoint_to_glyph);
@@ -142,6 +142,9 @@ struct hb_subset_plan_t
   unsigned flags;
   bool attach_accelerator_data = false;
   bool force_long_loca = false;
+  unsigned max_threads = 1;
+  unsigned repack_max_rounds = 32;
+  unsigned repack_max_time_ms = 0;
 
   // The glyph subset
   hb_map_t *codepoint_to_glyph; // Needs to be heap-allocated
@@ -27,11 +27,11 @@
 #ifdef HB_EXPERIMENTAL_API
 
 /**
- * hb_subset_repack_or_fail:
+ * subset_repack_or_fail:
  * @table_tag: tag of the table being packed, needed to allow table specific optimizations.
- * @hb_objects: raw array of struct hb_object_t, which provides
+ * @hb_objects: raw array of struct object_t, which provides
  * object graph info
- * @num_hb_objs: number of hb_object_t in the hb_objects array.
+ * @num_hb_objs: number of object_t in the hb_objects array.
  *
  * Given the input object graph info, repack a table to eliminate
  * offset overflows. A nullptr is returned if the repacking attempt fails.
@@ -40,19 +40,67 @@
  *
  * XSince: EXPERIMENTAL
  **/
-hb_blob_t* hb_subset_repack_or_fail (hb_tag_t table_tag,
-                                     hb_object_t* hb_objects,
-                                     unsigned num_hb_objs)
+blob_t* subset_repack_or_fail (tag_t table_tag,
+                               object_t* hb_objects,
+                               unsigned num_hb_objs)
 {
-  hb_vector_t<const hb_object_t *> packed;
+  return subset_repack_with_budget_or_fail (table_tag,
+                                            hb_objects,
+                                            num_hb_objs,
+                                            20,
+                                            0,
+                                            nullptr);
+}
+
+/**
+ * subset_repack_with_budget_or_fail:
+ * @table_tag: tag of the table being packed, needed to allow table specific optimizations.
+ * @hb_objects: raw array of struct object_t, which provides
+ * object graph info
+ * @num_hb_objs: number of object_t in the hb_objects array.
+ * @max_rounds: maximum number of overflow resolution rounds.
+ * @max_time_ms: maximum wall time to spend on overflow resolution, in
+ * milliseconds. 0 means no limit. The time is checked between resolution
+ * rounds, so it may be overrun by the duration of one round.
+ * @strategies: (out) (optional): the repacking strategies that were applied.
+ *
+ * Like subset_repack_or_fail(), but bounds the amount of work done. Once the
+ * budget is exhausted GSUB/GPOS tables fall back directly to extension
+ * promotion and subtable splitting; if the table still overflows nullptr is
+ * returned and %HB_SUBSET_REPACK_STRATEGY_BUDGET_EXCEEDED is set in
+ * @strategies.
+ *
+ * XSince: EXPERIMENTAL
+ **/
+blob_t* subset_repack_with_budget_or_fail (tag_t table_tag,
+                                           object_t* hb_objects,
+                                           unsigned num_hb_objs,
+                                           unsigned max_rounds,
+                                           unsigned max_time_ms,
+                                           subset_repack_strategy_t *strategies /* OUT */)
+{
+  vector_t<const object_t *> packed;
   packed.alloc (num_hb_objs + 1);
   packed.push (nullptr);
   for (unsigned i = 0 ; i < num_hb_objs ; i++)
     packed.push (&(hb_objects[i]));
 
-  return hb_resolve_overflows (packed,
-                               table_tag,
-                               20,
-                               true);
+  repack_budget_t budget;
+  budget.max_rounds = max_rounds;
+  budget.max_time_ms = max_time_ms;
+
+  repack_stats_t stats;
+  blob_t *result = resolve_overflows (packed,
+                                      table_tag,
+                                      budget,
+                                      true,
+                                      &stats);
+
+  if (strategies)
+    *strategies = (subset_repack_strategy_t)
+                  (stats.strategies |
+                   (stats.budget_exceeded ? HB_SUBSET_REPACK_STRATEGY_BUDGET_EXCEEDED : 0));
+
+  return result;
 }
 #endif
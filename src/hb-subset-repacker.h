@@ -32,23 +32,23 @@ HB_BEGIN_DECLS
 
 #ifdef HB_EXPERIMENTAL_API
 /*
- * struct hb_link_t
+ * struct link_t
  * width:    offsetSize in bytes
  * position: position of the offset field in bytes
  * from beginning of subtable
  * objidx:   index of subtable
  */
-struct hb_link_t
+struct link_t
 {
   unsigned width;
   unsigned position;
   unsigned objidx;
 };
 
-typedef struct hb_link_t hb_link_t;
+typedef struct link_t link_t;
 
 /*
- * struct hb_object_t
+ * struct object_t
  * head:    start of object data
  * tail:    end of object data
  * num_real_links:    num of offset field in the object
@@ -57,22 +57,57 @@ typedef struct hb_link_t hb_link_t;
  * after current object in the final serialized order
  * virtual_links:     array of virtual link info
  */
-struct hb_object_t
+struct object_t
 {
   char *head;
   char *tail;
   unsigned num_real_links;
-  hb_link_t *real_links;
+  link_t *real_links;
   unsigned num_virtual_links;
-  hb_link_t *virtual_links;
+  link_t *virtual_links;
 };
 
-typedef struct hb_object_t hb_object_t;
+typedef struct object_t object_t;
 
-HB_EXTERN hb_blob_t*
-hb_subset_repack_or_fail (hb_tag_t table_tag,
-                          hb_object_t* hb_objects,
-                          unsigned num_hb_objs);
+HB_EXTERN blob_t*
+subset_repack_or_fail (tag_t table_tag,
+                       object_t* hb_objects,
+                       unsigned num_hb_objs);
+
+/*
+ * subset_repack_strategy_t:
+ * @HB_SUBSET_REPACK_STRATEGY_NONE: no strategy was applied.
+ * @HB_SUBSET_REPACK_STRATEGY_SORT: objects were sorted by shortest distance.
+ * @HB_SUBSET_REPACK_STRATEGY_SPACE_ASSIGNMENT: 32 bit subgraphs were assigned
+ * their own spaces.
+ * @HB_SUBSET_REPACK_STRATEGY_ISOLATION: subgraphs were isolated into new spaces.
+ * @HB_SUBSET_REPACK_STRATEGY_DUPLICATION: shared objects were duplicated.
+ * @HB_SUBSET_REPACK_STRATEGY_PRIORITY: objects were moved closer to their parents.
+ * @HB_SUBSET_REPACK_STRATEGY_EXTENSION_PROMOTION: GSUB/GPOS subtables were
+ * split and lookups promoted to extension lookups.
+ * @HB_SUBSET_REPACK_STRATEGY_BUDGET_EXCEEDED: the round or time budget ran
+ * out before overflow resolution finished.
+ *
+ * Strategies used while repacking a table.
+ */
+typedef enum { /*< flags >*/
+  HB_SUBSET_REPACK_STRATEGY_NONE =		0x00u,
+  HB_SUBSET_REPACK_STRATEGY_SORT =		0x01u,
+  HB_SUBSET_REPACK_STRATEGY_SPACE_ASSIGNMENT =	0x02u,
+  HB_SUBSET_REPACK_STRATEGY_ISOLATION =		0x04u,
+  HB_SUBSET_REPACK_STRATEGY_DUPLICATION =	0x08u,
+  HB_SUBSET_REPACK_STRATEGY_PRIORITY =		0x10u,
+  HB_SUBSET_REPACK_STRATEGY_EXTENSION_PROMOTION = 0x20u,
+  HB_SUBSET_REPACK_STRATEGY_BUDGET_EXCEEDED =	0x80u,
+} subset_repack_strategy_t;
+
+HB_EXTERN blob_t*
+subset_repack_with_budget_or_fail (tag_t table_tag,
+                                   object_t* hb_objects,
+                                   unsigned num_hb_objs,
+                                   unsigned max_rounds,
+                                   unsigned max_time_ms,
+                                   subset_repack_strategy_t *strategies /* OUT */);
 
 #endif
 
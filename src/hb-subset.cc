@@ -252,20 +252,27 @@ _plan_estimate_subset_table_size (subset_plan_t *plan,
  * Repack the serialization buffer if any offset overflows exist.
  */
 static blob_t*
-_repack (tag_t tag, const serialize_context_t& c)
+_repack (const subset_plan_t *plan, tag_t tag, const serialize_context_t& c)
 {
   if (!c.offset_overflow ())
     return c.copy_blob ();
 
-  blob_t* result = resolve_overflows (c.object_graph (), tag);
+  repack_budget_t budget;
+  budget.max_rounds = plan->repack_max_rounds;
+  budget.max_time_ms = plan->repack_max_time_ms;
+
+  repack_stats_t stats;
+  blob_t* result = resolve_overflows (c.object_graph (), tag, budget, false, &stats);
 
   if (unlikely (!result))
   {
-    DEBUG_MSG (SUBSET, nullptr, "OT::%c%c%c%c offset overflow resolution failed.",
-               HB_UNTAG (tag));
+    DEBUG_MSG (SUBSET, nullptr, "OT::%c%c%c%c offset overflow resolution failed%s.",
+               HB_UNTAG (tag), stats.budget_exceeded ? " (budget exceeded)" : "");
     return nullptr;
   }
 
+  DEBUG_MSG (SUBSET, nullptr, "OT::%c%c%c%c repacked in %u rounds (strategies 0x%02x).",
+             HB_UNTAG (tag), stats.total_rounds, stats.strategies);
   return result;
 }
 
@@ -361,7 +368,7 @@ _subset (subset_plan_t *plan, vector_t<char> &buf)
   }
 
   bool result = false;
-  blob_t *dest_blob = _repack (tag, serializer);
+  blob_t *dest_blob = _repack (plan, tag, serializer);
   if (dest_blob)
   {
     DEBUG_MSG (SUBSET, nullptr,
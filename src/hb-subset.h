@@ -173,6 +173,23 @@ HB_EXTERN void
 subset_input_set_flags (subset_input_t *input,
 			   unsigned value);
 
+HB_EXTERN unsigned int
+subset_input_get_max_threads (const subset_input_t *input);
+
+HB_EXTERN void
+subset_input_set_max_threads (subset_input_t *input,
+				 unsigned int    max_threads);
+
+HB_EXTERN void
+subset_input_get_repack_budget (const subset_input_t *input,
+				   unsigned int         *max_rounds,
+				   unsigned int         *max_time_ms);
+
+HB_EXTERN void
+subset_input_set_repack_budget (subset_input_t *input,
+				   unsigned int    max_rounds,
+				   unsigned int    max_time_ms);
+
 HB_EXTERN bool_t
 subset_input_pin_all_axes_to_default (subset_input_t  *input,
 					 face_t          *face);
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#ifndef HB_THREAD_POOL_HH
+#define HB_THREAD_POOL_HH
+
+#include "hb.hh"
+
+#include "hb-atomic.hh"
+#include "hb-vector.hh"
+
+#if !defined(HB_NO_MT) && (defined(HAVE_PTHREAD) || defined(__APPLE__))
+#include <pthread.h>
+#define HB_THREAD_POOL_PTHREAD
+#endif
+
+
+/*
+ * parallel_for
+ *
+ * Runs func (i) for every i in [0, count) on up to num_threads threads,
+ * the calling one included, and returns when all calls are done.  The
+ * threads only live for the duration of the call.  Without thread support,
+ * or when threads can't be created, the calling thread does all the work.
+ *
+ * func is called concurrently with itself, for different i, so anything
+ * it writes besides per-index state must be synchronized by the caller.
+ */
+
+template <typename Func>
+struct parallel_for_context_t
+{
+  const Func &func;
+  unsigned count;
+  atomic_int_t next;
+
+  parallel_for_context_t (const Func &func, unsigned count) :
+    func (func), count (count) {}
+
+  void work ()
+  {
+    for (;;)
+    {
+      int i = next.inc ();
+      if (i >= (int) count) return;
+      func ((unsigned) i);
+    }
+  }
+
+#ifdef HB_THREAD_POOL_PTHREAD
+  static void *thread_func (void *data)
+  {
+    ((parallel_for_context_t *) data)->work ();
+    return nullptr;
+  }
+#endif
+};
+
+template <typename Func>
+static inline void
+parallel_for (unsigned num_threads, unsigned count, const Func &func)
+{
+  parallel_for_context_t<Func> c (func, count);
+  num_threads = min (num_threads, count);
+
+#ifdef HB_THREAD_POOL_PTHREAD
+  vector_t<pthread_t> threads;
+  for (unsigned i = 1; i < num_threads; i++)
+  {
+    pthread_t thread;
+    if (pthread_create (&thread, nullptr, c.thread_func, &c))
+      break; /* The threads we have will pick up the slack. */
+    threads.push (thread);
+    if (unlikely (threads.in_error ()))
+    {
+      /* Can't keep track of it; let it finish before going on. */
+      pthread_join (thread, nullptr);
+      break;
+    }
+  }
+#endif
+
+  c.work ();
+
+#ifdef HB_THREAD_POOL_PTHREAD
+  for (pthread_t thread : threads)
+    pthread_join (thread, nullptr);
+#endif
+}
+
+
+#endif /* HB_THREAD_POOL_HH */
@@ -173,6 +173,15 @@ struct vector_t
   explicit operator bool () const { return length; }
   unsigned get_size () const { return length * item_size; }
 
+  /* Heap memory used, including that owned by the items. */
+  unsigned get_memory_usage () const
+  {
+    unsigned size = allocated > 0 ? allocated * item_size : 0;
+    for (const Type &item : as_array ())
+      size += heap_size (item);
+    return size;
+  }
+
   /* Sink interface. */
   template <typename T>
   vector_t& operator << (T&& v) { push (std::forward<T> (v)); return *this; }
@@ -1771,6 +1771,51 @@ static void test_resolve_overflows_via_duplication ()
   blob_destroy (out);
 }
 
+static void test_resolve_overflows_budget ()
+{
+  size_t buffer_size = 160000;
+  void* buffer = malloc (buffer_size);
+  serialize_context_t c (buffer, buffer_size);
+  populate_serializer_with_dedup_overflow (&c);
+
+  repack_stats_t stats;
+  repack_budget_t budget;
+  blob_t* out = resolve_overflows (c.object_graph (), HB_TAG_NONE, budget, false, &stats);
+  assert (out);
+  assert (!stats.budget_exceeded);
+  assert (stats.strategies & REPACK_STRATEGY_DUPLICATION);
+  assert (stats.rounds >= 1);
+  blob_destroy (out);
+
+  budget.max_rounds = 0;
+  out = resolve_overflows (c.object_graph (), HB_TAG_NONE, budget, false, &stats);
+  assert (!out);
+  assert (stats.budget_exceeded);
+  assert (stats.rounds == 0);
+
+  // Twenty parents share one leaf; duplicating it takes more than one round.
+  size_t buffer_size2 = 300000;
+  void* buffer2 = malloc (buffer_size2);
+  serialize_context_t c2 (buffer2, buffer_size2);
+  populate_serializer_with_multiple_dedup_overflow (&c2);
+
+  budget = repack_budget_t ();
+  out = resolve_overflows (c2.object_graph (), HB_TAG_NONE, budget, false, &stats);
+  assert (out);
+  assert (!stats.budget_exceeded);
+  assert (stats.total_rounds > 1);
+  blob_destroy (out);
+
+  budget.max_total_rounds = 1;
+  out = resolve_overflows (c2.object_graph (), HB_TAG_NONE, budget, false, &stats);
+  assert (!out);
+  assert (stats.budget_exceeded);
+  assert (stats.total_rounds == 1);
+
+  free (buffer);
+  free (buffer2);
+}
+
 static void test_resolve_overflows_via_multiple_duplications ()
 {
   size_t buffer_size = 300000;
@@ -2271,6 +2316,7 @@ main (int argc, char **argv)
   test_resolve_overflows_via_sort ();
   test_resolve_overflows_via_duplication ();
   test_resolve_overflows_via_multiple_duplications ();
+  test_resolve_overflows_budget ();
   test_resolve_overflows_via_priority ();
   test_resolve_overflows_via_space_assignment ();
   test_resolve_overflows_via_isolation ();
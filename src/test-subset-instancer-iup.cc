@@ -0,0 +1,183 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+
+#include "hb-subset-instancer-iup.hh"
+
+/* Expected results come from fontTools.varLib.iup.iup_delta_optimize (). */
+
+static void
+make_glyph (contour_point_vector_t &points,
+	    const int (*coords)[2], unsigned count,
+	    const unsigned *end_points, unsigned end_count)
+{
+  points.resize (count + 4);
+  for (unsigned i = 0; i < count; i++)
+    points.arrayZ[i].init (coords[i][0], coords[i][1]);
+  for (unsigned i = 0; i < end_count; i++)
+    points.arrayZ[end_points[i]].is_end_point = true;
+  /* phantom points */
+  for (unsigned i = count; i < count + 4; i++)
+    points.arrayZ[i].init ();
+}
+
+static void
+make_deltas (hb_vector_t<int> &x_deltas, hb_vector_t<int> &y_deltas,
+	     const int (*deltas)[2], unsigned count)
+{
+  x_deltas.resize (count + 4);
+  y_deltas.resize (count + 4);
+  for (unsigned i = 0; i < count; i++)
+  {
+    x_deltas.arrayZ[i] = deltas[i][0];
+    y_deltas.arrayZ[i] = deltas[i][1];
+  }
+}
+
+static void
+check (const hb_vector_t<bool> &opt_indices, const bool *expected, unsigned count)
+{
+  assert (opt_indices.length == count);
+  for (unsigned i = 0; i < count; i++)
+    assert (opt_indices.arrayZ[i] == expected[i]);
+}
+
+static const int line[3][2] = {{0, 0}, {50, 0}, {100, 0}};
+static const int square[4][2] = {{0, 0}, {100, 0}, {100, 100}, {0, 100}};
+
+static void
+test_iup_within_tolerance ()
+{
+  static const unsigned ends[] = {3};
+  static const int deltas[4][2] = {{0, 0}, {0, 0}, {0, 0}, {0, 0}};
+  /* A phantom point delta is kept on its own. */
+  static const bool expected[8] = {false, false, false, false, true, false, false, false};
+
+  contour_point_vector_t points;
+  hb_vector_t<int> x_deltas, y_deltas;
+  hb_vector_t<bool> opt_indices;
+  make_glyph (points, square, 4, ends, 1);
+  make_deltas (x_deltas, y_deltas, deltas, 4);
+  x_deltas.arrayZ[4] = 1;
+  assert (iup_delta_optimize (points, x_deltas, y_deltas, opt_indices, 0.5));
+  check (opt_indices, expected, 8);
+}
+
+static void
+test_iup_all_equal ()
+{
+  static const unsigned ends[] = {3};
+  static const int deltas[4][2] = {{10, 10}, {10, 10}, {10, 10}, {10, 10}};
+  static const bool expected[8] = {true, false, false, false, false, false, false, false};
+
+  contour_point_vector_t points;
+  hb_vector_t<int> x_deltas, y_deltas;
+  hb_vector_t<bool> opt_indices;
+  make_glyph (points, square, 4, ends, 1);
+  make_deltas (x_deltas, y_deltas, deltas, 4);
+  assert (iup_delta_optimize (points, x_deltas, y_deltas, opt_indices, 0.5));
+  check (opt_indices, expected, 8);
+}
+
+/* The ends of the line are forced, and the middle interpolates between
+ * them; this takes the rotated-contour path. */
+static void
+test_iup_forced ()
+{
+  static const unsigned ends[] = {2};
+  contour_point_vector_t points;
+  hb_vector_t<int> x_deltas, y_deltas;
+  make_glyph (points, line, 3, ends, 1);
+
+  {
+    static const int deltas[3][2] = {{0, 0}, {5, 0}, {10, 0}};
+    static const bool expected[7] = {true, false, true, false, false, false, false};
+    hb_vector_t<bool> opt_indices;
+    make_deltas (x_deltas, y_deltas, deltas, 3);
+    assert (iup_delta_optimize (points, x_deltas, y_deltas, opt_indices, 0.5));
+    check (opt_indices, expected, 7);
+  }
+
+  /* Middle delta off by one: needed at 0.5 tolerance, not at 1.5. */
+  {
+    static const int deltas[3][2] = {{0, 0}, {6, 0}, {10, 0}};
+    static const bool expected_strict[7] = {true, true, true, false, false, false, false};
+    static const bool expected_loose[7] = {true, false, true, false, false, false, false};
+    hb_vector_t<bool> strict_indices, loose_indices;
+    make_deltas (x_deltas, y_deltas, deltas, 3);
+    assert (iup_delta_optimize (points, x_deltas, y_deltas, strict_indices, 0.5));
+    check (strict_indices, expected_strict, 7);
+    assert (iup_delta_optimize (points, x_deltas, y_deltas, loose_indices, 1.5));
+    check (loose_indices, expected_loose, 7);
+  }
+}
+
+/* No point is forced; this takes the repeated-contour path. */
+static void
+test_iup_unforced ()
+{
+  static const unsigned ends[] = {3};
+  static const int deltas[4][2] = {{0, 0}, {10, 0}, {10, 0}, {0, 0}};
+  static const bool expected[8] = {true, false, true, false, false, false, false, false};
+
+  contour_point_vector_t points;
+  hb_vector_t<int> x_deltas, y_deltas;
+  hb_vector_t<bool> opt_indices;
+  make_glyph (points, square, 4, ends, 1);
+  make_deltas (x_deltas, y_deltas, deltas, 4);
+  assert (iup_delta_optimize (points, x_deltas, y_deltas, opt_indices, 0.5));
+  check (opt_indices, expected, 8);
+}
+
+/* Contours are optimized independently, reusing the same scratch buffers. */
+static void
+test_iup_contours ()
+{
+  static const int coords[7][2] = {{0, 0}, {100, 0}, {100, 100}, {0, 100},
+				   {0, 0}, {50, 0}, {100, 0}};
+  static const unsigned ends[] = {3, 6};
+  static const int deltas[7][2] = {{10, 10}, {10, 10}, {10, 10}, {10, 10},
+				   {0, 0}, {5, 0}, {10, 0}};
+  static const bool expected[11] = {true, false, false, false,
+				    true, false, true,
+				    false, false, false, false};
+
+  contour_point_vector_t points;
+  hb_vector_t<int> x_deltas, y_deltas;
+  hb_vector_t<bool> opt_indices;
+  make_glyph (points, coords, 7, ends, 2);
+  make_deltas (x_deltas, y_deltas, deltas, 7);
+  assert (iup_delta_optimize (points, x_deltas, y_deltas, opt_indices, 0.5));
+  check (opt_indices, expected, 11);
+}
+
+int
+main (int argc, char **argv)
+{
+  test_iup_within_tolerance ();
+  test_iup_all_equal ();
+  test_iup_forced ();
+  test_iup_unforced ();
+  test_iup_contours ();
+}
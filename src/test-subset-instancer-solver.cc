@@ -428,4 +428,30 @@ main (int argc, char **argv)
     assert (out[0].first == 1.0);
     assert (approx (out[0].second, Triple (0.5, 0.625, 0.75)));
   }
+
+  /* Memoized solver */
+  {
+    rebase_tent_cache_t cache;
+    Triple tent (0.0, 1.0, 1.0);
+    Triple axis_range (-1.0, -0.5, 1.0);
+    TripleDistances axis_distances{2.0, 1.0};
+    rebase_tent_result_t expected = rebase_tent (tent, axis_range, axis_distances);
+    for (unsigned i = 0; i < 3; i++)
+    {
+      rebase_tent_result_t out = cache.rebase_tent (tent, axis_range, axis_distances);
+      assert (out.length == expected.length);
+      for (unsigned j = 0; j < out.length; j++)
+      {
+        assert (out[j].first == expected[j].first);
+        assert (out[j].second == expected[j].second);
+      }
+    }
+    assert (cache.misses == 1);
+    assert (cache.hits == 2);
+
+    /* Different axis distances are a different key. */
+    cache.rebase_tent (tent, axis_range, default_axis_distances);
+    assert (cache.misses == 2);
+    assert (cache.hits == 2);
+  }
 }
@@ -243,6 +243,42 @@ test_draw_varc_conditional (void)
 
   font_destroy (font);
 }
+
+static void
+test_draw_varc_repeated (void)
+{
+  face_t *face = test_open_font_file ("fonts/varc-6868.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  draw_data_t draw_data0 = {0};
+  draw_data_t draw_data1, draw_data2;
+  unsigned gid = 0;
+
+  font_get_nominal_glyph (font, 0x6868u, &gid);
+
+  /* The second draw comes out of the component cache. */
+  draw_data1 = draw_data0;
+  font_draw_glyph (font, gid, funcs, &draw_data1);
+  draw_data2 = draw_data0;
+  font_draw_glyph (font, gid, funcs, &draw_data2);
+  g_assert_cmpuint (draw_data1.move_to_count, ==, 11);
+  g_assert_cmpmem (&draw_data1, sizeof (draw_data1), &draw_data2, sizeof (draw_data2));
+
+  variation_t var;
+  var.tag = HB_TAG ('w','g','h','t');
+  var.value = 800;
+  font_set_variations (font, &var, 1);
+
+  draw_data1 = draw_data0;
+  font_draw_glyph (font, gid, funcs, &draw_data1);
+  draw_data2 = draw_data0;
+  font_draw_glyph (font, gid, funcs, &draw_data2);
+  g_assert_cmpuint (draw_data1.move_to_count, ==, 11);
+  g_assert_cmpmem (&draw_data1, sizeof (draw_data1), &draw_data2, sizeof (draw_data2));
+
+  font_destroy (font);
+}
 #endif
 
 int
@@ -262,6 +298,7 @@ main (int argc, char **argv)
   test_add (test_draw_varc_simple_hangul);
   test_add (test_draw_varc_simple_hanzi);
   test_add (test_draw_varc_conditional);
+  test_add (test_draw_varc_repeated);
 #endif
   unsigned result = test_run ();
 
@@ -246,6 +246,369 @@ test_draw_glyf (void)
   font_destroy (font);
 }
 
+static void
+test_draw_glyphs (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  codepoint_t glyphs[] = {3, 4, 3};
+  unsigned verb_offsets[4];
+  unsigned coord_offsets[4];
+  unsigned verb_count = 0;
+  unsigned coord_count = 0;
+
+  /* Size query. */
+  g_assert_false (font_draw_glyphs (font, 3, glyphs,
+				    &verb_count, NULL,
+				    &coord_count, NULL,
+				    verb_offsets, coord_offsets));
+  g_assert_cmpuint (verb_count, >, 0);
+  g_assert_cmpuint (coord_count, >, 0);
+  g_assert_cmpuint (verb_offsets[0], ==, 0);
+  g_assert_cmpuint (verb_offsets[3], ==, verb_count);
+  g_assert_cmpuint (coord_offsets[3], ==, coord_count);
+
+  uint8_t *verbs = (uint8_t *) g_malloc (verb_count);
+  float *coords = (float *) g_malloc (coord_count * sizeof (float));
+  g_assert_true (font_draw_glyphs (font, 3, glyphs,
+				   &verb_count, verbs,
+				   &coord_count, coords,
+				   verb_offsets, coord_offsets));
+
+  /* Matches font_draw_glyph(): "M275,442Q232,442 198,420..." */
+  g_assert_cmpuint (verbs[0], ==, HB_DRAW_VERB_MOVE_TO);
+  g_assert_cmpfloat_with_epsilon (coords[0], 275.f, .5f);
+  g_assert_cmpfloat_with_epsilon (coords[1], 442.f, .5f);
+  g_assert_cmpuint (verbs[1], ==, HB_DRAW_VERB_QUADRATIC_TO);
+  g_assert_cmpfloat_with_epsilon (coords[2], 232.f, .5f);
+  g_assert_cmpfloat_with_epsilon (coords[5], 420.f, .5f);
+  g_assert_cmpuint (verbs[verb_offsets[1] - 1], ==, HB_DRAW_VERB_CLOSE_PATH);
+
+  /* Same glyph drawn twice produces the same path. */
+  unsigned len = verb_offsets[1] - verb_offsets[0];
+  g_assert_cmpuint (verb_offsets[3] - verb_offsets[2], ==, len);
+  g_assert_cmpmem (verbs + verb_offsets[2], len, verbs, len);
+  len = coord_offsets[1] - coord_offsets[0];
+  g_assert_cmpuint (coord_offsets[3] - coord_offsets[2], ==, len);
+  g_assert_cmpmem (coords + coord_offsets[2], len * sizeof (float),
+		   coords, len * sizeof (float));
+
+  /* Too small a buffer fails but still reports the full size. */
+  unsigned small_verb_count = 4;
+  unsigned small_coord_count = coord_count;
+  g_assert_false (font_draw_glyphs (font, 3, glyphs,
+				    &small_verb_count, verbs,
+				    &small_coord_count, coords,
+				    NULL, NULL));
+  g_assert_cmpuint (small_verb_count, ==, verb_count);
+  g_assert_cmpuint (verbs[0], ==, HB_DRAW_VERB_MOVE_TO);
+
+  g_free (verbs);
+  g_free (coords);
+  font_destroy (font);
+}
+
+static void
+draw_glyphs_check_same (font_t *font, font_t *other,
+			unsigned count, const codepoint_t *glyphs)
+{
+  unsigned verb_count = 0, coord_count = 0;
+  unsigned other_verb_count = 0, other_coord_count = 0;
+
+  font_draw_glyphs (font, count, glyphs, &verb_count, NULL, &coord_count, NULL, NULL, NULL);
+  font_draw_glyphs (other, count, glyphs, &other_verb_count, NULL, &other_coord_count, NULL, NULL, NULL);
+  g_assert_cmpuint (verb_count, >, 0);
+  g_assert_cmpuint (verb_count, ==, other_verb_count);
+  g_assert_cmpuint (coord_count, ==, other_coord_count);
+
+  uint8_t *verbs = (uint8_t *) g_malloc (verb_count);
+  uint8_t *other_verbs = (uint8_t *) g_malloc (verb_count);
+  float *coords = (float *) g_malloc (coord_count * sizeof (float));
+  float *other_coords = (float *) g_malloc (coord_count * sizeof (float));
+  g_assert_true (font_draw_glyphs (font, count, glyphs,
+				   &verb_count, verbs, &coord_count, coords,
+				   NULL, NULL));
+  g_assert_true (font_draw_glyphs (other, count, glyphs,
+				   &other_verb_count, other_verbs, &other_coord_count, other_coords,
+				   NULL, NULL));
+
+  g_assert_cmpmem (verbs, verb_count, other_verbs, verb_count);
+  for (unsigned i = 0; i < coord_count; i++)
+    g_assert_cmpfloat_with_epsilon (coords[i], other_coords[i], .01f);
+
+  g_free (verbs);
+  g_free (other_verbs);
+  g_free (coords);
+  g_free (other_coords);
+}
+
+/* OT fonts decode glyf/CFF/CFF2 outlines straight into the output arrays;
+ * a sub-font goes through the draw callbacks.  Both must agree. */
+static void
+test_draw_glyphs_direct (void)
+{
+  const char *paths[] = {
+    "fonts/OpenSans-Regular.ttf",
+    "fonts/SourceSansPro-Regular.otf",
+    "fonts/AdobeVFPrototype.abc.otf",
+  };
+  codepoint_t glyphs[] = {1, 2, 3, 4, 5, 1};
+
+  for (unsigned i = 0; i < G_N_ELEMENTS (paths); i++)
+    for (unsigned slanted = 0; slanted < 2; slanted++)
+    {
+      face_t *face = test_open_font_file (paths[i]);
+      font_t *font = font_create (face);
+      face_destroy (face);
+      if (slanted)
+	font_set_synthetic_slant (font, 0.2f);
+      font_t *sub_font = font_create_sub_font (font);
+
+      draw_glyphs_check_same (font, sub_font, G_N_ELEMENTS (glyphs), glyphs);
+
+      font_destroy (sub_font);
+      font_destroy (font);
+    }
+}
+
+static void
+test_draw_glyph_sdf (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  /* 50 pixels per em: the glyph spans about 25 pixels. */
+  font_set_scale (font, 50, 50);
+
+  uint8_t bitmap[40 * 48];
+  unsigned inside = 0, outside = 0;
+
+  g_assert_true (font_get_glyph_sdf (font, 3, -8.f, 33.f, 4.f,
+				     40, 40, 48, bitmap));
+  for (unsigned r = 0; r < 40; r++)
+    for (unsigned c = 0; c < 40; c++)
+    {
+      uint8_t v = bitmap[r * 48 + c];
+      if (v > 128) inside++;
+      else outside++;
+    }
+  g_assert_cmpuint (bitmap[0], ==, 0);
+  g_assert_cmpuint (bitmap[39 * 48 + 39], ==, 0);
+  g_assert_cmpuint (inside, >, 0);
+  g_assert_cmpuint (outside, >, inside);
+
+  /* No outline: everything is outside. */
+  g_assert_false (font_get_glyph_sdf (font, 1000, 0.f, 0.f, 4.f,
+				      40, 40, 48, bitmap));
+  for (unsigned r = 0; r < 40; r++)
+    for (unsigned c = 0; c < 40; c++)
+      g_assert_cmpuint (bitmap[r * 48 + c], ==, 0);
+
+  font_destroy (font);
+}
+
+static void
+test_draw_glyphs_sdf (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  font_set_scale (font, 50, 50);
+
+  /* Cells of one atlas, rendered on several threads, match rendering each
+   * glyph on its own. */
+  codepoint_t glyphs[8];
+  float x_origins[8], y_origins[8];
+  uint8_t atlas[8 * 40 * 40];
+  uint8_t *bitmaps[8];
+  for (unsigned i = 0; i < 8; i++)
+  {
+    glyphs[i] = 1 + i % 4;
+    x_origins[i] = -8.f + i;
+    y_origins[i] = 33.f;
+    bitmaps[i] = atlas + i * 40 * 40;
+  }
+  font_get_glyphs_sdf (font, 8, glyphs, x_origins, y_origins, 4.f,
+		       40, 40, 40, bitmaps, 4);
+
+  for (unsigned i = 0; i < 8; i++)
+  {
+    uint8_t bitmap[40 * 40];
+    font_get_glyph_sdf (font, glyphs[i], x_origins[i], y_origins[i], 4.f,
+			40, 40, 40, bitmap);
+    g_assert_cmpmem (bitmaps[i], 40 * 40, bitmap, 40 * 40);
+  }
+
+  font_destroy (font);
+}
+
+static void
+test_draw_glyph_a8 (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  font_set_scale (font, 50, 50);
+
+  uint8_t a8[40 * 48];
+  uint8_t sdf[40 * 48];
+  unsigned full = 0, partial = 0;
+
+  g_assert_true (font_get_glyph_a8 (font, 3, -8.f, 33.f,
+				    40, 40, 48, a8));
+  g_assert_true (font_get_glyph_sdf (font, 3, -8.f, 33.f, 4.f,
+				     40, 40, 48, sdf));
+  g_assert_cmpuint (a8[0], ==, 0);
+  g_assert_cmpuint (a8[39 * 48 + 39], ==, 0);
+
+  /* Fully covered pixels are inside the distance field, and empty ones
+   * outside. */
+  for (unsigned r = 0; r < 40; r++)
+    for (unsigned c = 0; c < 40; c++)
+    {
+      uint8_t v = a8[r * 48 + c];
+      if (v == 255)
+      {
+	full++;
+	g_assert_cmpuint (sdf[r * 48 + c], >=, 128);
+      }
+      else if (v == 0)
+	g_assert_cmpuint (sdf[r * 48 + c], <=, 128);
+      else
+	partial++;
+    }
+  g_assert_cmpuint (full, >, 0);
+  g_assert_cmpuint (partial, >, 0);
+
+  g_assert_false (font_get_glyph_a8 (font, 1000, 0.f, 0.f,
+				     40, 40, 48, a8));
+  for (unsigned r = 0; r < 40; r++)
+    for (unsigned c = 0; c < 40; c++)
+      g_assert_cmpuint (a8[r * 48 + c], ==, 0);
+
+  font_destroy (font);
+}
+
+static void
+test_draw_glyph_a8_clipped (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  font_set_scale (font, 50, 50);
+
+  /* A bitmap 10 pixels into the glyph and narrower than it, so the outline
+   * runs off both the left and right edges, shows the same pixels as the
+   * full rendering. */
+  uint8_t full[40 * 40];
+  uint8_t clipped[40 * 15];
+  g_assert_true (font_get_glyph_a8 (font, 3, -8.f, 33.f,
+				    40, 40, 40, full));
+  g_assert_true (font_get_glyph_a8 (font, 3, 2.f, 33.f,
+				    15, 40, 15, clipped));
+
+  unsigned covered = 0;
+  for (unsigned r = 0; r < 40; r++)
+    for (unsigned c = 0; c < 15; c++)
+    {
+      int v = clipped[r * 15 + c];
+      int expected = full[r * 40 + c + 10];
+      g_assert_cmpint (abs (v - expected), <=, 1);
+      covered += v != 0;
+    }
+  g_assert_cmpuint (covered, >, 0);
+
+  font_destroy (font);
+}
+
+static void
+test_draw_glyph_sdf_too_large (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  font_set_scale (font, 50, 50);
+
+  /* Dimensions whose working buffers would not fit in memory fail and
+   * clear the bitmap, rather than rendering out of bounds.  A zero stride
+   * makes every row share the one buffer. */
+  const unsigned width = 0x10000, height = 0x8001;
+  uint8_t *bitmap = g_malloc (width);
+
+  memset (bitmap, 0xAA, width);
+  g_assert_false (font_get_glyph_sdf (font, 3, -8.f, 33.f, 4.f,
+				      width, height, 0, bitmap));
+  for (unsigned c = 0; c < width; c++)
+    g_assert_cmpuint (bitmap[c], ==, 0);
+
+  memset (bitmap, 0xAA, width);
+  g_assert_false (font_get_glyph_a8 (font, 3, -8.f, 33.f,
+				     width, height, 0, bitmap));
+  for (unsigned c = 0; c < width; c++)
+    g_assert_cmpuint (bitmap[c], ==, 0);
+
+  g_free (bitmap);
+  font_destroy (font);
+}
+
+static void
+test_draw_glyf_repeated (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSerifVariable-Roman-VVAR.abc.ttf");
+  font_t *font = font_create (face);
+  face_destroy (face);
+
+  char str[1024], str2[1024];
+  draw_data_t draw_data = {
+    .str = str,
+    .size = sizeof (str),
+    .consumed = 0
+  };
+  draw_data_t draw_data2 = {
+    .str = str2,
+    .size = sizeof (str2),
+    .consumed = 0
+  };
+
+  variation_t var;
+  var.tag = HB_TAG ('w','g','h','t');
+  var.value = 800;
+  font_set_variations (font, &var, 1);
+
+  /* Drawing the same glyph again, which may be served from the font's
+   * outline cache, must give the same result; so must extents. */
+  glyph_extents_t extents, extents2;
+  g_assert_true (font_get_glyph_extents (font, 3, &extents));
+  font_draw_glyph (font, 3, funcs, &draw_data);
+  font_draw_glyph (font, 3, funcs, &draw_data2);
+  g_assert_cmpmem (str, draw_data.consumed, str2, draw_data2.consumed);
+  g_assert_true (font_get_glyph_extents (font, 3, &extents2));
+  g_assert_cmpmem (&extents, sizeof (extents), &extents2, sizeof (extents2));
+
+  /* Changing variations must not return stale outlines. */
+  var.value = 400;
+  font_set_variations (font, &var, 1);
+  draw_data2.consumed = 0;
+  font_draw_glyph (font, 3, funcs, &draw_data2);
+  g_assert_false (draw_data.consumed == draw_data2.consumed &&
+		  !memcmp (str, str2, draw_data.consumed));
+
+  var.value = 800;
+  font_set_variations (font, &var, 1);
+  draw_data2.consumed = 0;
+  font_draw_glyph (font, 3, funcs, &draw_data2);
+  g_assert_cmpmem (str, draw_data.consumed, str2, draw_data2.consumed);
+
+  font_destroy (font);
+}
+
 static void
 test_draw_cff1 (void)
 {
@@ -268,6 +631,40 @@ test_draw_cff1 (void)
   font_destroy (font);
 }
 
+static void
+test_draw_cff1_repeated (void)
+{
+  face_t *face = test_open_font_file ("fonts/cff1_seac.otf");
+  font_t *font = font_create (face);
+  font_t *font2 = font_create (face);
+  face_destroy (face);
+
+  char str[1024];
+  draw_data_t draw_data = {
+    .str = str,
+    .size = sizeof (str)
+  };
+  char expected[] = "M203,367C227,440 248,512 268,588L272,588C293,512 314,440 338,367L369,267L172,267L203,367Z"
+		    "M3,0L88,0L151,200L390,200L452,0L541,0L319,656L225,656L3,0Z"
+		    "M300,653L342,694L201,861L143,806L300,653Z";
+
+  /* Later draws, from this or another font on the same face, may replay
+   * the face's decoded charstring; they must draw the same. */
+  for (unsigned i = 0; i < 2; i++)
+  {
+    draw_data.consumed = 0;
+    font_draw_glyph (font, 3, funcs, &draw_data);
+    g_assert_cmpmem (str, draw_data.consumed, expected, sizeof (expected) - 1);
+  }
+
+  draw_data.consumed = 0;
+  font_draw_glyph (font2, 3, funcs, &draw_data);
+  g_assert_cmpmem (str, draw_data.consumed, expected, sizeof (expected) - 1);
+
+  font_destroy (font2);
+  font_destroy (font);
+}
+
 static void
 test_draw_cff1_rline (void)
 {
@@ -1179,7 +1576,16 @@ main (int argc, char **argv)
   test_add (test_itoa);
   test_add (test_draw_empty);
   test_add (test_draw_glyf);
+  test_add (test_draw_glyphs);
+  test_add (test_draw_glyphs_direct);
+  test_add (test_draw_glyph_sdf);
+  test_add (test_draw_glyphs_sdf);
+  test_add (test_draw_glyph_a8);
+  test_add (test_draw_glyph_a8_clipped);
+  test_add (test_draw_glyph_sdf_too_large);
+  test_add (test_draw_glyf_repeated);
   test_add (test_draw_cff1);
+  test_add (test_draw_cff1_repeated);
   test_add (test_draw_cff1_rline);
   test_add (test_draw_cff2);
   test_add (test_draw_ttf_parser_tests);
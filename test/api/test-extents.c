@@ -93,12 +93,51 @@ test_glyph_extents (void)
   hb_face_destroy (face);
 }
 
+static void
+test_glyph_extents_repeated (void)
+{
+  hb_face_t *face;
+  hb_font_t *font;
+  hb_paint_funcs_t *funcs;
+  hb_glyph_extents_t extents, extents2;
+
+  /* Extents of COLRv1 glyphs without a ClipBox may be computed from the
+   * font's recorded paint programs, or served from its extents cache;
+   * neither may change the result, whichever is populated first. */
+
+  face = hb_test_open_font_file ("fonts/adwaita.ttf");
+  font = hb_font_create (face);
+  funcs = hb_paint_funcs_create ();
+
+  for (hb_codepoint_t gid = 0; gid < 6; gid++)
+  {
+    hb_font_t *fresh = hb_font_create (face);
+
+    if (gid % 2)
+      hb_font_paint_glyph (font, gid, funcs, NULL, 0, HB_COLOR (0, 0, 0, 255));
+
+    g_assert_true (hb_font_get_glyph_extents (font, gid, &extents));
+    g_assert_true (hb_font_get_glyph_extents (font, gid, &extents2));
+    g_assert_cmpmem (&extents, sizeof (extents), &extents2, sizeof (extents2));
+
+    g_assert_true (hb_font_get_glyph_extents (fresh, gid, &extents2));
+    g_assert_cmpmem (&extents, sizeof (extents), &extents2, sizeof (extents2));
+
+    hb_font_destroy (fresh);
+  }
+
+  hb_paint_funcs_destroy (funcs);
+  hb_font_destroy (font);
+  hb_face_destroy (face);
+}
+
 int
 main (int argc, char **argv)
 {
   hb_test_init (&argc, &argv);
 
   hb_test_add (test_glyph_extents);
+  hb_test_add (test_glyph_extents_repeated);
 
   return hb_test_run();
 }
@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2026  HarfBuzz contributors
+ *
+ *  This is part of HarfBuzz, a text shaping library.
+ *
+ * Permission is hereby granted, without written agreement and without
+ * license or royalty fees, to use, copy, modify, and distribute this
+ * software and its documentation for any purpose, provided that the
+ * above copyright notice and the following two paragraphs appear in
+ * all copies of this software.
+ *
+ * IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES
+ * ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION, EVEN
+ * IF THE COPYRIGHT HOLDER HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ *
+ * THE COPYRIGHT HOLDER SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING,
+ * BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE.  THE SOFTWARE PROVIDED HEREUNDER IS
+ * ON AN "AS IS" BASIS, AND THE COPYRIGHT HOLDER HAS NO OBLIGATION TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ */
+
+#include "hb-test.h"
+
+#include <hb-ot.h>
+
+/* Unit tests for face_create_from_woff() */
+
+static face_t *
+open_woff_file (const char *font_path)
+{
+#if GLIB_CHECK_VERSION(2,37,2)
+  char *path = g_test_build_filename (G_TEST_DIST, font_path, NULL);
+#else
+  char *path = g_strdup (font_path);
+#endif
+
+  blob_t *blob = blob_create_from_file_or_fail (path);
+  if (!blob)
+    g_error ("Font %s not found.", path);
+
+  face_t *face = face_create_from_woff (blob, 0);
+  blob_destroy (blob);
+
+  g_free (path);
+
+  return face;
+}
+
+/* Tables that survive the round trip through WOFF and WOFF2 byte for byte.
+ * head gets its checksum adjusted, and WOFF2 rebuilds glyf and loca. */
+static const tag_t same_tables[] = {
+  HB_TAG ('O','S','/','2'),
+  HB_TAG ('c','m','a','p'),
+  HB_TAG ('c','v','t',' '),
+  HB_TAG ('f','p','g','m'),
+  HB_TAG ('h','h','e','a'),
+  HB_TAG ('h','m','t','x'),
+  HB_TAG ('m','a','x','p'),
+  HB_TAG ('n','a','m','e'),
+  HB_TAG ('p','o','s','t'),
+  HB_TAG ('p','r','e','p'),
+};
+
+static void
+compare_faces (face_t *expected, face_t *actual)
+{
+  g_assert_true (actual != face_get_empty ());
+  g_assert_cmpuint (face_get_glyph_count (actual), ==, face_get_glyph_count (expected));
+  g_assert_cmpuint (face_get_upem (actual), ==, face_get_upem (expected));
+
+  for (unsigned i = 0; i < G_N_ELEMENTS (same_tables); i++)
+  {
+    blob_t *expected_blob = face_reference_table (expected, same_tables[i]);
+    blob_t *actual_blob = face_reference_table (actual, same_tables[i]);
+    test_assert_blobs_equal (expected_blob, actual_blob);
+    blob_destroy (expected_blob);
+    blob_destroy (actual_blob);
+  }
+
+  font_t *expected_font = font_create (expected);
+  font_t *actual_font = font_create (actual);
+
+  codepoint_t cps[] = {'a', 'b', 'c'};
+  for (unsigned i = 0; i < G_N_ELEMENTS (cps); i++)
+  {
+    codepoint_t expected_gid = 0, actual_gid = 0;
+    g_assert_true (font_get_nominal_glyph (expected_font, cps[i], &expected_gid));
+    g_assert_true (font_get_nominal_glyph (actual_font, cps[i], &actual_gid));
+    g_assert_cmpuint (actual_gid, ==, expected_gid);
+  }
+
+  for (unsigned gid = 0; gid < face_get_glyph_count (expected); gid++)
+  {
+    g_assert_cmpint (font_get_glyph_h_advance (actual_font, gid), ==,
+		     font_get_glyph_h_advance (expected_font, gid));
+
+    glyph_extents_t expected_extents = {0}, actual_extents = {0};
+    g_assert_cmpint (font_get_glyph_extents (expected_font, gid, &expected_extents), ==,
+		     font_get_glyph_extents (actual_font, gid, &actual_extents));
+    g_assert_cmpint (actual_extents.x_bearing, ==, expected_extents.x_bearing);
+    g_assert_cmpint (actual_extents.y_bearing, ==, expected_extents.y_bearing);
+    g_assert_cmpint (actual_extents.width, ==, expected_extents.width);
+    g_assert_cmpint (actual_extents.height, ==, expected_extents.height);
+  }
+
+  font_destroy (expected_font);
+  font_destroy (actual_font);
+}
+
+#ifdef HAVE_ZLIB
+static void
+test_face_woff (void)
+{
+  face_t *expected = test_open_font_file ("fonts/Roboto-Regular.abc.ttf");
+  face_t *actual = open_woff_file ("fonts/Roboto-Regular.abc.woff");
+  compare_faces (expected, actual);
+  face_destroy (expected);
+  face_destroy (actual);
+}
+#endif
+
+#ifdef HAVE_BROTLI
+static void
+test_face_woff2 (void)
+{
+  face_t *expected = test_open_font_file ("fonts/Roboto-Regular.abc.ttf");
+  face_t *actual = open_woff_file ("fonts/Roboto-Regular.abc.woff2");
+  compare_faces (expected, actual);
+  face_destroy (expected);
+  face_destroy (actual);
+}
+#endif
+
+static void
+test_face_woff_invalid (void)
+{
+  /* Plain sfnt data is not WOFF. */
+  face_t *face = open_woff_file ("fonts/Roboto-Regular.abc.ttf");
+  g_assert_true (face == face_get_empty ());
+
+  blob_t *blob = blob_create ("wOF2garbage", 11, HB_MEMORY_MODE_READONLY, NULL, NULL);
+  face = face_create_from_woff (blob, 0);
+  g_assert_true (face == face_get_empty ());
+  blob_destroy (blob);
+
+  face = face_create_from_woff (blob_get_empty (), 0);
+  g_assert_true (face == face_get_empty ());
+}
+
+int
+main (int argc, char **argv)
+{
+  test_init (&argc, &argv);
+
+#ifdef HAVE_ZLIB
+  test_add (test_face_woff);
+#endif
+#ifdef HAVE_BROTLI
+  test_add (test_face_woff2);
+#endif
+  test_add (test_face_woff_invalid);
+
+  return test_run();
+}
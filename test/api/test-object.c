@@ -364,12 +364,49 @@ test_object (void)
 }
 
 
+/* Destroyed objects' memory may be reused for new ones; make sure none of
+ * the old state shows through. */
+static void
+test_object_reuse (void)
+{
+  hb_user_data_key_t key;
+  unsigned i;
+
+  for (i = 0; i < 4; i++)
+  {
+    hb_buffer_t *buffer = hb_buffer_create ();
+    g_assert (!hb_buffer_get_user_data (buffer, &key));
+    g_assert_cmpint (hb_buffer_get_length (buffer), ==, 0);
+    g_assert_cmpint (hb_buffer_get_direction (buffer), ==, HB_DIRECTION_INVALID);
+    hb_buffer_set_user_data (buffer, &key, &key, NULL, TRUE);
+    hb_buffer_add_utf8 (buffer, "abc", -1, 0, -1);
+    hb_buffer_set_direction (buffer, HB_DIRECTION_RTL);
+    hb_buffer_destroy (buffer);
+  }
+
+  for (i = 0; i < 4; i++)
+  {
+    hb_font_t *parent = (hb_font_t *) create_font ();
+    hb_font_t *font = hb_font_create_sub_font (parent);
+    int x_scale, y_scale;
+    hb_font_destroy (parent);
+    g_assert (!hb_font_get_user_data (font, &key));
+    hb_font_get_scale (font, &x_scale, &y_scale);
+    g_assert_cmpint (x_scale, ==, 1000);
+    hb_font_set_user_data (font, &key, &key, NULL, TRUE);
+    hb_font_set_scale (font, 10, 10);
+    hb_font_destroy (font);
+  }
+}
+
+
 int
 main (int argc, char **argv)
 {
   hb_test_init (&argc, &argv);
 
   hb_test_add (test_object);
+  hb_test_add (test_object_reuse);
 
   return hb_test_run ();
 }
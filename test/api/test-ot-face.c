@@ -214,6 +214,226 @@ test_ot_var_axis_on_zero_named_instance (void)
   face_destroy (face);
 }
 
+static void
+test_ot_face_sanitize_cache (void)
+{
+  face_t *face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  g_assert_true (face_set_sanitize_cache (face, NULL));
+  font_t *font = font_create (face);
+  long long result = test_font (font, 0x0628u);
+  font_destroy (font);
+
+  blob_t *cache = face_reference_sanitize_cache (face);
+  g_assert_cmpuint (blob_get_length (cache), >, 12);
+  face_destroy (face);
+
+  /* Same results with the verdicts trusted. */
+  face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  g_assert_true (face_set_sanitize_cache (face, cache));
+  font = font_create (face);
+  g_assert_cmpint (test_font (font, 0x0628u), ==, result);
+  font_destroy (font);
+
+  /* Nothing new recorded, nothing lost. */
+  blob_t *cache2 = face_reference_sanitize_cache (face);
+  g_assert_cmpuint (blob_get_length (cache2), ==, blob_get_length (cache));
+  blob_destroy (cache2);
+  face_destroy (face);
+
+  /* A table changed in any byte is not trusted.  A name record in the
+   * middle of the table pointing out of bounds gets the name table
+   * rejected by sanitizing, with or without the verdicts. */
+  face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  blob_t *file_blob = face_reference_blob (face);
+  blob_t *name_blob = face_reference_table (face, HB_TAG ('n','a','m','e'));
+  unsigned file_length;
+  const char *file_data = blob_get_data (file_blob, &file_length);
+  unsigned name_offset = blob_get_data (name_blob, NULL) - file_data;
+  g_assert_cmpuint (blob_get_length (name_blob), >, 6 + 12 * 6);
+  blob_destroy (name_blob);
+  face_destroy (face);
+
+  char *bad_data = (char *) g_malloc (file_length);
+  memcpy (bad_data, file_data, file_length);
+  blob_destroy (file_blob);
+  /* Offset of the sixth name record, 76 bytes into the table. */
+  bad_data[name_offset + 6 + 12 * 5 + 10] = (char) 0xFF;
+  bad_data[name_offset + 6 + 12 * 5 + 11] = (char) 0xFF;
+  blob_t *bad_blob = blob_create (bad_data, file_length, HB_MEMORY_MODE_READONLY, bad_data, g_free);
+
+  unsigned num_entries;
+  face = face_create (bad_blob, 0);
+  ot_name_list_names (face, &num_entries);
+  g_assert_cmpuint (num_entries, ==, 0);
+  face_destroy (face);
+
+  face = face_create (bad_blob, 0);
+  g_assert_true (face_set_sanitize_cache (face, cache));
+  ot_name_list_names (face, &num_entries);
+  g_assert_cmpuint (num_entries, ==, 0);
+  face_destroy (face);
+  blob_destroy (bad_blob);
+
+  /* Garbage is rejected. */
+  face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  blob_t *garbage = blob_create ("not a cache", 11, HB_MEMORY_MODE_READONLY, NULL, NULL);
+  g_assert_false (face_set_sanitize_cache (face, garbage));
+  blob_destroy (garbage);
+  face_destroy (face);
+
+  blob_destroy (cache);
+}
+
+static void
+test_ot_face_warm_up (void)
+{
+  face_t *face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  font_t *font = font_create (face);
+  long long result = test_font (font, 0x0628u);
+  font_destroy (font);
+  face_destroy (face);
+
+  unsigned threads[] = {0, 1, 4};
+  for (unsigned i = 0; i < G_N_ELEMENTS (threads); i++)
+  {
+    face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+    face_warm_up (face, HB_FACE_WARM_UP_FLAG_ALL, threads[i]);
+    font = font_create (face);
+    g_assert_cmpint (test_font (font, 0x0628u), ==, result);
+    font_destroy (font);
+    face_destroy (face);
+  }
+
+  face_warm_up (face_get_empty (), HB_FACE_WARM_UP_FLAG_ALL, 4);
+}
+
+/* What a face reports for an accelerator it shares with its siblings:
+ * a pointer to it and a flag. */
+#define SHARED_ENTRY_SIZE (2 * sizeof (void *))
+
+static unsigned
+face_memory_usage (face_t *face, tag_t tag)
+{
+  memory_usage_t entries[64];
+  unsigned count = G_N_ELEMENTS (entries);
+  unsigned total = face_get_memory_usage (face, 0, &count, entries);
+  g_assert_cmpuint (count, ==, total);
+
+  unsigned size = 0;
+  for (unsigned i = 0; i < count; i++)
+    if (tag == HB_TAG_NONE || entries[i].tag == tag)
+      size += entries[i].size;
+  return size;
+}
+
+static unsigned
+font_memory_usage (font_t *font)
+{
+  memory_usage_t entries[64];
+  unsigned count = G_N_ELEMENTS (entries);
+  font_get_memory_usage (font, 0, &count, entries);
+
+  unsigned size = 0;
+  for (unsigned i = 0; i < count; i++)
+    size += entries[i].size;
+  return size;
+}
+
+static void
+shape_text (font_t *font, const char *text)
+{
+  buffer_t *buffer = buffer_create ();
+  buffer_add_utf8 (buffer, text, -1, 0, -1);
+  buffer_guess_segment_properties (buffer);
+  shape (font, buffer, NULL, 0);
+  buffer_destroy (buffer);
+}
+
+static void
+test_ot_face_sibling (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceHanSans-Regular.41,3041,4C2E.otc");
+  font_t *font = font_create (face);
+  long long result = test_font (font, 0x3041u);
+  font_destroy (font);
+
+  face_t *sibling = face_create_sibling (face, 1);
+  g_assert_cmpuint (face_get_index (sibling), ==, 1);
+  g_assert_cmpuint (face_get_glyph_count (sibling), ==, face_get_glyph_count (face));
+  font = font_create (sibling);
+  g_assert_cmpint (test_font (font, 0x3041u), ==, result);
+  shape_text (font, "\xe3\x81\x81");
+  font_destroy (font);
+
+  /* The sibling only holds a small record for the shared accelerators,
+   * while the face built its own before having a sibling. */
+  g_assert_cmpuint (face_memory_usage (sibling, HB_TAG ('C','F','F',' ')), >, 0);
+  g_assert_cmpuint (face_memory_usage (sibling, HB_TAG ('C','F','F',' ')), <=, SHARED_ENTRY_SIZE);
+  g_assert_cmpuint (face_memory_usage (sibling, HB_TAG ('G','S','U','B')), <=, SHARED_ENTRY_SIZE);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('C','F','F',' ')), >, SHARED_ENTRY_SIZE);
+
+  /* Shared data outlives the face it was loaded through. */
+  face_destroy (face);
+  face = face_create_sibling (sibling, 0);
+  face_destroy (sibling);
+  font = font_create (face);
+  g_assert_cmpint (test_font (font, 0x3041u), ==, result);
+  font_destroy (font);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('C','F','F',' ')), <=, SHARED_ENTRY_SIZE);
+  face_destroy (face);
+
+  face = face_create_sibling (face_get_empty (), 1);
+  g_assert_cmpuint (face_get_glyph_count (face), ==, 0);
+  face_destroy (face);
+}
+
+static void
+test_ot_face_memory_usage (void)
+{
+  face_t *face = test_open_font_file ("fonts/NotoNastaliqUrdu-Regular.ttf");
+  font_t *font = font_create (face);
+
+  unsigned before = face_memory_usage (face, HB_TAG_NONE);
+  g_assert_cmpuint (before, >, 0);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('G','S','U','B')), ==, 0);
+
+  long long result = test_font (font, 0x0628u);
+  shape_text (font, "\xd8\xa8\xd8\xb3\xd9\x85");
+  unsigned loaded = face_memory_usage (face, HB_TAG_NONE);
+  g_assert_cmpuint (loaded, >, before);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('c','m','a','p')), >, 0);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('G','S','U','B')), >, 0);
+  g_assert_cmpuint (font_memory_usage (font), >, 0);
+
+  /* Paging through the entries. */
+  unsigned count = 1;
+  memory_usage_t entry;
+  unsigned total = face_get_memory_usage (face, 0, NULL, NULL);
+  g_assert_cmpuint (total, >, 1);
+  face_get_memory_usage (face, total - 1, &count, &entry);
+  g_assert_cmpuint (count, ==, 1);
+  count = 1;
+  face_get_memory_usage (face, total, &count, &entry);
+  g_assert_cmpuint (count, ==, 0);
+
+  /* Released memory is rebuilt on use, with the same results. */
+  font_release_memory (font);
+  face_release_memory (face);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG_NONE), <, loaded);
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('G','S','U','B')), ==, 0);
+  g_assert_cmpint (test_font (font, 0x0628u), ==, result);
+  shape_text (font, "\xd8\xa8\xd8\xb3\xd9\x85");
+  g_assert_cmpuint (face_memory_usage (face, HB_TAG ('G','S','U','B')), >, 0);
+
+  font_destroy (font);
+  face_destroy (face);
+
+  g_assert_cmpuint (face_get_memory_usage (face_get_empty (), 0, NULL, NULL), ==, 0);
+  g_assert_cmpuint (font_get_memory_usage (font_get_empty (), 0, NULL, NULL), ==, 0);
+  face_release_memory (face_get_empty ());
+  font_release_memory (font_get_empty ());
+}
+
 int
 main (int argc, char **argv)
 {
@@ -221,6 +441,10 @@ main (int argc, char **argv)
 
   test_add (test_ot_face_empty);
   test_add (test_ot_var_axis_on_zero_named_instance);
+  test_add (test_ot_face_sanitize_cache);
+  test_add (test_ot_face_warm_up);
+  test_add (test_ot_face_sibling);
+  test_add (test_ot_face_memory_usage);
 
   return test_run();
 }
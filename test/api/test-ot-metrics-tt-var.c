@@ -61,6 +61,56 @@ test_extents_tt_var (void)
   font_destroy (font);
 }
 
+static void
+test_extents_tt_var_approximate (void)
+{
+  face_t *face = test_open_font_file ("fonts/SourceSansVariable-Roman-nohvar-41,C1.ttf");
+  g_assert (face);
+  font_t *font = font_create (face);
+  face_destroy (face);
+  g_assert (font);
+  ot_font_set_funcs (font);
+
+  float coords[1] = { 500.0f };
+  font_set_var_coords_design (font, coords, 1);
+
+  glyph_extents_t extents;
+  ot_font_set_approximate_extents (font, true);
+  bool_t result = font_get_glyph_extents (font, 2, &extents);
+  g_assert (result);
+
+  /* Must contain the exact extents, x_bearing=0 y_bearing=874 width=551 height=-874. */
+  g_assert_cmpint (extents.x_bearing, <=, 0);
+  g_assert_cmpint (extents.x_bearing + extents.width, >=, 551);
+  g_assert_cmpint (extents.y_bearing, >=, 874);
+  g_assert_cmpint (extents.y_bearing + extents.height, <=, 0);
+
+  /* Extents cached for one font state must not be served after the state
+   * changes: doubling the scale doubles the extents. */
+  glyph_extents_t extents2;
+  int x_scale, y_scale;
+  font_get_scale (font, &x_scale, &y_scale);
+  font_set_scale (font, x_scale * 2, y_scale * 2);
+  result = font_get_glyph_extents (font, 2, &extents2);
+  g_assert (result);
+  g_assert_cmpint (extents2.x_bearing, ==, extents.x_bearing * 2);
+  g_assert_cmpint (extents2.y_bearing, ==, extents.y_bearing * 2);
+  g_assert_cmpint (extents2.width, ==, extents.width * 2);
+  g_assert_cmpint (extents2.height, ==, extents.height * 2);
+  font_set_scale (font, x_scale, y_scale);
+
+  ot_font_set_approximate_extents (font, false);
+  result = font_get_glyph_extents (font, 2, &extents);
+  g_assert (result);
+
+  g_assert_cmpint (extents.x_bearing, ==, 0);
+  g_assert_cmpint (extents.y_bearing, ==, 874);
+  g_assert_cmpint (extents.width, ==, 551);
+  g_assert_cmpint (extents.height, ==, -874);
+
+  font_destroy (font);
+}
+
 static void
 test_advance_tt_var_nohvar (void)
 {
@@ -257,6 +307,7 @@ main (int argc, char **argv)
   test_init (&argc, &argv);
 
   test_add (test_extents_tt_var);
+  test_add (test_extents_tt_var_approximate);
   test_add (test_advance_tt_var_nohvar);
   test_add (test_advance_tt_var_hvarvvar);
   test_add (test_advance_tt_var_anchor);
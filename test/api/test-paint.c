@@ -556,6 +556,55 @@ test_compare_ot_ft_vf (gconstpointer d)
     g_test_skip ("FreeType COLRv1 support not present");
 }
 
+static char *
+paint_to_string (font_t *font, codepoint_t glyph)
+{
+  paint_data_t data;
+
+  data.string = g_string_new ("");
+  data.level = 0;
+
+  font_paint_glyph (font, glyph, get_test_paint_funcs (), &data, 0, HB_COLOR (0, 0, 0, 255));
+
+  g_assert_true (data.level == 0);
+
+  return g_string_free (data.string, FALSE);
+}
+
+static void
+test_paint_repeated (void)
+{
+  face_t *face = test_open_font_file (TEST_GLYPHS);
+  font_t *font = font_create (face);
+  codepoint_t glyphs[] = {6, 10, 92, 116, 175};
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (glyphs); i++)
+  {
+    /* Later paints may replay the font's recorded paint program. */
+    char *first = paint_to_string (font, glyphs[i]);
+    char *second = paint_to_string (font, glyphs[i]);
+    g_assert_cmpstr (first, ==, second);
+
+    /* Changing the font must not replay a stale program. */
+    font_set_synthetic_slant (font, 0.2f);
+    font_t *fresh = font_create (face);
+    font_set_synthetic_slant (fresh, 0.2f);
+    char *slanted = paint_to_string (font, glyphs[i]);
+    char *expected = paint_to_string (fresh, glyphs[i]);
+    g_assert_cmpstr (slanted, ==, expected);
+    font_destroy (fresh);
+    font_set_synthetic_slant (font, 0.f);
+
+    g_free (first);
+    g_free (second);
+    g_free (slanted);
+    g_free (expected);
+  }
+
+  font_destroy (font);
+  face_destroy (face);
+}
+
 static void
 scrutinize_linear_gradient (paint_funcs_t *funcs,
                             void *paint_data,
@@ -675,6 +724,7 @@ main (int argc, char **argv)
 
   test_add (test_color_stops_ot);
   test_add (test_color_stops_ft);
+  test_add (test_paint_repeated);
 
   status = test_run();
 
@@ -215,6 +215,67 @@ static void test_set_union (void)
   set_destroy (u);
 }
 
+static void test_set_page_directory (void)
+{
+  /* Enough pages within the first 64k values for a direct page index. */
+  set_t *s = set_create ();
+  for (unsigned i = 0; i < 16; i++)
+    set_add (s, i * 4000 + 7);
+  for (unsigned i = 0; i < 16; i++)
+  {
+    g_assert (set_has (s, i * 4000 + 7));
+    g_assert (!set_has (s, i * 4000 + 8));
+  }
+  g_assert (!set_has (s, 70000));
+
+  /* A value past it, and then removing it again. */
+  set_add (s, 70000);
+  set_add (s, 1000);
+  g_assert (set_has (s, 70000));
+  g_assert (set_has (s, 1000));
+  g_assert (set_has (s, 8007));
+  set_del_range (s, 65536, 100000);
+  g_assert (!set_has (s, 70000));
+  g_assert (set_has (s, 1000));
+
+  /* Removing whole pages. */
+  set_del_range (s, 4000, 40000);
+  g_assert (!set_has (s, 8007));
+  g_assert (set_has (s, 7));
+  g_assert (set_has (s, 44007));
+  set_add (s, 20000);
+  g_assert (set_has (s, 20000));
+  g_assert_cmpint (set_get_population (s), ==, 9);
+
+  set_t *o = set_create ();
+  set_add (o, 7);
+  set_add (o, 20000);
+  set_add (o, 50000);
+  set_add (o, 60007);
+
+  set_t *i = set_copy (s);
+  set_intersect (i, o);
+  g_assert_cmpint (set_get_population (i), ==, 3);
+  g_assert (set_has (i, 20000));
+  g_assert (!set_has (i, 50000));
+
+  set_union (i, o);
+  g_assert (set_has (i, 50000));
+  set_subtract (i, s);
+  g_assert_cmpint (set_get_population (i), ==, 1);
+  g_assert (set_has (i, 50000));
+  g_assert (!set_has (i, 7));
+
+  set_clear (s);
+  g_assert (!set_has (s, 7));
+  set_add (s, 7);
+  g_assert (set_has (s, 7));
+
+  set_destroy (s);
+  set_destroy (o);
+  set_destroy (i);
+}
+
 static void
 test_set_subsets (void)
 {
@@ -1206,6 +1267,7 @@ main (int argc, char **argv)
   test_add (test_set_intersect_empty);
   test_add (test_set_intersect_page_reduction);
   test_add (test_set_union);
+  test_add (test_set_page_directory);
 
   test_add (test_set_inverted_basics);
   test_add (test_set_inverted_ranges);
@@ -181,6 +181,31 @@ test_subset_cff1_j_strip_hints (void)
   face_destroy (face_41_4c2e);
 }
 
+static void
+test_subset_cff1_j_strip_hints_threads (void)
+{
+  face_t *face_41_3041_4c2e = test_open_font_file ("fonts/SourceHanSans-Regular.41,3041,4C2E.otf");
+  face_t *face_41_4c2e = test_open_font_file ("fonts/SourceHanSans-Regular.41,4C2E.nohints.otf");
+
+  set_t *codepoints = set_create ();
+  face_t *face_41_3041_4c2e_subset;
+  subset_input_t *input;
+  set_add (codepoints, 0x41);
+  set_add (codepoints, 0x4C2E);
+  input = subset_test_create_input (codepoints);
+  subset_input_set_flags (input, HB_SUBSET_FLAGS_NO_HINTING);
+  subset_input_set_max_threads (input, 4);
+  g_assert_cmpuint (subset_input_get_max_threads (input), ==, 4);
+  face_41_3041_4c2e_subset = subset_test_create_subset (face_41_3041_4c2e, input);
+  set_destroy (codepoints);
+
+  subset_test_check (face_41_4c2e, face_41_3041_4c2e_subset, HB_TAG ('C','F','F',' '));
+
+  face_destroy (face_41_3041_4c2e_subset);
+  face_destroy (face_41_3041_4c2e);
+  face_destroy (face_41_4c2e);
+}
+
 static void
 test_subset_cff1_j_desubr (void)
 {
@@ -376,6 +401,7 @@ main (int argc, char **argv)
   test_add (test_subset_cff1_desubr_strip_hints);
   test_add (test_subset_cff1_j);
   test_add (test_subset_cff1_j_strip_hints);
+  test_add (test_subset_cff1_j_strip_hints_threads);
   test_add (test_subset_cff1_j_desubr);
   test_add (test_subset_cff1_j_desubr_strip_hints);
   test_add (test_subset_cff1_expert);
@@ -126,6 +126,24 @@ test_subset_set_flags (void)
   subset_input_destroy (input);
 }
 
+static void
+test_subset_set_repack_budget (void)
+{
+  subset_input_t *input = subset_input_create_or_fail ();
+  unsigned int max_rounds, max_time_ms;
+
+  subset_input_get_repack_budget (input, &max_rounds, &max_time_ms);
+  g_assert_cmpuint (max_rounds, ==, 32);
+  g_assert_cmpuint (max_time_ms, ==, 0);
+
+  subset_input_set_repack_budget (input, 4, 250);
+  subset_input_get_repack_budget (input, &max_rounds, &max_time_ms);
+  g_assert_cmpuint (max_rounds, ==, 4);
+  g_assert_cmpuint (max_time_ms, ==, 250);
+
+  subset_input_destroy (input);
+}
+
 
 static void
 test_subset_sets (void)
@@ -229,6 +247,64 @@ test_subset_create_for_tables_face (void)
   face_destroy (face_ac);
 }
 
+typedef struct
+{
+  char *data;
+  unsigned length;
+  unsigned allocated;
+} write_buffer_t;
+
+static bool_t
+_write_to_buffer (const char *data, unsigned int length, void *user_data)
+{
+  write_buffer_t *buf = (write_buffer_t *) user_data;
+  if (buf->length + length > buf->allocated)
+    return false;
+  memcpy (buf->data + buf->length, data, length);
+  buf->length += length;
+  return true;
+}
+
+static void
+test_subset_write (void)
+{
+  face_t *face_abc = test_open_font_file ("fonts/Roboto-Regular.abc.ttf");
+
+  set_t *codepoints = set_create();
+  set_add (codepoints, 97);
+  set_add (codepoints, 99);
+
+  subset_input_t* input = subset_test_create_input (codepoints);
+  set_destroy (codepoints);
+
+  face_t* subset = subset_or_fail (face_abc, input);
+  g_assert (subset);
+
+  blob_t *expected = face_reference_blob (subset);
+  unsigned length = face_builder_get_length (subset);
+  g_assert_cmpuint (length, ==, blob_get_length (expected));
+
+  write_buffer_t buf = {(char *) malloc (length), 0, length};
+  g_assert (face_builder_write (subset, _write_to_buffer, &buf));
+  g_assert_cmpuint (buf.length, ==, length);
+  g_assert (0 == memcmp (buf.data, blob_get_data (expected, NULL), length));
+
+  /* Writer failure is propagated. */
+  buf.length = 0;
+  buf.allocated = length - 1;
+  g_assert (!face_builder_write (subset, _write_to_buffer, &buf));
+
+  /* Only face builders can be written. */
+  g_assert (!face_builder_write (face_abc, _write_to_buffer, &buf));
+  g_assert_cmpuint (face_builder_get_length (face_abc), ==, 0);
+
+  free (buf.data);
+  blob_destroy (expected);
+  subset_input_destroy (input);
+  face_destroy (subset);
+  face_destroy (face_abc);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -238,9 +314,11 @@ main (int argc, char **argv)
   test_add (test_subset_no_inf_loop);
   test_add (test_subset_crash);
   test_add (test_subset_set_flags);
+  test_add (test_subset_set_repack_budget);
   test_add (test_subset_sets);
   test_add (test_subset_plan);
   test_add (test_subset_create_for_tables_face);
+  test_add (test_subset_write);
 
   return test_run();
 }